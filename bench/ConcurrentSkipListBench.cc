@@ -0,0 +1,165 @@
+#include "../src/Containers/ConcurrentSkipList.hpp"
+#include "../src/Scheduling/ThreadPool/ThreadPool.hpp"
+#include "../src/Sync/WaitGroup.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+
+// ConcurrentSkipListMap vs std::map behind a std::shared_mutex, one task per ThreadPool worker
+//   ./build/bench/ConcurrentSkipListBench [operations per worker, default 10^6]
+// Keys uniform in [0, 2^20), half of them present at the start; each row mixes finds / range scans of
+// 16 keys / writes (an insert or an erase, 50/50) in the given proportions
+// The lock-free map should keep scaling with workers where the rwlock serializes every write
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr uint64_t KEYS = 1 << 20;
+constexpr uint64_t SCAN_WIDTH = 16;
+
+struct Mix {
+    const char* name;
+    uint32_t find_percent;
+    uint32_t scan_percent;  // The rest are writes
+};
+
+class LockedMap {
+  public:
+    bool insert(uint64_t key, uint64_t value) {
+        std::unique_lock lock(mutex_);
+        return map_.emplace(key, value).second;
+    }
+
+    bool erase(uint64_t key) {
+        std::unique_lock lock(mutex_);
+        return map_.erase(key) == 1;
+    }
+
+    bool contains(uint64_t key) const {
+        std::shared_lock lock(mutex_);
+        return map_.contains(key);
+    }
+
+    uint64_t scan(uint64_t lo, uint64_t hi) const {
+        std::shared_lock lock(mutex_);
+        uint64_t sum = 0;
+        for (auto it = map_.lower_bound(lo); it != map_.end() && it->first < hi; ++it) {
+            sum += it->second;
+        }
+        return sum;
+    }
+
+  private:
+    mutable std::shared_mutex mutex_;
+    std::map<uint64_t, uint64_t> map_;
+};
+
+class SkipListMap {
+  public:
+    bool insert(uint64_t key, uint64_t value) {
+        return map_.insert(key, value);
+    }
+
+    bool erase(uint64_t key) {
+        return map_.erase(key);
+    }
+
+    bool contains(uint64_t key) const {
+        return map_.contains(key);
+    }
+
+    uint64_t scan(uint64_t lo, uint64_t hi) const {
+        uint64_t sum = 0;
+        for (const auto& [key, value] : map_.range(lo, hi)) {
+            sum += value;
+        }
+        return sum;
+    }
+
+  private:
+    renn::containers::ConcurrentSkipListMap<uint64_t, uint64_t> map_;
+};
+
+// Million operations per second over all workers
+template <typename Map>
+double run(renn::ThreadPool& pool, size_t workers, size_t operations, const Mix& mix) {
+    Map map;
+    std::mt19937_64 fill(1);
+    for (uint64_t i = 0; i < KEYS / 2; ++i) {
+        map.insert(fill() % KEYS, i);
+    }
+
+    renn::sync::WaitGroup wg;
+    wg.add(workers);
+    uint64_t sink = 0;
+    std::mutex sink_mutex;
+
+    const auto start = Clock::now();
+    for (size_t w = 0; w < workers; ++w) {
+        pool.submit([&, w] {
+            std::mt19937_64 rng(w + 2);
+            uint64_t local = 0;
+            for (size_t i = 0; i < operations; ++i) {
+                const uint64_t key = rng() % KEYS;
+                const uint32_t dice = static_cast<uint32_t>(rng() % 100);
+                if (dice < mix.find_percent) {
+                    local += map.contains(key);
+                } else if (dice < mix.find_percent + mix.scan_percent) {
+                    local += map.scan(key, key + SCAN_WIDTH);
+                } else if (dice % 2 == 0) {
+                    local += map.insert(key, i);
+                } else {
+                    local += map.erase(key);
+                }
+            }
+            {
+                std::lock_guard lock(sink_mutex);
+                sink += local;
+            }
+            wg.done();
+        });
+    }
+    wg.wait();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (sink == 42) {
+        std::printf(" ");  // Keeps the results alive
+    }
+    return static_cast<double>(workers * operations) / seconds / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t operations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t{1'000'000};
+    const size_t max_workers = std::max(1u, std::thread::hardware_concurrency());
+
+    renn::ThreadPool pool(max_workers);
+    pool.start();
+
+    const Mix mixes[] = {
+        {"read-mostly (90% find, 5% scan)", 90, 5},
+        {"balanced (50% find, 10% scan)", 50, 10},
+        {"write-heavy (10% find, 0% scan)", 10, 0},
+    };
+
+    for (const Mix& mix : mixes) {
+        std::printf("%s\n", mix.name);
+        for (size_t workers = 1; workers <= max_workers; workers *= 2) {
+            const double locked = run<LockedMap>(pool, workers, operations, mix);
+            const double skip_list = run<SkipListMap>(pool, workers, operations, mix);
+            std::printf("  %3zu workers  std::map + rwlock %8.2f Mops/s  skip list %8.2f Mops/s  x%.2f\n", workers,
+                        locked, skip_list, skip_list / locked);
+        }
+    }
+
+    pool.stop();
+}
@@ -0,0 +1,105 @@
+#include "../src/Containers/HashTable/HashTable.hpp"
+#include "../src/Containers/HashTable/RobinHoodHashTable.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// Chained HashTable vs RobinHoodHashTable (vs std::unordered_map as a reference point)
+// Lookup workloads go from hit-only to miss-heavy: misses are where Robin Hood's early termination pays off
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Workload {
+    std::vector<uint64_t> keys;     // inserted
+    std::vector<uint64_t> queries;  // hit_ratio of them are inserted keys
+};
+
+Workload make_workload(size_t size, size_t queries, double hit_ratio, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    Workload workload;
+    workload.keys.reserve(size);
+    workload.queries.reserve(queries);
+
+    for (size_t i = 0; i < size; ++i) {
+        workload.keys.push_back(rng());
+    }
+
+    std::bernoulli_distribution hit(hit_ratio);
+    std::uniform_int_distribution<size_t> pick(0, size - 1);
+
+    for (size_t i = 0; i < queries; ++i) {
+        // Random 64-bit values practically never collide with the inserted ones
+        workload.queries.push_back(hit(rng) ? workload.keys[pick(rng)] : rng());
+    }
+    return workload;
+}
+
+template <typename Fn>
+double ns_per_op(size_t ops, Fn&& fn) {
+    auto start = Clock::now();
+    fn();
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return elapsed / static_cast<double>(ops);
+}
+
+template <typename Table>
+void run(const char* name, const Workload& workload, Table& table) {
+    const double insert_ns = ns_per_op(workload.keys.size(), [&] {
+        for (uint64_t key : workload.keys) {
+            table.emplace(key, key);
+        }
+    });
+
+    size_t found = 0;
+    const double find_ns = ns_per_op(workload.queries.size(), [&] {
+        for (uint64_t key : workload.queries) {
+            found += table.find(key) != table.end();
+        }
+    });
+
+    std::printf("  %-22s insert %8.1f ns/op   find %8.1f ns/op   (found %zu, load %.2f)\n",
+                name, insert_ns, find_ns, found, static_cast<double>(table.load_factor()));
+}
+
+}  // namespace
+
+int main() {
+    constexpr size_t QUERIES = 1 << 22;
+    const size_t sizes[] = {1 << 16, 1 << 20};
+    const double hit_ratios[] = {1.0, 0.5, 0.1, 0.0};
+
+    for (size_t size : sizes) {
+        for (double hit_ratio : hit_ratios) {
+            auto workload = make_workload(size, QUERIES, hit_ratio, 42);
+            std::printf("size %zu, hit ratio %.0f%%\n", size, hit_ratio * 100);
+
+            {
+                renn::containers::HashTable<uint64_t, uint64_t> table;
+                run("HashTable (chained)", workload, table);
+            }
+            {
+                renn::containers::HashTable<uint64_t, uint64_t> table;
+                table.enable_bloom_filter(size);
+                run("HashTable + bloom", workload, table);
+            }
+            {
+                renn::containers::RobinHoodHashTable<uint64_t, uint64_t> table(0, 0.9f);
+                run("RobinHood (0.90)", workload, table);
+            }
+            {
+                renn::containers::RobinHoodHashTable<uint64_t, uint64_t> table(0, 0.95f);
+                run("RobinHood (0.95)", workload, table);
+            }
+            {
+                std::unordered_map<uint64_t, uint64_t> table;
+                run("std::unordered_map", workload, table);
+            }
+        }
+    }
+    return 0;
+}
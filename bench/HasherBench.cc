@@ -0,0 +1,77 @@
+#include "../src/Containers/HashTable/Hashers/CityHash.hpp"
+#include "../src/Containers/HashTable/Hashers/MurmurHash.hpp"
+#include "../src/Containers/HashTable/Hashers/WyHash.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+// Raw hasher throughput: 64-bit integers and strings of growing length
+// Short keys are what hash tables see => latency per key matters more than GB/s
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+template <typename Fn>
+double ns_per_op(size_t ops, Fn&& fn) {
+    auto start = Clock::now();
+    fn();
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return elapsed / static_cast<double>(ops);
+}
+
+template <typename Hash, typename Key>
+void run(const char* name, const std::vector<Key>& keys, size_t rounds) {
+    Hash hash;
+    size_t sink = 0;
+
+    const double ns = ns_per_op(keys.size() * rounds, [&] {
+        for (size_t r = 0; r < rounds; ++r) {
+            for (const Key& key : keys) {
+                sink += hash(key);
+            }
+        }
+    });
+
+    std::printf("  %-12s %8.2f ns/key   (%zx)\n", name, ns, sink & 0xF);
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937_64 rng(42);
+
+    std::vector<uint64_t> integers(1 << 16);
+    for (auto& key : integers) {
+        key = rng();
+    }
+
+    std::printf("uint64_t\n");
+    run<std::hash<uint64_t>>("std::hash", integers, 256);
+    run<CityHash<uint64_t>>("CityHash", integers, 256);
+    run<MurmurHash3<uint64_t>>("MurmurHash3", integers, 256);
+    run<WyHash<uint64_t>>("WyHash", integers, 256);
+
+    for (size_t length : {4, 8, 16, 32, 64, 256, 1024}) {
+        std::vector<std::string> strings(1 << 12);
+        for (auto& key : strings) {
+            key.resize(length);
+            for (char& c : key) {
+                c = static_cast<char>('a' + rng() % 26);
+            }
+        }
+
+        const size_t rounds = std::max<size_t>(1, 4096 / length);
+        std::printf("std::string, %zu bytes\n", length);
+        run<std::hash<std::string>>("std::hash", strings, rounds);
+        run<CityHash<std::string>>("CityHash", strings, rounds);
+        run<MurmurHash3<std::string>>("MurmurHash3", strings, rounds);
+        run<WyHash<std::string>>("WyHash", strings, rounds);
+    }
+    return 0;
+}
@@ -0,0 +1,240 @@
+#include "../src/Containers/HashTable/HashTable.hpp"
+#include "../src/Containers/HashTable/Hashers/CityHash.hpp"
+#include "../src/Containers/HashTable/Hashers/MurmurHash.hpp"
+#include "../src/Containers/HashTable/Hashers/WyHash.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// smhasher's own test suites
+#include "AvalancheTest.h"
+#include "KeysetTest.h"
+#include "SpeedTest.h"
+
+// Quality + throughput of every renn hasher, to pick per-key-type defaults from data
+//
+//   ./HasherQuality            => everything (the quality part takes a few minutes)
+//   ./HasherQuality quality    => smhasher sanity / avalanche / keyset tests
+//   ./HasherQuality speed      => smhasher bulk + small key speed
+//   ./HasherQuality table      => HashTable insert / find throughput per hasher and key type
+//
+// smhasher drives hashes through void(const void* key, int len, uint32_t seed, void* out)
+// => the byte kernels are wrapped below, the seed goes where each hasher takes one
+// The "integer" entries reinterpret 8-byte keys as uint64_t and call the functors directly,
+// so the integer fast paths are measured as HashTable sees them (std::hash<uint64_t> is the identity)
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// -----------------------------------------------
+// smhasher adapters
+
+void city_bytes(const void* key, int len, uint32_t seed, void* out) {
+    *static_cast<uint64_t*>(out) = CityHash64WithSeed(static_cast<const char*>(key), len, seed);
+}
+
+void murmur_bytes(const void* key, int len, uint32_t seed, void* out) {
+    uint64_t hash[2];
+    MurmurHash3_x64_128(key, len, seed, hash);
+    *static_cast<uint64_t*>(out) = hash[0];  // MurmurHash3<T> keeps the low half
+}
+
+void wyhash_bytes(const void* key, int len, uint32_t seed, void* out) {
+    *static_cast<uint64_t*>(out) = renn::hashing::wyhash(key, len, seed);
+}
+
+template <typename Hash>
+void integer_adapter(const void* key, int, uint32_t seed, void* out) {
+    uint64_t value;
+    std::memcpy(&value, key, sizeof(value));
+    *static_cast<uint64_t*>(out) = Hash{}(value ^ seed);
+}
+
+struct HasherInfo {
+    const char* name;
+    pfHash hash;
+};
+
+const HasherInfo BYTE_HASHERS[] = {
+    {"CityHash64", city_bytes},
+    {"MurmurHash3_x64_128", murmur_bytes},
+    {"WyHash", wyhash_bytes},
+};
+
+const HasherInfo INTEGER_HASHERS[] = {
+    {"std::hash<uint64_t>", integer_adapter<std::hash<uint64_t>>},
+    {"CityHash<uint64_t>", integer_adapter<CityHash<uint64_t>>},
+    {"MurmurHash3<uint64_t>", integer_adapter<MurmurHash3<uint64_t>>},
+    {"WyHash<uint64_t>", integer_adapter<WyHash<uint64_t>>},
+};
+
+bool byte_quality(const HasherInfo& info) {
+    std::printf("=== %s ===\n", info.name);
+    bool result = true;
+
+    result &= SanityTest(info.hash, 64);
+    AppendedZeroesTest(info.hash, 64);
+
+    result &= AvalancheTest<Blob<32>, uint64_t>(info.hash, 300000);
+    result &= AvalancheTest<Blob<64>, uint64_t>(info.hash, 300000);
+    result &= AvalancheTest<Blob<128>, uint64_t>(info.hash, 300000);
+
+    result &= CyclicKeyTest<uint64_t>(info.hash, sizeof(uint64_t) + 0, 8, 1000000, false);
+    result &= CyclicKeyTest<uint64_t>(info.hash, sizeof(uint64_t) + 1, 8, 1000000, false);
+    result &= TwoBytesTest2<uint64_t>(info.hash, 16, false);
+    result &= SparseKeyTest<32, uint64_t>(info.hash, 6, true, true, true, false);
+    result &= SparseKeyTest<64, uint64_t>(info.hash, 5, true, true, true, false);
+    result &= ZeroKeyTest<uint64_t>(info.hash, false);
+
+    std::printf("%s: %s\n\n", info.name, result ? "pass" : "FAIL");
+    return result;
+}
+
+// Integer keys: only 8-byte inputs make sense
+bool integer_quality(const HasherInfo& info) {
+    std::printf("=== %s ===\n", info.name);
+    bool result = true;
+
+    result &= AvalancheTest<Blob<64>, uint64_t>(info.hash, 300000);
+    result &= SparseKeyTest<64, uint64_t>(info.hash, 5, true, true, true, false);
+
+    std::printf("%s: %s\n\n", info.name, result ? "pass" : "FAIL");
+    return result;
+}
+
+void speed(const HasherInfo& info) {
+    std::printf("=== %s ===\n", info.name);
+    BulkSpeedTest(info.hash, 0);
+
+    for (int key_size : {4, 8, 16, 24, 32}) {
+        double cycles = 0;
+        TinySpeedTest(info.hash, sizeof(uint64_t), key_size, 0, true, cycles);
+    }
+    std::printf("\n");
+}
+
+// -----------------------------------------------
+// HashTable throughput
+
+template <typename Fn>
+double ns_per_op(size_t ops, Fn&& fn) {
+    auto start = Clock::now();
+    fn();
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return elapsed / static_cast<double>(ops);
+}
+
+template <typename Key, typename Hash>
+void table_run(const char* name, const std::vector<Key>& keys, const std::vector<Key>& queries) {
+    renn::containers::HashTable<Key, uint32_t, Hash> table;
+
+    const double insert_ns = ns_per_op(keys.size(), [&] {
+        for (uint32_t i = 0; i < keys.size(); ++i) {
+            table.emplace(keys[i], i);
+        }
+    });
+
+    size_t found = 0;
+    const double find_ns = ns_per_op(queries.size(), [&] {
+        for (const Key& key : queries) {
+            found += table.find(key) != table.end();
+        }
+    });
+
+    const auto stats = table.stats();
+    std::printf("  %-24s insert %7.1f ns/op   find %7.1f ns/op   max chain %zu, empty %.2f   (found %zu)\n",
+                name, insert_ns, find_ns, stats.max_chain_length,
+                static_cast<double>(stats.empty_bucket_fraction), found);
+}
+
+// Half hits, half misses
+template <typename Key, typename Gen>
+void make_keys(size_t size, Gen&& gen, std::vector<Key>& keys, std::vector<Key>& queries) {
+    keys.clear();
+    queries.clear();
+    for (size_t i = 0; i < size; ++i) {
+        keys.push_back(gen(i));
+    }
+    for (size_t i = 0; i < size; ++i) {
+        queries.push_back(i % 2 == 0 ? keys[i] : gen(size + i));
+    }
+}
+
+template <typename Key>
+void table_suite(const char* title, const std::vector<Key>& keys, const std::vector<Key>& queries) {
+    std::printf("%s, %zu keys\n", title, keys.size());
+    table_run<Key, std::hash<Key>>("std::hash", keys, queries);
+    table_run<Key, CityHash<Key>>("CityHash", keys, queries);
+    table_run<Key, MurmurHash3<Key>>("MurmurHash3", keys, queries);
+    table_run<Key, WyHash<Key>>("WyHash", keys, queries);
+}
+
+void tables() {
+    constexpr size_t SIZE = 1 << 20;
+    std::mt19937_64 rng(42);
+
+    std::vector<uint64_t> ints;
+    std::vector<uint64_t> int_queries;
+
+    make_keys(SIZE, [&](size_t) { return rng(); }, ints, int_queries);
+    table_suite("uint64_t random", ints, int_queries);
+
+    // Structured keys: what weak hashes get wrong
+    make_keys(SIZE, [](size_t i) { return static_cast<uint64_t>(i); }, ints, int_queries);
+    table_suite("uint64_t sequential", ints, int_queries);
+
+    make_keys(SIZE, [](size_t i) { return static_cast<uint64_t>(i) << 32; }, ints, int_queries);
+    table_suite("uint64_t high bits only", ints, int_queries);
+
+    std::vector<std::string> strings;
+    std::vector<std::string> string_queries;
+
+    for (size_t length : {8, 24, 64}) {
+        make_keys(SIZE, [length](size_t i) {
+            std::string key = "key:" + std::to_string(i);
+            key.resize(std::max(length, key.size()), '_');
+            return key;
+        }, strings, string_queries);
+
+        char title[64];
+        std::snprintf(title, sizeof(title), "std::string, >= %zu bytes", length);
+        table_suite(title, strings, string_queries);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::string_view mode = argc > 1 ? argv[1] : "all";
+    bool result = true;
+
+    if (mode == "all" || mode == "quality") {
+        for (const auto& info : BYTE_HASHERS) {
+            result &= byte_quality(info);
+        }
+        for (const auto& info : INTEGER_HASHERS) {
+            // Reported, not enforced: the identity std::hash fails avalanche by design
+            integer_quality(info);
+        }
+    }
+
+    if (mode == "all" || mode == "speed") {
+        for (const auto& info : BYTE_HASHERS) {
+            speed(info);
+        }
+    }
+
+    if (mode == "all" || mode == "table") {
+        tables();
+    }
+
+    return result ? 0 : 1;
+}
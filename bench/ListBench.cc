@@ -0,0 +1,97 @@
+#include "../src/Containers/DynamicArray.hpp"
+#include "../src/Containers/List.hpp"
+#include "../src/Containers/UnrolledList.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+
+// List (a node per element) vs UnrolledList (K elements per node) on queue-like workloads
+//   ./build/bench/ListBench [elements, default 10^7 uint64_t]
+// queue: push_back everything, then pop_front everything; traverse: sum over a full list
+// Peak memory is estimated from the node layouts (one malloc chunk header of 16 bytes per node)
+// sort: List::sort (relinks nodes) vs copying the values out to a DynamicArray, std::sort, copying back
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+template <typename Function>
+double time_ms(Function&& f) {
+    auto start = Clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template <typename ListType>
+void run(const char* name, size_t elements, size_t bytes_per_element) {
+    uint64_t checksum = 0;
+    ListType list;
+
+    const double fill = time_ms([&] {
+        for (size_t i = 0; i < elements; ++i) {
+            list.push_back(i);
+        }
+    });
+    const double traverse = time_ms([&] { checksum += std::accumulate(list.begin(), list.end(), uint64_t{0}); });
+    const double drain = time_ms([&] {
+        while (!list.empty()) {
+            checksum += list.front();
+            list.pop_front();
+        }
+    });
+
+    std::printf("%-14s push_back %8.2f ms  traverse %8.2f ms  pop_front %8.2f ms  ~%5.1f B/element  (%llu)\n", name,
+                fill, traverse, drain, static_cast<double>(bytes_per_element) / 100.0,
+                static_cast<unsigned long long>(checksum));
+}
+
+void run_sort(size_t elements) {
+    using renn::containers::DynamicArray;
+    using renn::containers::List;
+
+    std::mt19937_64 rng(1);
+    List<uint64_t> a;
+    for (size_t i = 0; i < elements; ++i) {
+        a.push_back(rng());
+    }
+    List<uint64_t> b(a);
+
+    const double relink = time_ms([&] { a.sort(); });
+    const double copy = time_ms([&] {
+        DynamicArray<uint64_t> values;
+        values.reserve(b.size());
+        for (uint64_t value : b) {
+            values.push_back(value);
+        }
+        std::sort(values.begin(), values.end());
+        auto out = b.begin();
+        for (uint64_t value : values) {
+            *out++ = value;
+        }
+    });
+
+    std::printf("%-14s List::sort %8.2f ms  copy + std::sort + copy back %8.2f ms  %s\n", "sort", relink, copy,
+                std::equal(a.begin(), a.end(), b.begin()) ? "" : "MISMATCH");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t{10'000'000};
+
+    using renn::containers::List;
+    using renn::containers::UnrolledList;
+
+    // Bytes per element x100: List node = 2 pointers + value + malloc header
+    run<List<uint64_t>>("List", elements, (2 * sizeof(void*) + sizeof(uint64_t) + 16) * 100);
+
+    using Unrolled = UnrolledList<uint64_t>;
+    constexpr size_t k = Unrolled::node_capacity();
+    run<Unrolled>("UnrolledList", elements, (2 * sizeof(void*) + 8 + k * sizeof(uint64_t) + 16) * 100 / k);
+
+    run_sort(elements);
+}
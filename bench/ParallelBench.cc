@@ -0,0 +1,92 @@
+#include "../src/Algorithms/Parallel.hpp"
+#include "../src/Algorithms/RadixSort.hpp"
+#include "../src/Containers/DynamicArray.hpp"
+#include "../src/Scheduling/ThreadPool/ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <thread>
+
+// renn::par algorithms on a ThreadPool with one worker per hardware thread vs their std:: counterparts
+//   ./build/bench/ParallelBench [elements, default 10^8 uint64_t => 800MB per array]
+// radix_sort rows compare against std::sort (sequential) and renn::par::sort (parallel)
+// sort should scale with the cores until the scatter passes hit memory bandwidth
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+template <typename Function>
+double time_ms(Function&& f) {
+    auto start = Clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void report(const char* name, size_t elements, double sequential_ms, double parallel_ms) {
+    std::printf("%-16s %11zu elements  std %9.2f ms  par %9.2f ms  x%.2f\n", name, elements, sequential_ms, parallel_ms,
+                sequential_ms / parallel_ms);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t{100'000'000};
+
+    using renn::containers::DynamicArray;
+
+    renn::ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    pool.start();
+
+    DynamicArray<uint64_t> input(elements, 0);
+    std::mt19937_64 rng(1);
+    for (auto& x : input) {
+        x = rng();
+    }
+
+    {
+        DynamicArray<uint64_t> a(input);
+        DynamicArray<uint64_t> b(input);
+        const double sequential = time_ms([&] { std::sort(a.begin(), a.end()); });
+        const double parallel = time_ms([&] { renn::par::sort(pool, b); });
+        report("sort", elements, sequential, parallel);
+        if (!std::equal(a.begin(), a.end(), b.begin())) {
+            std::printf("sort mismatch\n");
+            return 1;
+        }
+    }
+
+    {
+        DynamicArray<uint64_t> a(input);
+        DynamicArray<uint64_t> b(input);
+        DynamicArray<uint64_t> c(input);
+        DynamicArray<uint64_t> d(input);
+        report("radix_sort", elements, time_ms([&] { std::sort(a.begin(), a.end()); }),
+               time_ms([&] { renn::algorithms::radix_sort(b); }));
+        report("par radix_sort", elements, time_ms([&] { renn::par::sort(pool, c); }),
+               time_ms([&] { renn::par::radix_sort(pool, d); }));
+        if (!std::equal(a.begin(), a.end(), b.begin()) || !std::equal(a.begin(), a.end(), d.begin())) {
+            std::printf("radix_sort mismatch\n");
+            return 1;
+        }
+    }
+
+    DynamicArray<uint64_t> out(elements, 0);
+    report("transform", elements,
+           time_ms([&] { std::transform(input.begin(), input.end(), out.begin(), [](uint64_t x) { return x >> 3; }); }),
+           time_ms([&] { renn::par::transform(pool, input, out.begin(), [](uint64_t x) { return x >> 3; }); }));
+
+    uint64_t sums[2];
+    report("reduce", elements, time_ms([&] { sums[0] = std::reduce(input.begin(), input.end(), uint64_t{0}); }),
+           time_ms([&] { sums[1] = renn::par::reduce(pool, input, uint64_t{0}); }));
+
+    report("inclusive_scan", elements, time_ms([&] { std::inclusive_scan(input.begin(), input.end(), out.begin()); }),
+           time_ms([&] { renn::par::inclusive_scan(pool, input, out.begin()); }));
+
+    pool.stop();
+    return sums[0] == sums[1] ? 0 : 1;
+}
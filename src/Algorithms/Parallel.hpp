@@ -0,0 +1,339 @@
+#pragma once
+
+#include "../Containers/DynamicArray.hpp"
+#include "../Scheduling/IScheduler.hpp"
+#include "../Sync/WaitGroup.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <thread>
+#include <utility>
+
+namespace renn::par {
+
+// Parallel algorithms over random access ranges (DynamicArray, SmallArray, raw arrays, ...) on a scheduler
+//
+// The range is cut into 'parts' contiguous pieces, one task per piece:
+//   parts = min(hardware threads, elements / MIN_PARALLEL_CHUNK) => small ranges run sequentially in the caller
+// Every call blocks until all of its tasks are done => must not be called from a task running on the same
+// scheduler (the tasks could wait behind the caller forever)
+// The first exception thrown by a task is rethrown to the caller once every task has finished
+//
+//   for_each, transform  - independent pieces
+//   reduce               - per-piece partial results, combined in order => 'op' must be associative, need not commute
+//   inclusive_scan       - per-piece totals, exclusive scan of the totals, then every piece scans from its offset
+//                          (reads the input twice; in place, d_first == first, is fine)
+//   sort                 - samplesort, not stable (same guarantees as std::sort); copyable T only, else std::sort
+
+inline constexpr size_t MIN_PARALLEL_CHUNK = 1 << 14;  // Elements per part below which threads don't pay off
+
+namespace detail {
+
+inline size_t parts_for(size_t elements) {
+    const size_t hardware_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    return std::max<size_t>(1, std::min(hardware_threads, elements / MIN_PARALLEL_CHUNK));
+}
+
+// [begin, end) of part p when 'n' elements are split into 'parts'
+inline size_t part_begin(size_t n, size_t parts, size_t p) {
+    return p * n / parts;
+}
+
+// Runs body(0) .. body(tasks - 1) on the scheduler and waits for all of them
+template <typename Body>
+void parallel_for(sched::IScheduler& scheduler, size_t tasks, Body&& body) {
+    if (tasks == 1) {
+        body(size_t{0});
+        return;
+    }
+
+    sync::WaitGroup wg;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    wg.add(tasks);
+    for (size_t t = 0; t < tasks; ++t) {
+        scheduler.submit([&body, &wg, &error_mutex, &error, t] {
+            // A task must reach done() even if 'body' throws (the pool would swallow it => wait() hangs)
+            try {
+                body(t);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            wg.done();
+        });
+    }
+    wg.wait();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}  // namespace detail
+
+template <std::random_access_iterator It, typename Function>
+void for_each(sched::IScheduler& scheduler, It first, It last, Function f) {
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t parts = detail::parts_for(n);
+
+    detail::parallel_for(scheduler, parts, [&](size_t p) {
+        std::for_each(first + detail::part_begin(n, parts, p), first + detail::part_begin(n, parts, p + 1), f);
+    });
+}
+
+// Writes op(*it) to d_first + (it - first), returns the end of the output
+template <std::random_access_iterator It, std::random_access_iterator OutIt, typename UnaryOp>
+OutIt transform(sched::IScheduler& scheduler, It first, It last, OutIt d_first, UnaryOp op) {
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t parts = detail::parts_for(n);
+
+    detail::parallel_for(scheduler, parts, [&](size_t p) {
+        const size_t begin = detail::part_begin(n, parts, p);
+        std::transform(first + begin, first + detail::part_begin(n, parts, p + 1), d_first + begin, op);
+    });
+    return d_first + n;
+}
+
+// init op x0 op x1 op ... with an associative 'op' (grouping differs from std::accumulate, order doesn't)
+template <std::random_access_iterator It, typename T, typename BinaryOp = std::plus<>>
+T reduce(sched::IScheduler& scheduler, It first, It last, T init, BinaryOp op = {}) {
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t parts = detail::parts_for(n);
+
+    // Every part starts from its own first element => no identity element is needed
+    containers::DynamicArray<std::optional<T>> partials(parts);
+    detail::parallel_for(scheduler, parts, [&](size_t p) {
+        It it = first + detail::part_begin(n, parts, p);
+        It end = first + detail::part_begin(n, parts, p + 1);
+        if (it == end) {
+            return;
+        }
+        T partial = *it;
+        for (++it; it != end; ++it) {
+            partial = op(std::move(partial), *it);
+        }
+        partials[p] = std::move(partial);
+    });
+
+    for (auto& partial : partials) {
+        if (partial) {
+            init = op(std::move(init), std::move(*partial));
+        }
+    }
+    return init;
+}
+
+// d_first[i] = x0 op x1 op ... op xi, returns the end of the output
+template <std::random_access_iterator It, std::random_access_iterator OutIt, typename BinaryOp = std::plus<>>
+OutIt inclusive_scan(sched::IScheduler& scheduler, It first, It last, OutIt d_first, BinaryOp op = {}) {
+    using T = std::iter_value_t<It>;
+
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t parts = detail::parts_for(n);
+
+    if (parts == 1) {
+        return std::inclusive_scan(first, last, d_first, op);
+    }
+
+    // 1. Total of every part but the last (its total offsets nothing)
+    containers::DynamicArray<std::optional<T>> totals(parts);
+    detail::parallel_for(scheduler, parts - 1, [&](size_t p) {
+        It it = first + detail::part_begin(n, parts, p);
+        It end = first + detail::part_begin(n, parts, p + 1);
+        T total = *it;  // parts <= n / MIN_PARALLEL_CHUNK => no part is empty
+        for (++it; it != end; ++it) {
+            total = op(std::move(total), *it);
+        }
+        totals[p] = std::move(total);
+    });
+
+    // 2. Exclusive scan of the totals: totals[p] becomes everything before part p + 1
+    for (size_t p = 1; p + 1 < parts; ++p) {
+        totals[p] = op(*totals[p - 1], std::move(*totals[p]));  // totals[p - 1] is still part p's offset
+    }
+
+    // 3. Every part scans from its offset
+    detail::parallel_for(scheduler, parts, [&](size_t p) {
+        const size_t begin = detail::part_begin(n, parts, p);
+        const size_t end = detail::part_begin(n, parts, p + 1);
+        if (p == 0) {
+            std::inclusive_scan(first, first + end, d_first, op);
+        } else {
+            std::inclusive_scan(first + begin, first + end, d_first + begin, op, *totals[p - 1]);
+        }
+    });
+    return d_first + n;
+}
+
+namespace detail {
+
+// Samplesort, not stable:
+//  1. sorted random sample => splitters s0 < s1 < ... (duplicates dropped)
+//  2. every element goes to the bucket of its key range, or to the 'equal' bucket of a splitter
+//     (x == s_i) => a heavily repeated key fills an equal bucket, which needs no sorting, instead of
+//     overloading one range bucket
+//  3. per part: histogram over the buckets; prefix sums give every (part, bucket) its own output slice
+//  4. per part: the elements are moved into their slices of a buffer
+//  5. per bucket: sort the range buckets, move everything back
+// Two moves per element plus independent std::sorts of ~n / (4 * parts) elements => every core stays busy and the
+// passes over the whole array are streaming, bound by memory bandwidth rather than one core
+// Needs 'parts' > 1 and a copyable T (the splitters are copies of sampled elements)
+template <std::random_access_iterator It, typename Compare>
+void samplesort(sched::IScheduler& scheduler, It first, size_t n, size_t parts, Compare& comp) {
+    using T = std::iter_value_t<It>;
+
+    // 1. Splitters
+    constexpr size_t BUCKETS_PER_PART = 4;  // More buckets than tasks => a slow bucket doesn't stall the rest
+    constexpr size_t OVERSAMPLING = 16;     // Sample elements per splitter, evens out the bucket sizes
+
+    const size_t range_buckets = parts * BUCKETS_PER_PART;
+    containers::DynamicArray<T> splitters;
+    {
+        std::mt19937_64 rng(n);
+        std::uniform_int_distribution<size_t> index(0, n - 1);
+        containers::DynamicArray<T> sample;
+        sample.reserve(range_buckets * OVERSAMPLING);
+        for (size_t i = 0; i < range_buckets * OVERSAMPLING; ++i) {
+            sample.push_back(first[index(rng)]);
+        }
+        std::sort(sample.begin(), sample.end(), comp);
+
+        for (size_t i = OVERSAMPLING; i < sample.size(); i += OVERSAMPLING) {
+            if (splitters.empty() || comp(splitters.back(), sample[i])) {
+                splitters.push_back(sample[i]);
+            }
+        }
+    }
+
+    // Bucket 2i: keys between s_(i-1) and s_i, bucket 2i + 1: keys equal to s_i, last bucket: keys above all
+    const size_t buckets = 2 * splitters.size() + 1;
+    auto bucket_of = [&](const T& x) {
+        const size_t i =
+            static_cast<size_t>(std::lower_bound(splitters.begin(), splitters.end(), x, comp) - splitters.begin());
+        return 2 * i + (i < splitters.size() && !comp(x, splitters[i]));
+    };
+
+    // 2, 3. Histograms, one row of 'buckets' counters per part (recomputed in the scatter instead of stored:
+    // log2(buckets) comparisons are cheaper than an index array as big as the input)
+    containers::DynamicArray<size_t> counts(parts * buckets, 0);
+    parallel_for(scheduler, parts, [&](size_t p) {
+        size_t* row = &counts[p * buckets];
+        for (size_t i = part_begin(n, parts, p); i < part_begin(n, parts, p + 1); ++i) {
+            ++row[bucket_of(first[i])];
+        }
+    });
+
+    // Bucket-major exclusive prefix sums => every bucket is one contiguous slice of the buffer
+    containers::DynamicArray<size_t> slices(parts * buckets, 0);  // [part][bucket]
+    containers::DynamicArray<size_t> bucket_begin(buckets + 1, 0);
+    size_t offset = 0;
+    for (size_t b = 0; b < buckets; ++b) {
+        bucket_begin[b] = offset;
+        for (size_t p = 0; p < parts; ++p) {
+            slices[p * buckets + b] = offset;
+            offset += counts[p * buckets + b];
+        }
+    }
+    bucket_begin[buckets] = offset;
+
+    // 4. Scatter into the buffer (raw storage => T need not be default-constructible)
+    // 'cursors' advance only past constructed elements => a throwing move or comparison destroys exactly those
+    std::allocator<T> allocator;
+    T* buffer = allocator.allocate(n);
+    containers::DynamicArray<size_t> cursors(slices);
+
+    try {
+        parallel_for(scheduler, parts, [&](size_t p) {
+            size_t* cursor = &cursors[p * buckets];
+            for (size_t i = part_begin(n, parts, p); i < part_begin(n, parts, p + 1); ++i) {
+                size_t& slot = cursor[bucket_of(first[i])];
+                std::construct_at(buffer + slot, std::move(first[i]));
+                ++slot;
+            }
+        });
+    } catch (...) {
+        for (size_t i = 0; i < parts * buckets; ++i) {
+            std::destroy(buffer + slices[i], buffer + cursors[i]);
+        }
+        allocator.deallocate(buffer, n);
+        throw;
+    }
+
+    // 5. Sort the range buckets inside the buffer, move every bucket back
+    try {
+        parallel_for(scheduler, buckets, [&](size_t b) {
+            T* begin = buffer + bucket_begin[b];
+            T* end = buffer + bucket_begin[b + 1];
+            if (b % 2 == 0) {
+                std::sort(begin, end, comp);
+            }
+            std::move(begin, end, first + bucket_begin[b]);
+        });
+    } catch (...) {
+        std::destroy_n(buffer, n);
+        allocator.deallocate(buffer, n);
+        throw;
+    }
+
+    std::destroy_n(buffer, n);
+    allocator.deallocate(buffer, n);
+}
+
+}  // namespace detail
+
+// Not stable, same guarantees as std::sort. Move-only T => sequential std::sort
+template <std::random_access_iterator It, typename Compare = std::less<>>
+void sort(sched::IScheduler& scheduler, It first, It last, Compare comp = {}) {
+    using T = std::iter_value_t<It>;
+
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t parts = detail::parts_for(n);
+
+    if constexpr (std::copy_constructible<T>) {
+        if (parts > 1) {
+            detail::samplesort(scheduler, first, n, parts, comp);
+            return;
+        }
+    }
+    std::sort(first, last, comp);
+}
+
+// Whole-range overloads, e.g. renn::par::sort(pool, array)
+
+template <std::ranges::random_access_range Range, typename Function>
+void for_each(sched::IScheduler& scheduler, Range&& range, Function f) {
+    for_each(scheduler, std::ranges::begin(range), std::ranges::end(range), std::move(f));
+}
+
+template <std::ranges::random_access_range Range, std::random_access_iterator OutIt, typename UnaryOp>
+OutIt transform(sched::IScheduler& scheduler, Range&& range, OutIt d_first, UnaryOp op) {
+    return transform(scheduler, std::ranges::begin(range), std::ranges::end(range), d_first, std::move(op));
+}
+
+template <std::ranges::random_access_range Range, typename T, typename BinaryOp = std::plus<>>
+T reduce(sched::IScheduler& scheduler, Range&& range, T init, BinaryOp op = {}) {
+    return reduce(scheduler, std::ranges::begin(range), std::ranges::end(range), std::move(init), std::move(op));
+}
+
+template <std::ranges::random_access_range Range, std::random_access_iterator OutIt, typename BinaryOp = std::plus<>>
+OutIt inclusive_scan(sched::IScheduler& scheduler, Range&& range, OutIt d_first, BinaryOp op = {}) {
+    return inclusive_scan(scheduler, std::ranges::begin(range), std::ranges::end(range), d_first, std::move(op));
+}
+
+template <std::ranges::random_access_range Range, typename Compare = std::less<>>
+void sort(sched::IScheduler& scheduler, Range&& range, Compare comp = {}) {
+    sort(scheduler, std::ranges::begin(range), std::ranges::end(range), std::move(comp));
+}
+
+}  // namespace renn::par
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "../Containers/DynamicArray.hpp"
+#include "../Scheduling/IScheduler.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+
+namespace renn::algorithms {
+
+// LSD radix sort, stable, by an integer or floating point key: radix_sort(array) or
+// radix_sort(records, &Record::timestamp) / radix_sort(records, [](const Record& r) { return r.id; })
+//
+// Keys are mapped to unsigned integers with the same order, then sorted digit by digit from the lowest:
+//   signed   - sign bit flipped
+//   floating - negative: all bits flipped (bigger magnitude first), else sign bit set
+//              => -inf < ... < -0.0 < +0.0 < ... < +inf, NaNs end up before -inf / after +inf by their sign
+// Digits are 8 bits for keys of up to 16 bits, 11 bits otherwise (32-bit keys: 3 passes, 64-bit: 6 passes;
+// 2048 counters still fit in L1)
+// One read pass builds the histograms of every digit; a digit with the same value in every key (e.g. the
+// high bytes of small numbers) is skipped => no pass over the data for it
+// Each pass moves every element once between the range and a buffer of n elements
+//
+// The key is extracted again on every pass => it should be cheap (a field), and must not throw
+// T must be nothrow-movable: the buffer is filled out of order, a failed move couldn't be undone
+// renn::par::radix_sort (below) splits the histograms and scatters of every pass over a scheduler
+
+template <typename K>
+concept RadixKey = (std::is_integral_v<K> && !std::is_same_v<K, bool>) || std::is_same_v<K, float> ||
+                   std::is_same_v<K, double>;
+
+namespace detail {
+
+inline constexpr size_t RADIX_MIN_ELEMENTS = 256;  // Below that the prefix sums cost more than a comparison sort
+
+template <RadixKey K>
+auto ordered_bits(K key) noexcept {
+    if constexpr (std::is_same_v<K, float> || std::is_same_v<K, double>) {
+        using Bits = std::conditional_t<std::is_same_v<K, float>, uint32_t, uint64_t>;
+        constexpr Bits SIGN = Bits{1} << (8 * sizeof(Bits) - 1);
+        const Bits bits = std::bit_cast<Bits>(key);
+        return (bits & SIGN) ? static_cast<Bits>(~bits) : static_cast<Bits>(bits | SIGN);
+    } else {
+        using Bits = std::make_unsigned_t<K>;
+        if constexpr (std::is_signed_v<K>) {
+            return static_cast<Bits>(static_cast<Bits>(key) ^ (Bits{1} << (8 * sizeof(Bits) - 1)));
+        } else {
+            return key;
+        }
+    }
+}
+
+template <typename It, typename KeyFn>
+using RadixKeyOf = std::remove_cvref_t<std::invoke_result_t<KeyFn&, std::iter_reference_t<It>>>;
+
+template <RadixKey K>
+struct RadixLayout {
+    using Bits = decltype(ordered_bits(K{}));
+
+    static constexpr unsigned DIGIT_BITS = sizeof(Bits) <= 2 ? 8 : 11;
+    static constexpr size_t BUCKETS = size_t{1} << DIGIT_BITS;
+    static constexpr unsigned PASSES = (8 * sizeof(Bits) + DIGIT_BITS - 1) / DIGIT_BITS;
+
+    static size_t digit(Bits bits, unsigned pass) noexcept {
+        return static_cast<size_t>(bits >> (pass * DIGIT_BITS)) & (BUCKETS - 1);
+    }
+};
+
+// counts[pass * BUCKETS + digit] += occurrences in [begin, end)
+template <typename It, typename KeyFn>
+void count_digits(It first, size_t begin, size_t end, KeyFn& key, size_t* counts) {
+    using Layout = RadixLayout<RadixKeyOf<It, KeyFn>>;
+    for (size_t i = begin; i < end; ++i) {
+        const auto bits = ordered_bits(std::invoke(key, first[i]));
+        for (unsigned pass = 0; pass < Layout::PASSES; ++pass) {
+            ++counts[pass * Layout::BUCKETS + Layout::digit(bits, pass)];
+        }
+    }
+}
+
+// Moves src[begin, end) to dst[offsets[digit]++], in order => stable
+// CONSTRUCT: dst is raw memory (the buffer's first fill)
+template <bool CONSTRUCT, typename Layout, typename SrcIt, typename DstIt, typename KeyFn>
+void scatter(SrcIt src, size_t begin, size_t end, DstIt dst, size_t* offsets, unsigned pass, KeyFn& key) {
+    for (size_t i = begin; i < end; ++i) {
+        auto& item = src[i];
+        size_t& slot = offsets[Layout::digit(ordered_bits(std::invoke(key, item)), pass)];
+        if constexpr (CONSTRUCT) {
+            std::construct_at(std::addressof(dst[slot]), std::move(item));
+        } else {
+            dst[slot] = std::move(item);
+        }
+        ++slot;
+    }
+}
+
+// Sequential when scheduler == nullptr
+template <std::random_access_iterator It, typename KeyFn>
+void radix_sort(sched::IScheduler* scheduler, It first, It last, KeyFn& key) {
+    using T = std::iter_value_t<It>;
+    using Layout = RadixLayout<RadixKeyOf<It, KeyFn>>;
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>,
+                  "radix_sort moves elements into a buffer out of order => their moves must not throw");
+
+    constexpr size_t BUCKETS = Layout::BUCKETS;
+    constexpr unsigned PASSES = Layout::PASSES;
+
+    const size_t n = static_cast<size_t>(last - first);
+    if (n < RADIX_MIN_ELEMENTS) {
+        std::stable_sort(first, last, [&key](const auto& a, const auto& b) {
+            return ordered_bits(std::invoke(key, a)) < ordered_bits(std::invoke(key, b));
+        });
+        return;
+    }
+
+    const size_t parts = scheduler != nullptr ? par::detail::parts_for(n) : 1;
+    auto part_begin = [n, parts](size_t p) { return par::detail::part_begin(n, parts, p); };
+
+    // Histograms of every digit, one table per part: [part][pass][digit]
+    constexpr size_t TABLE = PASSES * BUCKETS;
+    containers::DynamicArray<size_t> counts(parts * TABLE, 0);
+    if (parts == 1) {
+        count_digits(first, 0, n, key, &counts[0]);
+    } else {
+        par::detail::parallel_for(*scheduler, parts, [&](size_t p) {
+            count_digits(first, part_begin(p), part_begin(p + 1), key, &counts[p * TABLE]);
+        });
+    }
+
+    // A digit with a single value in all keys doesn't reorder anything
+    containers::DynamicArray<unsigned> active;
+    for (unsigned pass = 0; pass < PASSES; ++pass) {
+        size_t largest = 0;
+        for (size_t d = 0; d < BUCKETS; ++d) {
+            size_t total = 0;
+            for (size_t p = 0; p < parts; ++p) {
+                total += counts[p * TABLE + pass * BUCKETS + d];
+            }
+            largest = std::max(largest, total);
+        }
+        if (largest != n) {
+            active.push_back(pass);
+        }
+    }
+    if (active.empty()) {
+        return;
+    }
+
+    std::allocator<T> allocator;
+    T* buffer = allocator.allocate(n);
+    containers::DynamicArray<size_t> offsets(parts * BUCKETS, 0);  // [part][digit]
+
+    for (size_t step = 0; step < active.size(); ++step) {
+        const unsigned pass = active[step];
+        const bool to_buffer = step % 2 == 0;
+
+        // Per-part counts of this digit in the current order: the initial tables hold them for the
+        // original order, later passes recount (parts see other elements after a scatter)
+        if (step > 0 && parts > 1) {
+            par::detail::parallel_for(*scheduler, parts, [&](size_t p) {
+                size_t* row = &counts[p * TABLE + pass * BUCKETS];
+                std::fill(row, row + BUCKETS, 0);
+                for (size_t i = part_begin(p); i < part_begin(p + 1); ++i) {
+                    const auto& item = to_buffer ? first[i] : buffer[i];
+                    ++row[Layout::digit(ordered_bits(std::invoke(key, item)), pass)];
+                }
+            });
+        }
+
+        // Digit-major exclusive prefix sums => part p writes its elements of every digit after those of parts < p
+        size_t offset = 0;
+        for (size_t d = 0; d < BUCKETS; ++d) {
+            for (size_t p = 0; p < parts; ++p) {
+                offsets[p * BUCKETS + d] = offset;
+                offset += counts[p * TABLE + pass * BUCKETS + d];
+            }
+        }
+
+        auto scatter_part = [&](size_t p) {
+            size_t* row = &offsets[p * BUCKETS];
+            if (!to_buffer) {
+                scatter<false, Layout>(buffer, part_begin(p), part_begin(p + 1), first, row, pass, key);
+            } else if (step == 0) {
+                scatter<true, Layout>(first, part_begin(p), part_begin(p + 1), buffer, row, pass, key);
+            } else {
+                scatter<false, Layout>(first, part_begin(p), part_begin(p + 1), buffer, row, pass, key);
+            }
+        };
+        if (parts == 1) {
+            scatter_part(0);
+        } else {
+            par::detail::parallel_for(*scheduler, parts, scatter_part);
+        }
+    }
+
+    // Odd number of passes => the result is in the buffer
+    if (active.size() % 2 == 1) {
+        if (parts == 1) {
+            std::move(buffer, buffer + n, first);
+        } else {
+            par::detail::parallel_for(*scheduler, parts, [&](size_t p) {
+                std::move(buffer + part_begin(p), buffer + part_begin(p + 1), first + part_begin(p));
+            });
+        }
+    }
+
+    std::destroy_n(buffer, n);
+    allocator.deallocate(buffer, n);
+}
+
+}  // namespace detail
+
+template <std::random_access_iterator It, typename KeyFn = std::identity>
+    requires RadixKey<detail::RadixKeyOf<It, KeyFn>>
+void radix_sort(It first, It last, KeyFn key = {}) {
+    detail::radix_sort(nullptr, first, last, key);
+}
+
+template <std::ranges::random_access_range Range, typename KeyFn = std::identity>
+    requires RadixKey<detail::RadixKeyOf<std::ranges::iterator_t<Range>, KeyFn>>
+void radix_sort(Range&& range, KeyFn key = {}) {
+    detail::radix_sort(nullptr, std::ranges::begin(range), std::ranges::end(range), key);
+}
+
+}  // namespace renn::algorithms
+
+namespace renn::par {
+
+// Same result as algorithms::radix_sort; every pass's histogram and scatter are split over the scheduler
+// (blocks like the other renn::par algorithms)
+template <std::random_access_iterator It, typename KeyFn = std::identity>
+    requires algorithms::RadixKey<algorithms::detail::RadixKeyOf<It, KeyFn>>
+void radix_sort(sched::IScheduler& scheduler, It first, It last, KeyFn key = {}) {
+    algorithms::detail::radix_sort(&scheduler, first, last, key);
+}
+
+template <std::ranges::random_access_range Range, typename KeyFn = std::identity>
+    requires algorithms::RadixKey<algorithms::detail::RadixKeyOf<std::ranges::iterator_t<Range>, KeyFn>>
+void radix_sort(sched::IScheduler& scheduler, Range&& range, KeyFn key = {}) {
+    algorithms::detail::radix_sort(&scheduler, std::ranges::begin(range), std::ranges::end(range), key);
+}
+
+}  // namespace renn::par
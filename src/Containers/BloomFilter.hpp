@@ -0,0 +1,147 @@
+#pragma once
+
+#include "DynamicArray.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#endif
+
+namespace renn::containers {
+
+// Cache-line-blocked Bloom filter
+//
+// A key maps to one 64-byte block (8 x 64-bit lanes) and sets exactly one bit in every lane
+// => insert and query touch a single cache line, a miss is answered by one load + one vector test
+//
+// The filter works on already computed hashes (insert_hash / may_contain_hash),
+// so a hash table can reuse the hash it computes anyway
+// Hashes are remixed internally, weak hashes (std::hash<int> is the identity) are fine
+//
+// No false negatives; ~10 bits per key give about 1% false positives
+
+class BlockedBloomFilter {
+  private:
+    static constexpr size_t LANES = 8;
+    static constexpr size_t BLOCK_BITS = 512;
+
+    struct alignas(64) Block {
+        uint64_t lanes_[LANES];
+    };
+
+    // Odd multipliers, one per lane (the same ones as in Parquet's split block filter)
+    static constexpr uint32_t SALT[LANES] = {
+        0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+        0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+    };
+
+  public:
+    static constexpr size_t DEFAULT_BITS_PER_KEY = 10;
+
+    BlockedBloomFilter() : BlockedBloomFilter(1) {}
+
+    explicit BlockedBloomFilter(size_t expected_elements, size_t bits_per_key = DEFAULT_BITS_PER_KEY)
+        : blocks_(std::max<size_t>(1, (expected_elements * bits_per_key + BLOCK_BITS - 1) / BLOCK_BITS), Block{}),
+          expected_elements_(expected_elements) {}
+
+    void insert_hash(uint64_t hash) noexcept {
+        hash = mix(hash);
+        Block& block = blocks_[block_index(hash)];
+        const uint32_t low = static_cast<uint32_t>(hash);
+
+#if defined(__AVX2__)
+        __m256i lo_mask, hi_mask;
+        make_masks(low, lo_mask, hi_mask);
+
+        auto* lanes = reinterpret_cast<__m256i*>(block.lanes_);
+        _mm256_store_si256(lanes, _mm256_or_si256(_mm256_load_si256(lanes), lo_mask));
+        _mm256_store_si256(lanes + 1, _mm256_or_si256(_mm256_load_si256(lanes + 1), hi_mask));
+#else
+        for (size_t i = 0; i < LANES; ++i) {
+            block.lanes_[i] |= uint64_t{1} << bit_in_lane(low, i);
+        }
+#endif
+    }
+
+    bool may_contain_hash(uint64_t hash) const noexcept {
+        hash = mix(hash);
+        const Block& block = blocks_[block_index(hash)];
+        const uint32_t low = static_cast<uint32_t>(hash);
+
+#if defined(__AVX2__)
+        __m256i lo_mask, hi_mask;
+        make_masks(low, lo_mask, hi_mask);
+
+        auto* lanes = reinterpret_cast<const __m256i*>(block.lanes_);
+        // testc(a, b) == 1 <=> every bit of b is set in a
+        return _mm256_testc_si256(_mm256_load_si256(lanes), lo_mask) &&
+               _mm256_testc_si256(_mm256_load_si256(lanes + 1), hi_mask);
+#else
+        for (size_t i = 0; i < LANES; ++i) {
+            if ((block.lanes_[i] & (uint64_t{1} << bit_in_lane(low, i))) == 0) {
+                return false;
+            }
+        }
+        return true;
+#endif
+    }
+
+    template <typename Key, typename Hash = std::hash<Key>>
+    void insert(const Key& key, const Hash& hash = Hash()) noexcept {
+        insert_hash(hash(key));
+    }
+
+    template <typename Key, typename Hash = std::hash<Key>>
+    bool may_contain(const Key& key, const Hash& hash = Hash()) const noexcept {
+        return may_contain_hash(hash(key));
+    }
+
+    void clear() noexcept {
+        std::fill(blocks_.begin(), blocks_.end(), Block{});
+    }
+
+    // Number of elements the filter was sized for
+    size_t expected_elements() const noexcept { return expected_elements_; }
+
+    size_t memory_usage() const noexcept { return blocks_.size() * sizeof(Block); }
+
+  private:
+    // Murmur3 finalizer
+    static uint64_t mix(uint64_t hash) noexcept {
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    // High 32 bits pick the block (multiply-shift range reduction, no modulo)
+    size_t block_index(uint64_t hash) const noexcept {
+        return static_cast<size_t>(((hash >> 32) * static_cast<uint64_t>(blocks_.size())) >> 32);
+    }
+
+    // Low 32 bits times the lane salt, top 6 bits => bit position 0..63
+    static uint32_t bit_in_lane(uint32_t low, size_t lane) noexcept {
+        return (low * SALT[lane]) >> 26;
+    }
+
+#if defined(__AVX2__)
+    static void make_masks(uint32_t low, __m256i& lo_mask, __m256i& hi_mask) noexcept {
+        const __m256i salt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(SALT));
+        const __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(low)), salt), 26);
+
+        const __m256i one = _mm256_set1_epi64x(1);
+        lo_mask = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bits)));
+        hi_mask = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bits, 1)));
+    }
+#endif
+
+  private:
+    DynamicArray<Block> blocks_;
+    size_t expected_elements_;
+};
+}  // namespace renn::containers
@@ -0,0 +1,444 @@
+#pragma once
+
+#include "../Sync/Epoch.hpp"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace renn::containers {
+
+// Lock-free ordered map (a skip list), safe for any mix of concurrent insert / erase / find / range scans
+//
+// Towers of forward links, level i skipping ~4^i elements (each node is promoted with probability 1/4)
+// Every operation is a search from the head plus CASes on the links around the key, no locks:
+//   - insert: CAS the new node in at level 0 (the linearization point), then at each upper level
+//   - erase: mark the node's links top-down (the low bit of each next pointer), marking level 0 decides
+//     which eraser wins; searches then snip marked nodes out with a CAS on their predecessor
+//   - find / range only read: they step over marked nodes, never write
+// Unlinked nodes are retired to sync::Epoch and freed once no operation can still be looking at them
+//
+// Entries are immutable once inserted (readers copy them without synchronization): updating a value is
+// erase + insert. range(lo, hi) pins an epoch for as long as it lives, so a long scan delays frees
+// (not writers); it sees every entry present for its whole duration, concurrent changes may or may not show
+// size() is exact when quiescent, approximate under concurrent updates
+
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class ConcurrentSkipListMap {
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+
+  private:
+    static constexpr size_t MAX_HEIGHT = 16;  // 4^16 expected elements before the top level fills up
+
+    using Link = std::atomic<uintptr_t>;  // Node* | MARKED
+
+    static constexpr uintptr_t MARKED = 1;
+
+    struct Node;
+
+    static Node* pointer(uintptr_t link) noexcept {
+        return reinterpret_cast<Node*>(link & ~MARKED);
+    }
+
+    static bool is_marked(uintptr_t link) noexcept {
+        return (link & MARKED) != 0;
+    }
+
+    static uintptr_t link_to(Node* node) noexcept {
+        return reinterpret_cast<uintptr_t>(node);
+    }
+
+    // The head is a tower without an entry
+    struct Tower {
+        Link* const next;
+        const size_t height;
+
+        Tower(Link* links, size_t levels) : next(links), height(levels) {}
+    };
+
+    struct Node : Tower {
+        // Who finishes last between its inserter (linking the upper levels) and its eraser retires it
+        // => an inserter can't link a level after the node was retired
+        static constexpr uint32_t LINKED = 1;
+        static constexpr uint32_t UNLINKED = 2;
+
+        std::atomic<uint32_t> done{0};
+        value_type entry;
+
+        Node(size_t levels, Key&& key, Value&& value)
+            : Tower(reinterpret_cast<Link*>(reinterpret_cast<std::byte*>(this) + sizeof(Node)), levels),
+              entry(std::move(key), std::move(value)) {}
+
+        const Key& key() const noexcept {
+            return entry.first;
+        }
+    };
+
+    static_assert(sizeof(Node) % alignof(Link) == 0, "The tower follows the node");
+
+  public:
+    // Forward iterator of a Range, over entries with key < its upper bound
+    class Iterator {
+      public:
+        using value_type = const typename ConcurrentSkipListMap::value_type;
+        using reference = value_type&;
+        using pointer = value_type*;
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+
+        reference operator*() const {
+            return node_->entry;
+        }
+
+        pointer operator->() const {
+            return &node_->entry;
+        }
+
+        Iterator& operator++() {
+            node_ = map_->next_live(node_, *hi_);
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return node_ == other.node_;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return node_ != other.node_;
+        }
+
+      private:
+        friend class ConcurrentSkipListMap;
+
+        Iterator(Node* node, const std::optional<Key>* hi, const ConcurrentSkipListMap* map)
+            : node_(node), hi_(hi), map_(map) {}
+
+        Node* node_{nullptr};
+        const std::optional<Key>* hi_{nullptr};
+        const ConcurrentSkipListMap* map_{nullptr};
+    };
+
+    // Forward scan over [lo, hi), keeps an epoch pinned while alive
+    class Range {
+      public:
+        Range(const Range&) = delete;
+        Range& operator=(const Range&) = delete;
+
+        Iterator begin() const {
+            return Iterator(first_, &hi_, map_);
+        }
+
+        Iterator end() const {
+            return Iterator();
+        }
+
+      private:
+        friend class ConcurrentSkipListMap;
+
+        Range(const ConcurrentSkipListMap* map, const std::optional<Key>& lo, std::optional<Key> hi)
+            : map_(map), hi_(std::move(hi)) {
+            first_ = map_->skip_to_live(lo.has_value() ? map_->lower_bound(*lo) : map_->first(), hi_);
+        }
+
+        sync::Epoch::Guard guard_;  // First member => pinned before the search in the constructor body
+        const ConcurrentSkipListMap* map_;
+        std::optional<Key> hi_;
+        Node* first_{nullptr};
+    };
+
+    explicit ConcurrentSkipListMap(Compare compare = Compare()) : head_(head_links_, MAX_HEIGHT), compare_(compare) {
+        for (Link& link : head_links_) {
+            link.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ConcurrentSkipListMap(const ConcurrentSkipListMap&) = delete;
+    ConcurrentSkipListMap& operator=(const ConcurrentSkipListMap&) = delete;
+
+    // No operation may be running: every node still linked is live (retired ones belong to sync::Epoch)
+    ~ConcurrentSkipListMap() {
+        Node* node = pointer(head_.next[0].load(std::memory_order_acquire));
+        while (node != nullptr) {
+            Node* next = pointer(node->next[0].load(std::memory_order_relaxed));
+            destroy(node);
+            node = next;
+        }
+    }
+
+    // false (and nothing changes) if the key is present
+    bool insert(Key key, Value value) {
+        sync::Epoch::Guard guard;
+        Tower* preds[MAX_HEIGHT];
+        Node* succs[MAX_HEIGHT];
+
+        Node* node = nullptr;
+        while (true) {
+            if (search(node != nullptr ? node->key() : key, preds, succs)) {  // 'key' moved into the node
+                if (node != nullptr) {
+                    destroy(node);  // Never published
+                }
+                return false;
+            }
+            if (node == nullptr) {
+                node = create(random_height(), std::move(key), std::move(value));
+            }
+            for (size_t level = 0; level < node->height; ++level) {
+                node->next[level].store(link_to(succs[level]), std::memory_order_relaxed);
+            }
+            uintptr_t expected = link_to(succs[0]);
+            if (preds[0]->next[0].compare_exchange_strong(expected, link_to(node))) {
+                break;
+            }
+        }
+        size_.fetch_add(1, std::memory_order_relaxed);
+
+        for (size_t level = 1; level < node->height; ++level) {
+            if (!link_level(node, level, preds, succs)) {
+                break;  // Being erased: don't link it any higher
+            }
+        }
+
+        // An eraser may have missed the levels linked after its cleanup search => snip them
+        if (is_marked(node->next[0].load())) {
+            search(node->key(), preds, succs);
+        }
+        if (node->done.fetch_or(Node::LINKED) & Node::UNLINKED) {
+            retire(node);
+        }
+        return true;
+    }
+
+    // false if the key is absent (or a concurrent erase of it won)
+    bool erase(const Key& key) {
+        sync::Epoch::Guard guard;
+        Tower* preds[MAX_HEIGHT];
+        Node* succs[MAX_HEIGHT];
+
+        if (!search(key, preds, succs)) {
+            return false;
+        }
+        Node* node = succs[0];
+
+        for (size_t level = node->height; level-- > 1;) {
+            uintptr_t link = node->next[level].load();
+            while (!is_marked(link) && !node->next[level].compare_exchange_weak(link, link | MARKED)) {
+            }
+        }
+
+        uintptr_t link = node->next[0].load();
+        while (true) {
+            if (is_marked(link)) {
+                return false;  // Another eraser got there first
+            }
+            if (node->next[0].compare_exchange_weak(link, link | MARKED)) {
+                break;
+            }
+        }
+        size_.fetch_sub(1, std::memory_order_relaxed);
+
+        search(key, preds, succs);  // Snips it at every level
+        if (node->done.fetch_or(Node::UNLINKED) & Node::LINKED) {
+            retire(node);
+        }
+        return true;
+    }
+
+    bool contains(const Key& key) const {
+        sync::Epoch::Guard guard;
+        return find_node(key) != nullptr;
+    }
+
+    // A copy: the node may be freed once the epoch is unpinned
+    std::optional<Value> find(const Key& key) const {
+        sync::Epoch::Guard guard;
+        Node* node = find_node(key);
+        if (node == nullptr) {
+            return std::nullopt;
+        }
+        return node->entry.second;
+    }
+
+    // [lo, hi) in key order
+    Range range(const Key& lo, const Key& hi) const {
+        return Range(this, lo, hi);
+    }
+
+    // Every entry in key order
+    Range range() const {
+        return Range(this, std::nullopt, std::nullopt);
+    }
+
+    size_t size() const noexcept {
+        const ptrdiff_t size = size_.load(std::memory_order_relaxed);
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+
+    bool empty() const {
+        sync::Epoch::Guard guard;
+        return skip_to_live(first(), std::nullopt) == nullptr;
+    }
+
+  private:
+    bool less(const Key& a, const Key& b) const {
+        return compare_(a, b);
+    }
+
+    static Node* create(size_t height, Key&& key, Value&& value) {
+        void* memory = ::operator new(sizeof(Node) + height * sizeof(Link), std::align_val_t(alignof(Node)));
+        try {
+            Node* node = ::new (memory) Node(height, std::move(key), std::move(value));
+            for (size_t level = 0; level < height; ++level) {
+                ::new (&node->next[level]) Link(0);
+            }
+            return node;
+        } catch (...) {
+            ::operator delete(memory, std::align_val_t(alignof(Node)));
+            throw;
+        }
+    }
+
+    static void destroy(Node* node) noexcept {
+        node->~Node();  // The links are trivially destructible
+        ::operator delete(static_cast<void*>(node), std::align_val_t(alignof(Node)));
+    }
+
+    static void retire(Node* node) {
+        sync::Epoch::retire(node, [](void* p) {
+            destroy(static_cast<Node*>(p));
+        });
+    }
+
+    // Geometric with p = 1/4: two random bits per level
+    static size_t random_height() noexcept {
+        static thread_local uint64_t state = reinterpret_cast<uintptr_t>(&state) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        const size_t height = static_cast<size_t>(std::countr_zero(state | (uint64_t{1} << 62))) / 2 + 1;
+        return height < MAX_HEIGHT ? height : MAX_HEIGHT;
+    }
+
+    // preds[i] / succs[i]: the last node with key < 'key' and its successor at level i, marked nodes snipped
+    // Returns whether succs[0] holds 'key'
+    bool search(const Key& key, Tower** preds, Node** succs) {
+        while (!try_search(key, preds, succs)) {
+        }
+        return succs[0] != nullptr && !less(key, succs[0]->key());
+    }
+
+    // false if a snip lost a race (the predecessor changed or got marked itself) => start over from the head
+    bool try_search(const Key& key, Tower** preds, Node** succs) {
+        Tower* pred = &head_;
+        for (size_t level = MAX_HEIGHT; level-- > 0;) {
+            Node* curr = pointer(pred->next[level].load());
+            while (curr != nullptr) {
+                uintptr_t succ = curr->next[level].load();
+                if (is_marked(succ)) {
+                    uintptr_t expected = link_to(curr);
+                    if (!pred->next[level].compare_exchange_strong(expected, succ & ~MARKED)) {
+                        return false;
+                    }
+                    curr = pointer(succ);
+                } else if (less(curr->key(), key)) {
+                    pred = curr;
+                    curr = pointer(succ);
+                } else {
+                    break;
+                }
+            }
+            preds[level] = pred;
+            succs[level] = curr;
+        }
+        return true;
+    }
+
+    // Links an already published node at 'level'; false if it is being erased
+    bool link_level(Node* node, size_t level, Tower** preds, Node** succs) {
+        while (true) {
+            uintptr_t link = node->next[level].load();
+            if (is_marked(link)) {
+                return false;
+            }
+            if (pointer(link) != succs[level] && !node->next[level].compare_exchange_strong(link, link_to(succs[level]))) {
+                continue;  // Marked meanwhile (or retried with a fresh successor)
+            }
+            uintptr_t expected = link_to(succs[level]);
+            if (preds[level]->next[level].compare_exchange_strong(expected, link_to(node))) {
+                return true;
+            }
+            if (!search(node->key(), preds, succs) || succs[0] != node) {
+                return false;  // Erased (and snipped at level 0) meanwhile
+            }
+        }
+    }
+
+    // Read-only search: steps over marked nodes without snipping them
+    Node* find_node(const Key& key) const {
+        Node* node = lower_bound(key);
+        return node != nullptr && !less(key, node->key()) ? node : nullptr;
+    }
+
+    // First unmarked node with key >= 'key' (the caller holds a guard)
+    Node* lower_bound(const Key& key) const {
+        const Tower* pred = &head_;
+        Node* curr = nullptr;
+        for (size_t level = MAX_HEIGHT; level-- > 0;) {
+            curr = pointer(pred->next[level].load(std::memory_order_acquire));
+            while (curr != nullptr) {
+                const uintptr_t succ = curr->next[level].load(std::memory_order_acquire);
+                if (is_marked(succ)) {
+                    curr = pointer(succ);
+                } else if (less(curr->key(), key)) {
+                    pred = curr;
+                    curr = pointer(succ);
+                } else {
+                    break;
+                }
+            }
+        }
+        return curr;
+    }
+
+    Node* first() const {
+        return pointer(head_.next[0].load(std::memory_order_acquire));
+    }
+
+    // 'node' or the first unmarked node after it, nullptr at the end or at a key >= hi
+    Node* skip_to_live(Node* node, const std::optional<Key>& hi) const {
+        while (node != nullptr) {
+            const uintptr_t next = node->next[0].load(std::memory_order_acquire);
+            if (!is_marked(next)) {
+                return hi.has_value() && !less(node->key(), *hi) ? nullptr : node;
+            }
+            node = pointer(next);
+        }
+        return nullptr;
+    }
+
+    Node* next_live(Node* node, const std::optional<Key>& hi) const {
+        return skip_to_live(pointer(node->next[0].load(std::memory_order_acquire)), hi);
+    }
+
+  private:
+    Link head_links_[MAX_HEIGHT];
+    Tower head_;
+    [[no_unique_address]] Compare compare_;
+    std::atomic<ptrdiff_t> size_{0};
+};
+}  // namespace renn::containers
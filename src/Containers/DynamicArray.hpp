@@ -1,23 +1,53 @@
 #pragma once
 
+#include "Simd.hpp"
 #include <algorithm>
+#include <concepts>
 #include <cstddef>
+#include <cstring>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <ranges>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 namespace renn::containers {
 
+// T may be moved to another address with memcpy (the source then counts as destroyed, no destructor runs)
+// True for trivially copyable types; specialize it for others that hold no pointers into themselves
+// (e.g. a struct of unique_ptrs). Not for std::string (SSO points into the object) or std::list
+template <typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// Allocator that can grow/shrink a block itself, moving the bytes if it has to (see MallocAllocator)
+template <typename Allocator, typename T>
+concept ReallocatingAllocator = requires(Allocator& allocator, T* p, size_t n) {
+    { allocator.reallocate(p, n, n) } -> std::same_as<T*>;
+};
+
+// Growth: when full, capacity becomes max(needed, capacity * growth_factor)
+// A factor below 2 (e.g. 1.5) lets the allocator reuse the blocks freed by earlier growth steps:
+// with 2x every new block is bigger than all the previous ones together
+//
+// Relocation on growth: element by element (move + destroy) in general, one memcpy for trivially
+// relocatable T, or no copy at all when the allocator can reallocate the block in place / by remapping
+
 template <typename T, typename Allocator = std::allocator<T>>
 class DynamicArray {
   private:
+    static constexpr bool RELOCATABLE = is_trivially_relocatable_v<T>;
+
     T* data_;
     size_t size_;
     size_t capacity_;
     Allocator allocator_;
+    double growth_factor_{2.0};
 
   public:
     using allocator_type = Allocator;
@@ -33,6 +63,8 @@ class DynamicArray {
 
     DynamicArray() : data_(nullptr), size_(0), capacity_(0) {}
 
+    explicit DynamicArray(const Allocator& alloc) : data_(nullptr), size_(0), capacity_(0), allocator_(alloc) {}
+
     template <typename U>
     DynamicArray(const DynamicArray<U>& other) : data_(nullptr), size_(0), capacity_(0) {
         reserve(other.size());
@@ -61,12 +93,13 @@ class DynamicArray {
         data_ = allocator_.allocate(other.capacity_);
         size_ = other.size_;
         capacity_ = other.capacity_;
+        growth_factor_ = other.growth_factor_;
         for (size_t i = 0; i < size_; ++i) {
             std::allocator_traits<Allocator>::construct(allocator_, data_ + i, other.data_[i]);
         }
     }
 
-    DynamicArray(DynamicArray&& other) noexcept : data_(std::move(other.data_)), size_(other.size_), capacity_(other.capacity_), allocator_(std::move(other.allocator_)) {
+    DynamicArray(DynamicArray&& other) noexcept : data_(std::move(other.data_)), size_(other.size_), capacity_(other.capacity_), allocator_(std::move(other.allocator_)), growth_factor_(other.growth_factor_) {
         other.data_ = nullptr;
         other.size_ = 0;
         other.capacity_ = 0;
@@ -96,6 +129,7 @@ class DynamicArray {
                 capacity_ = other.capacity_;
             }
             size_ = other.size_;
+            growth_factor_ = other.growth_factor_;
             for (size_t i = 0; i < size_; ++i) {
                 std::allocator_traits<Allocator>::construct(allocator_, data_ + i, other.data_[i]);
             }
@@ -112,6 +146,7 @@ class DynamicArray {
             size_ = other.size_;
             capacity_ = other.capacity_;
             allocator_ = std::move(other.allocator_);
+            growth_factor_ = other.growth_factor_;
 
             other.data_ = nullptr;
             other.size_ = 0;
@@ -188,6 +223,15 @@ class DynamicArray {
         return data_[size_ - 1];
     }
 
+    // Null until the first allocation. With reserve + unsafe_set_size: a buffer to read into
+    T* data() noexcept {
+        return data_;
+    }
+
+    const T* data() const noexcept {
+        return data_;
+    }
+
     iterator begin() noexcept {
         return data_;
     }
@@ -222,7 +266,7 @@ class DynamicArray {
 
     void push_back(const T& value) {
         if (size_ == capacity_) {
-            reserve(capacity_ == 0 ? 1 : capacity_ * 2);
+            grow(size_ + 1);
         }
         std::allocator_traits<Allocator>::construct(allocator_, data_ + size_, value);
         ++size_;
@@ -230,7 +274,7 @@ class DynamicArray {
 
     void push_back(T&& value) {
         if (size_ == capacity_) {
-            reserve(capacity_ == 0 ? 1 : capacity_ * 2);
+            grow(size_ + 1);
         }
         std::allocator_traits<Allocator>::construct(allocator_, data_ + size_, std::move(value));
         ++size_;
@@ -239,7 +283,7 @@ class DynamicArray {
     template <typename... Args>
     void emplace_back(Args&&... args) {
         if (size_ == capacity_) {
-            reserve(capacity_ == 0 ? 1 : capacity_ * 2);
+            grow(size_ + 1);
         }
         std::allocator_traits<Allocator>::construct(allocator_, data_ + size_, std::forward<Args>(args)...);
         ++size_;
@@ -252,15 +296,23 @@ class DynamicArray {
         }
 
         if (size_ == capacity_) {
-            reserve(capacity_ == 0 ? 1 : capacity_ * 2);
-        }
+            grow(size_ + 1);
+        }
+
+        if constexpr (RELOCATABLE) {
+            // The value may be an element of the array => built aside before the tail moves, then relocated in
+            alignas(T) unsigned char item[sizeof(T)];
+            std::allocator_traits<Allocator>::construct(allocator_, reinterpret_cast<T*>(item), std::forward<U>(value));
+            std::memmove(static_cast<void*>(data_ + index + 1), data_ + index, (size_ - index) * sizeof(T));
+            std::memcpy(static_cast<void*>(data_ + index), item, sizeof(T));
+        } else {
+            for (size_t i = size_; i > index; --i) {
+                std::allocator_traits<Allocator>::construct(allocator_, data_ + i, std::move(data_[i - 1]));
+                std::allocator_traits<Allocator>::destroy(allocator_, data_ + i - 1);
+            }
 
-        for (size_t i = size_; i > index; --i) {
-            std::allocator_traits<Allocator>::construct(allocator_, data_ + i, std::move(data_[i - 1]));
-            std::allocator_traits<Allocator>::destroy(allocator_, data_ + i - 1);
+            std::allocator_traits<Allocator>::construct(allocator_, data_ + index, std::forward<U>(value));
         }
-
-        std::allocator_traits<Allocator>::construct(allocator_, data_ + index, std::forward<U>(value));
         ++size_;
     }
 
@@ -273,55 +325,72 @@ class DynamicArray {
 
     template <typename InputIt>
     void insert(size_t index, InputIt first, InputIt last) {
-        if (index > size_) {
-            throw std::out_of_range("Index out of range");
-        }
-
-        size_t count = std::distance(first, last);
-
-        if (size_ + count > capacity_) {
-            reserve(std::max(capacity_ * 2, size_ + count));
-        }
-
-        for (size_t i = size_ + count - 1; i >= index + count; --i) {
-            std::allocator_traits<Allocator>::construct(allocator_, data_ + i, std::move(data_[i - count]));
-            std::allocator_traits<Allocator>::destroy(allocator_, data_ + i - count);
-        }
-
-        for (size_t i = 0; i < count; ++i, ++first) {
-            std::allocator_traits<Allocator>::construct(allocator_, data_ + index + i, *first);
-        }
-
-        size_ += count;
+        insert_range(index, std::ranges::subrange(first, last));
     }
 
     template <typename InputIt>
     iterator insert(iterator position, InputIt first, InputIt last) {
-        size_t index = position - begin();
-        size_t count = std::distance(first, last);
-
-        if (size_ + count > capacity_) {
-            reserve(std::max(capacity_ * 2, size_ + count));
-        }
-
-        for (size_t i = size_ + count - 1; i >= index + count && i < size_ + count; --i) {
+        const size_t index = static_cast<size_t>(position - begin());
+        insert_range(index, std::ranges::subrange(first, last));
+        return begin() + index;
+    }
 
-            std::allocator_traits<Allocator>::construct(allocator_, data_ + i, std::move(data_[i - count]));
+    void insert(size_t index, std::initializer_list<T> ilist) {
+        insert(index, ilist.begin(), ilist.end());
+    }
 
-            std::allocator_traits<Allocator>::destroy(allocator_, data_ + i - count);
-        }
+    // Appends every element of 'range' (which must not refer to this array's elements)
+    // Sized / forward ranges: one reserve; contiguous ranges of T when T is trivially copyable: one memcpy
+    template <std::ranges::input_range Range>
+    void append_range(Range&& range) {
+        insert_range(size_, std::forward<Range>(range));
+    }
 
-        size_t i = index;
-        for (; first != last; ++first, ++i) {
-            std::allocator_traits<Allocator>::construct(allocator_, data_ + i, *first);
+    // Same, before 'index': the tail moves once (one memmove for trivially relocatable T)
+    template <std::ranges::input_range Range>
+    void insert_range(size_t index, Range&& range) {
+        if (index > size_) {
+            throw std::out_of_range("Index out of range (insert_range)");
         }
 
-        size_ += count;
-        return begin() + index;
-    }
+        if constexpr (!std::ranges::sized_range<Range> && !std::ranges::forward_range<Range>) {
+            // Single pass, unknown length => appended one by one, then rotated into place
+            const size_t old_size = size_;
+            try {
+                for (auto&& item : range) {
+                    emplace_back(std::forward<decltype(item)>(item));
+                }
+            } catch (...) {
+                truncate(old_size);
+                throw;
+            }
+            std::rotate(begin() + index, begin() + old_size, end());
+        } else {
+            const auto count = static_cast<size_t>(std::ranges::distance(range));
+            if (count == 0) {
+                return;
+            }
+            if (count > capacity_ - size_) {
+                grow(size_ + count);
+            }
 
-    void insert(size_t index, std::initializer_list<T> ilist) {
-        insert(index, ilist.begin(), ilist.end());
+            if constexpr (RELOCATABLE) {
+                open_gap(index, count);
+                try {
+                    copy_into(data_ + index, range, count);
+                } catch (...) {
+                    close_gap(index, count);
+                    throw;
+                }
+                size_ += count;
+            } else {
+                // Built at the end (a throwing constructor leaves the array as it was), then rotated in
+                const size_t old_size = size_;
+                copy_into(data_ + size_, range, count);
+                size_ += count;
+                std::rotate(begin() + index, begin() + old_size, end());
+            }
+        }
     }
 
     void pop_back() {
@@ -331,23 +400,48 @@ class DynamicArray {
         }
     }
 
-    void erase(size_t index) {
+    // Not for arrays of size_t, where it would be ambiguous with erase(value): use erase_at_index there
+    void erase(size_t index)
+        requires(!std::is_same_v<T, size_t>)
+    {
         erase_at_index(index);
     }
 
-    void erase(const T& value) {
-        size_t i = 0;
-        while (i < size_) {
-            if (data_[i] == value) {
-                std::allocator_traits<Allocator>::destroy(allocator_, data_ + i);
-                for (size_t j = i; j < size_ - 1; ++j) {
-                    std::allocator_traits<Allocator>::construct(allocator_, data_ + j, std::move(data_[j + 1]));
-                    std::allocator_traits<Allocator>::destroy(allocator_, data_ + j + 1);
-                }
-                --size_;
-            } else {
-                ++i;
-            }
+    // Removes every element equal to 'value' in one pass (stream compaction, order kept), returns how many
+    size_t erase(const T& value) {
+        if constexpr (simd::Arithmetic<T>) {
+            return truncate(simd::remove(data_, size_, value));
+        } else {
+            return truncate(static_cast<size_t>(std::remove(begin(), end(), value) - begin()));
+        }
+    }
+
+    template <typename Predicate>
+    size_t erase_if(Predicate pred) {
+        if constexpr (simd::Arithmetic<T>) {
+            return truncate(simd::remove_if(data_, size_, pred));
+        } else {
+            return truncate(static_cast<size_t>(std::remove_if(begin(), end(), pred) - begin()));
+        }
+    }
+
+    iterator find(const T& value) {
+        return begin() + index_of(value);
+    }
+
+    const_iterator find(const T& value) const {
+        return cbegin() + index_of(value);
+    }
+
+    bool contains(const T& value) const {
+        return index_of(value) != size_;
+    }
+
+    size_t count(const T& value) const {
+        if constexpr (simd::Arithmetic<T>) {
+            return simd::count(data_, size_, value);
+        } else {
+            return static_cast<size_t>(std::count(cbegin(), cend(), value));
         }
     }
 
@@ -364,9 +458,13 @@ class DynamicArray {
 
         std::allocator_traits<Allocator>::destroy(allocator_, data_ + index);
 
-        for (size_t i = index; i < size_ - 1; ++i) {
-            std::allocator_traits<Allocator>::construct(allocator_, data_ + i, std::move(data_[i + 1]));
-            std::allocator_traits<Allocator>::destroy(allocator_, data_ + i + 1);
+        if constexpr (RELOCATABLE) {
+            std::memmove(static_cast<void*>(data_ + index), data_ + index + 1, (size_ - index - 1) * sizeof(T));
+        } else {
+            for (size_t i = index; i < size_ - 1; ++i) {
+                std::allocator_traits<Allocator>::construct(allocator_, data_ + i, std::move(data_[i + 1]));
+                std::allocator_traits<Allocator>::destroy(allocator_, data_ + i + 1);
+            }
         }
 
         --size_;
@@ -374,17 +472,34 @@ class DynamicArray {
 
     void reserve(size_t new_capacity) {
         if (new_capacity > capacity_) {
-            T* new_data = allocator_.allocate(new_capacity);
-
-            for (size_t i = 0; i < size_; ++i) {
-                std::allocator_traits<Allocator>::construct(allocator_, new_data + i, std::move(data_[i]));
-                std::allocator_traits<Allocator>::destroy(allocator_, data_ + i);
-            }
+            relocate(new_capacity);
+        }
+    }
 
+    // Capacity down to size(); with a reallocating allocator the block shrinks in place
+    // (HugePageAllocator hands the unused pages back to the kernel)
+    void shrink_to_fit() {
+        if (capacity_ == size_) {
+            return;
+        }
+        if (size_ == 0) {
             allocator_.deallocate(data_, capacity_);
-            data_ = new_data;
-            capacity_ = new_capacity;
+            data_ = nullptr;
+            capacity_ = 0;
+            return;
+        }
+        relocate(size_);
+    }
+
+    double growth_factor() const noexcept {
+        return growth_factor_;
+    }
+
+    void set_growth_factor(double factor) {
+        if (!(factor > 1.0)) {
+            throw std::invalid_argument("DynamicArray: growth factor must be greater than 1");
         }
+        growth_factor_ = factor;
     }
 
     void resize(size_t new_size) {
@@ -403,6 +518,36 @@ class DynamicArray {
         size_ = new_size;
     }
 
+    // resize() without value-initialization: new elements are default-initialized => trivial types keep
+    // whatever the memory held (no zeroing pass over a buffer that is about to be overwritten)
+    void resize_for_overwrite(size_t new_size) {
+        if (new_size <= size_) {
+            truncate(new_size);
+            return;
+        }
+        if (new_size > capacity_) {
+            reserve(new_size);
+        }
+        if constexpr (!std::is_trivially_default_constructible_v<T>) {
+            for (size_t i = size_; i < new_size; ++i) {
+                ::new (static_cast<void*>(data_ + i)) T;
+            }
+        }
+        size_ = new_size;
+    }
+
+    // Sets the size without constructing or destroying anything, e.g. after filling data() by read(2):
+    //   array.reserve(n); size_t got = read(fd, array.data(), n); array.unsafe_set_size(got);
+    // Only for trivial T (the bytes in [size, new_size) become elements as they are)
+    void unsafe_set_size(size_t new_size) {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>,
+                      "unsafe_set_size: elements past size() are never constructed => T must be trivial");
+        if (new_size > capacity_) {
+            throw std::length_error("DynamicArray: unsafe_set_size beyond capacity");
+        }
+        size_ = new_size;
+    }
+
     void clear() noexcept {
         for (size_t i = 0; i < size_; ++i) {
             std::allocator_traits<Allocator>::destroy(allocator_, data_ + i);
@@ -421,5 +566,92 @@ class DynamicArray {
     bool empty() const noexcept {
         return size_ == 0;
     }
+
+  private:
+    size_t index_of(const T& value) const {
+        if constexpr (simd::Arithmetic<T>) {
+            return simd::find(data_, size_, value);
+        } else {
+            return static_cast<size_t>(std::find(cbegin(), cend(), value) - cbegin());
+        }
+    }
+
+    // Destroys the elements from 'new_size' on, returns how many there were
+    size_t truncate(size_t new_size) noexcept {
+        const size_t removed = size_ - new_size;
+        for (size_t i = new_size; i < size_; ++i) {
+            std::allocator_traits<Allocator>::destroy(allocator_, data_ + i);
+        }
+        size_ = new_size;
+        return removed;
+    }
+
+    // Moves [index, size_) up by 'count' (capacity is there), the gap is raw memory
+    void open_gap(size_t index, size_t count) noexcept {
+        static_assert(RELOCATABLE);
+        std::memmove(static_cast<void*>(data_ + index + count), data_ + index, (size_ - index) * sizeof(T));
+    }
+
+    void close_gap(size_t index, size_t count) noexcept {
+        static_assert(RELOCATABLE);
+        std::memmove(static_cast<void*>(data_ + index), data_ + index + count, (size_ - index) * sizeof(T));
+    }
+
+    // Constructs the 'count' elements of 'range' in raw memory at 'out'; all or nothing
+    template <typename Range>
+    void copy_into(T* out, Range& range, size_t count) {
+        using Source = std::remove_cvref_t<std::ranges::range_reference_t<Range>>;
+        if constexpr (std::ranges::contiguous_range<Range> && std::is_same_v<Source, T> &&
+                      std::is_trivially_copyable_v<T>) {
+            std::memcpy(static_cast<void*>(out), std::ranges::data(range), count * sizeof(T));
+        } else {
+            size_t built = 0;
+            try {
+                for (auto it = std::ranges::begin(range); built < count; ++it, ++built) {
+                    std::allocator_traits<Allocator>::construct(allocator_, out + built, *it);
+                }
+            } catch (...) {
+                for (size_t i = 0; i < built; ++i) {
+                    std::allocator_traits<Allocator>::destroy(allocator_, out + i);
+                }
+                throw;
+            }
+        }
+    }
+
+    // Capacity for at least 'needed' elements, growing geometrically
+    void grow(size_t needed) {
+        const double scaled = static_cast<double>(capacity_) * growth_factor_;
+        size_t next = scaled >= static_cast<double>(std::numeric_limits<size_t>::max())
+                          ? std::numeric_limits<size_t>::max()
+                          : static_cast<size_t>(scaled);
+        next = std::max({next, capacity_ + 1, needed});
+        relocate(next);
+    }
+
+    // Moves the elements into a block of 'new_capacity' (>= size_, may be below capacity_)
+    void relocate(size_t new_capacity) {
+        if constexpr (RELOCATABLE && ReallocatingAllocator<Allocator, T>) {
+            data_ = allocator_.reallocate(data_, capacity_, new_capacity);
+        } else if constexpr (RELOCATABLE) {
+            T* new_data = allocator_.allocate(new_capacity);
+            if (size_ != 0) {
+                std::memcpy(static_cast<void*>(new_data), data_, size_ * sizeof(T));
+            }
+            allocator_.deallocate(data_, capacity_);
+            data_ = new_data;
+        } else {
+            T* new_data = allocator_.allocate(new_capacity);
+
+            for (size_t i = 0; i < size_; ++i) {
+                std::allocator_traits<Allocator>::construct(allocator_, new_data + i, std::move(data_[i]));
+                std::allocator_traits<Allocator>::destroy(allocator_, data_ + i);
+            }
+
+            allocator_.deallocate(data_, capacity_);
+            data_ = new_data;
+        }
+        capacity_ = new_capacity;
+    }
 };
 }  // namespace renn::containers
@@ -0,0 +1,492 @@
+#pragma once
+
+#include "../DynamicArray.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace renn::containers {
+
+// Insertion-ordered hash table with the CPython "compact dict" layout
+//
+// entries_ : dense array of (hash, key, value) in insertion order => iteration is a linear scan
+// index_   : open-addressing table of small integer offsets into entries_
+//            the width of one slot (1/2/4/8 bytes) is picked from the number of entries it must address
+//
+// Erase only marks the entry as dead, the slot keeps pointing to it (acts as a tombstone)
+// Dead entries are dropped lazily, when the entries array is full and the table is rebuilt
+
+template <typename Key, typename Value,
+          typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<std::pair<Key, Value>>>
+class CompactHashTable {
+  private:
+    struct Entry {
+        std::pair<Key, Value> data_;
+        size_t cached_hash_;
+        bool alive_;
+
+        template <typename K, typename V>
+        Entry(size_t hash, K&& k, V&& v) : data_(std::forward<K>(k), std::forward<V>(v)), cached_hash_(hash), alive_(true) {}
+    };
+
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using EntryAllocator = typename AllocTraits::template rebind_alloc<Entry>;
+    using IndexAllocator = typename AllocTraits::template rebind_alloc<uint8_t>;
+    using EntryArray = DynamicArray<Entry, EntryAllocator>;
+    using IndexArray = DynamicArray<uint8_t, IndexAllocator>;
+
+  public:
+    struct Ref {
+        const Key& first;
+        Value& second;
+    };
+
+    template <bool is_const>
+    class Iterator {
+      private:
+        using EntryPtr = std::conditional_t<is_const, const Entry*, Entry*>;
+        using ValueRef = std::conditional_t<is_const, const Value&, Value&>;
+
+        EntryPtr current_;
+        EntryPtr last_;
+
+        void skip_dead() {
+            while (current_ != last_ && !current_->alive_) {
+                ++current_;
+            }
+        }
+
+      public:
+        struct Reference {
+            const Key& first;
+            ValueRef second;
+        };
+
+        struct Arrow {
+            Reference ref_;
+
+            const Reference* operator->() const { return &ref_; }
+        };
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Reference;
+        using difference_type = std::ptrdiff_t;
+        using reference = Reference;
+
+        Iterator(EntryPtr current, EntryPtr last) : current_(current), last_(last) {
+            skip_dead();
+        }
+
+        Reference operator*() const {
+            return Reference{current_->data_.first, current_->data_.second};
+        }
+
+        Arrow operator->() const {
+            return Arrow{**this};
+        }
+
+        Iterator& operator++() {
+            ++current_;
+            skip_dead();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return current_ == other.current_;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return current_ != other.current_;
+        }
+
+        operator Iterator<true>() const { return Iterator<true>(current_, last_); }
+
+        friend class CompactHashTable;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+  public:
+    CompactHashTable() {
+        rebuild(MIN_INDEX_SLOTS);
+    }
+
+    explicit CompactHashTable(size_t expected_size, const Hash& hash = Hash(),
+                              const KeyEqual& equal = KeyEqual(),
+                              const Allocator& alloc = Allocator()) : hash_(hash), equal_(equal), allocator_(alloc),
+                                                                      entries_(EntryAllocator(allocator_)),
+                                                                      index_(IndexAllocator(allocator_)) {
+        rebuild(slots_for(expected_size));
+    }
+
+    CompactHashTable(std::initializer_list<std::pair<const Key, Value>> init) : CompactHashTable(init.size()) {
+        for (const auto& item : init) {
+            emplace(item.first, item.second);
+        }
+    }
+
+    CompactHashTable(const CompactHashTable&) = default;
+    CompactHashTable& operator=(const CompactHashTable&) = default;
+
+    // The moved-from table is left empty without storage (allocates again on its next insert)
+    CompactHashTable(CompactHashTable&& other) noexcept : hash_(std::move(other.hash_)),
+                                                          equal_(std::move(other.equal_)),
+                                                          allocator_(std::move(other.allocator_)),
+                                                          entries_(std::move(other.entries_)),
+                                                          index_(std::move(other.index_)),
+                                                          index_slots_(other.index_slots_),
+                                                          index_width_(other.index_width_),
+                                                          usable_(other.usable_),
+                                                          size_(other.size_) {
+        other.leave_empty();
+    }
+
+    CompactHashTable& operator=(CompactHashTable&& other) noexcept {
+        if (this != &other) {
+            hash_ = std::move(other.hash_);
+            equal_ = std::move(other.equal_);
+            allocator_ = std::move(other.allocator_);
+            entries_ = std::move(other.entries_);
+            index_ = std::move(other.index_);
+            index_slots_ = other.index_slots_;
+            index_width_ = other.index_width_;
+            usable_ = other.usable_;
+            size_ = other.size_;
+
+            other.leave_empty();
+        }
+        return *this;
+    }
+
+    ~CompactHashTable() = default;
+
+    // -----------------------------------------------
+
+    iterator begin() { return iterator(entries_.begin(), entries_.end()); }
+
+    iterator end() { return iterator(entries_.end(), entries_.end()); }
+
+    const_iterator begin() const { return const_iterator(entries_.cbegin(), entries_.cend()); }
+
+    const_iterator end() const { return const_iterator(entries_.cend(), entries_.cend()); }
+
+    template <typename K, typename V>
+    std::pair<iterator, bool> emplace(K&& key, V&& value) {
+        const size_t hash_value = hash_(key);
+
+        const size_t found = lookup(key, hash_value);
+        if (found != NOT_FOUND) {
+            return {iterator_at(found), false};
+        }
+
+        if (entries_.size() == usable_) {
+            // Either drop the dead entries in place or grow, whichever leaves room for growth
+            rebuild(size_ * 2 < usable_ ? index_slots_ : std::max(index_slots_ * 2, MIN_INDEX_SLOTS));
+        }
+
+        const size_t position = entries_.size();
+        entries_.emplace_back(hash_value, std::forward<K>(key), std::forward<V>(value));
+        index_set(find_empty_slot(hash_value), position);
+        ++size_;
+
+        return {iterator_at(position), true};
+    }
+
+    std::pair<iterator, bool> insert(const std::pair<const Key, Value>& kv) {
+        return emplace(kv.first, kv.second);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        auto it = find(key);
+        if (it != end()) {
+            return {it, false};
+        }
+        return emplace(key, Value(std::forward<Args>(args)...));
+    }
+
+    iterator find(const Key& key) {
+        const size_t found = lookup(key, hash_(key));
+        return found == NOT_FOUND ? end() : iterator_at(found);
+    }
+
+    const_iterator find(const Key& key) const {
+        const size_t found = lookup(key, hash_(key));
+        return found == NOT_FOUND ? end() : const_iterator(entries_.cbegin() + found, entries_.cend());
+    }
+
+    bool contains(const Key& key) const {
+        return lookup(key, hash_(key)) != NOT_FOUND;
+    }
+
+    Value& at(const Key& key) {
+        const size_t found = lookup(key, hash_(key));
+
+        if (found == NOT_FOUND)
+            throw std::out_of_range("Key not found");
+
+        return entries_[found].data_.second;
+    }
+
+    const Value& at(const Key& key) const {
+        const size_t found = lookup(key, hash_(key));
+
+        if (found == NOT_FOUND)
+            throw std::out_of_range("Key not found");
+
+        return entries_[found].data_.second;
+    }
+
+    Value& operator[](const Key& key) {
+        return (*emplace(key, Value{}).first).second;
+    }
+
+    bool erase(const Key& key) {
+        const size_t found = lookup(key, hash_(key));
+
+        if (found == NOT_FOUND) {
+            return false;
+        }
+
+        entries_[found].alive_ = false;
+        --size_;
+        return true;
+    }
+
+    iterator erase(iterator position) {
+        if (position == end()) {
+            return end();
+        }
+
+        position.current_->alive_ = false;
+        --size_;
+        return ++position;
+    }
+
+    void clear() {
+        entries_.clear();
+        size_ = 0;
+        rebuild(MIN_INDEX_SLOTS);
+    }
+
+    void reserve(size_t count) {
+        const size_t slots = slots_for(count);
+        if (slots > index_slots_) {
+            rebuild(slots);
+        }
+    }
+
+    // Drops dead entries and shrinks the index to the smallest width/size that fits
+    void shrink_to_fit() {
+        rebuild(slots_for(size_));
+    }
+
+    size_t size() const noexcept { return size_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+    // Number of index slots (the analogue of the bucket count)
+    size_t bucket_count() const noexcept { return index_slots_; }
+
+    float load_factor() const noexcept { return index_slots_ == 0 ? 0.0f : static_cast<float>(size_) / index_slots_; }
+
+    // Entries erased but not compacted yet
+    size_t dead_count() const noexcept { return entries_.size() - size_; }
+
+    // Bytes per index slot, 1/2/4/8
+    size_t index_width() const noexcept { return index_width_; }
+
+    size_t memory_usage() const noexcept {
+        return entries_.capacity() * sizeof(Entry) + index_.capacity();
+    }
+
+  private:
+    iterator iterator_at(size_t position) {
+        return iterator(entries_.begin() + position, entries_.end());
+    }
+
+    // Returns the entry offset, or NOT_FOUND
+    size_t lookup(const Key& key, size_t hash_value) const {
+        if (size_ == 0) {
+            return NOT_FOUND;  // Also covers a moved-from table, which has no index
+        }
+
+        const size_t mask = index_slots_ - 1;
+        size_t slot = hash_value & mask;
+        size_t perturb = hash_value;
+
+        for (;;) {
+            const size_t position = index_get(slot);
+
+            if (position == empty_marker()) {
+                return NOT_FOUND;
+            }
+
+            const Entry& entry = entries_[position];
+            if (entry.alive_ && entry.cached_hash_ == hash_value && equal_(entry.data_.first, key)) {
+                return position;
+            }
+
+            slot = next_slot(slot, perturb, mask);
+        }
+    }
+
+    size_t find_empty_slot(size_t hash_value) const {
+        const size_t mask = index_slots_ - 1;
+        size_t slot = hash_value & mask;
+        size_t perturb = hash_value;
+
+        while (index_get(slot) != empty_marker()) {
+            slot = next_slot(slot, perturb, mask);
+        }
+        return slot;
+    }
+
+    // CPython's probing: the high bits of the hash take part until they are shifted out
+    static size_t next_slot(size_t slot, size_t& perturb, size_t mask) noexcept {
+        perturb >>= PERTURB_SHIFT;
+        return (slot * 5 + perturb + 1) & mask;
+    }
+
+    // Reallocates the index with 'slots' slots and moves live entries into a fresh dense array
+    void rebuild(size_t slots) {
+        const size_t usable = slots * 2 / 3;
+        const size_t width = width_for(usable);
+
+        EntryArray entries{EntryAllocator(allocator_)};
+        entries.reserve(usable);
+
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            if (entries_[i].alive_) {
+                entries.push_back(std::move(entries_[i]));
+            }
+        }
+
+        // all bytes 0xFF => every slot holds the all-ones EMPTY marker whatever the width is
+        IndexArray index(slots * width, static_cast<uint8_t>(0xFF), IndexAllocator(allocator_));
+
+        entries_ = std::move(entries);
+        index_ = std::move(index);
+        index_slots_ = slots;
+        index_width_ = width;
+        usable_ = usable;
+
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            index_set(find_empty_slot(entries_[i].cached_hash_), i);
+        }
+    }
+
+    // After entries_ / index_ were moved out (=> empty, no storage): no slots until the next insert rebuilds
+    void leave_empty() noexcept {
+        entries_.clear();
+        index_.clear();
+        index_slots_ = 0;
+        index_width_ = 1;
+        usable_ = 0;
+        size_ = 0;
+    }
+
+    size_t index_get(size_t slot) const noexcept {
+        const uint8_t* raw = &index_[slot * index_width_];
+
+        switch (index_width_) {
+            case 1:
+                return *raw;
+            case 2: {
+                uint16_t value;
+                std::memcpy(&value, raw, sizeof(value));
+                return value;
+            }
+            case 4: {
+                uint32_t value;
+                std::memcpy(&value, raw, sizeof(value));
+                return value;
+            }
+            default: {
+                uint64_t value;
+                std::memcpy(&value, raw, sizeof(value));
+                return value;
+            }
+        }
+    }
+
+    void index_set(size_t slot, size_t position) noexcept {
+        uint8_t* raw = &index_[slot * index_width_];
+
+        switch (index_width_) {
+            case 1:
+                *raw = static_cast<uint8_t>(position);
+                break;
+            case 2: {
+                auto value = static_cast<uint16_t>(position);
+                std::memcpy(raw, &value, sizeof(value));
+                break;
+            }
+            case 4: {
+                auto value = static_cast<uint32_t>(position);
+                std::memcpy(raw, &value, sizeof(value));
+                break;
+            }
+            default: {
+                auto value = static_cast<uint64_t>(position);
+                std::memcpy(raw, &value, sizeof(value));
+                break;
+            }
+        }
+    }
+
+    size_t empty_marker() const noexcept {
+        return index_width_ == 8 ? ~size_t{0} : (size_t{1} << (index_width_ * 8)) - 1;
+    }
+
+    // The widest offset must stay below the EMPTY marker of the chosen width
+    static size_t width_for(size_t usable) noexcept {
+        if (usable < UINT8_MAX)
+            return 1;
+        if (usable < UINT16_MAX)
+            return 2;
+        if (usable < UINT32_MAX)
+            return 4;
+        return 8;
+    }
+
+    // Smallest power of two slot count whose 2/3 can hold 'count' entries
+    static size_t slots_for(size_t count) noexcept {
+        size_t slots = MIN_INDEX_SLOTS;
+        while (slots * 2 / 3 < count) {
+            slots <<= 1;
+        }
+        return slots;
+    }
+
+  private:
+    Hash hash_;
+    KeyEqual equal_;
+    Allocator allocator_;
+
+    EntryArray entries_;  // Insertion order, may contain dead entries
+    IndexArray index_;    // index_slots_ * index_width_ raw bytes
+
+    size_t index_slots_{0};
+    size_t index_width_{1};
+    size_t usable_{0};  // Max entries (alive + dead) before rebuild
+    size_t size_{0};    // Alive entries
+
+    static constexpr size_t MIN_INDEX_SLOTS = 8;
+    static constexpr size_t PERTURB_SHIFT = 5;
+    static constexpr size_t NOT_FOUND = ~size_t{0};
+};
+}  // namespace renn::containers
@@ -1,19 +1,47 @@
 #pragma once
 
+#include "../BloomFilter.hpp"
 #include "../DynamicArray.hpp"
 #include "../List.hpp"
+#include "../../Sync/WaitGroup.hpp"
 #include "Hashers/CityHash.hpp"
 #include "Hashers/MurmurHash.hpp"
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <exception>
 #include <functional>
 #include <iostream>
+#include <optional>
 #include <stdexcept>
+#include <thread>
 #include <utility>
 
 namespace renn::containers {
 
+// Snapshot of the table layout, see HashTable::stats()
+// Meant for diagnosing slow tables: bad hash (long chains), bad load factor or memory overhead
+struct HashTableStats {
+    static constexpr size_t HISTOGRAM_BINS = 16;
+
+    size_t size = 0;
+    size_t bucket_count = 0;
+    float load_factor = 0.0f;
+
+    // chain_histogram[k] = number of buckets holding exactly k elements
+    // the last bin accumulates every bucket with HISTOGRAM_BINS - 1 or more elements
+    std::array<size_t, HISTOGRAM_BINS> chain_histogram{};
+    size_t max_chain_length = 0;
+    float mean_chain_length = 0.0f;  // over non-empty buckets => expected probe length of a hit
+    size_t empty_buckets = 0;
+    float empty_bucket_fraction = 0.0f;
+
+    size_t node_bytes = 0;    // element nodes, including list links
+    size_t bucket_bytes = 0;  // bucket array capacity
+
+    size_t rehash_count = 0;
+};
+
 template <typename Key, typename Value,
           typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
           typename Allocator = std::allocator<std::pair<Key, Value>>>
@@ -29,11 +57,11 @@ class HashTable {
 
         HashNode(size_t hash, Key&& k, Value&& v) : cached_hash_(hash), data_(std::move(k), std::move(v)) {}
 
-        Value& get_value() { return data_.second_; }
+        Value& get_value() { return data_.second; }
 
-        const Key& get_key() const { return data_.first_; }
+        const Key& get_key() const { return data_.first; }
 
-        const Value& get_value() const { return data_.second_; }
+        const Value& get_value() const { return data_.second; }
 
         HashNode(const HashNode& other) : data_(other.data_), cached_hash_(other.cached_hash_) {}
 
@@ -69,11 +97,11 @@ class HashTable {
         iterator(typename ListType::iterator it) : it_(it) {}
 
         HashTableRef operator*() const {
-            return HashTableRef(it_->data_.first_, it_->data_.second_);
+            return HashTableRef(it_->data_.first, it_->data_.second);
         }
 
         HashTableRef* operator->() const {
-            return new HashTableRef(it_->data_.first_, it_->data_.second_);
+            return new HashTableRef(it_->data_.first, it_->data_.second);
         }
 
         iterator& operator++() {
@@ -113,7 +141,7 @@ class HashTable {
         const_iterator(typename ListType::const_iterator it) : it_(it) {}
 
         const HashTableRef operator*() const {
-            return HashTableRef(it_->data_.first_, it_->data_.second_);
+            return HashTableRef(it_->data_.first, it_->data_.second);
         }
 
         const_iterator& operator++() {
@@ -157,21 +185,23 @@ class HashTable {
             DynamicArray<ListIterator> new_table(count, elements_.end());
 
             // Redistribute existing elements into new table
-            for (auto it = elements_.begin(); it != elements_.end(); ++it) {
+            // Every bucket must stay a contiguous run of the element list,
+            // so each node is relinked in front of its bucket's current head.
+            // Nodes only ever move backwards (into the already visited prefix) => the walk stays valid
+            for (auto it = elements_.begin(); it != elements_.end();) {
+                auto current = it++;
+
                 // Calculate new index using cached hash value
-                size_t new_index = it->cached_hash_ % count;
+                size_t new_index = current->cached_hash_ % count;
 
-                // If bucket is empty (contains end iterator), place element
-                if (new_table[new_index] == elements_.end()) {
-                    new_table[new_index] = it;
+                // If bucket is not empty, join its run
+                if (new_table[new_index] != elements_.end()) {
+                    elements_.splice(new_table[new_index], elements_, current);
                 }
+                new_table[new_index] = current;
             }
 
-            // Move new table into place
-            hash_table_ = std::move(new_table);
-            bucket_count_ = count;
-            // Recalculate rehashing threshold
-            rehash_threshold_ = static_cast<size_t>(bucket_count_ * MAX_LOAD_FACTOR);
+            install_buckets(std::move(new_table), count);
 
         } catch (const std::bad_alloc& e) {
             // Propagate memory allocation failures
@@ -179,8 +209,119 @@ class HashTable {
         }
     }
 
+    // Same result as rehash(count), with the work split over 'scheduler' (anything with submit(Renn), e.g. ThreadPool)
+    // Small tables (less than MIN_PARALLEL_CHUNK elements per part) fall back to the sequential version
+    //
+    // Every bucket must stay a contiguous run of the element list => the nodes are counting-sorted by new bucket:
+    //  1. per part of the nodes: compute new bucket indices, count nodes per bucket range
+    //  2. scatter the nodes into their bucket range (prefix sums give disjoint slots)
+    //  3. per bucket range: counting sort by bucket, set the bucket heads
+    //  4. per part of the final order: relink prev/next
+    // Nodes are never copied or reallocated => iterators and references stay valid, as with rehash(count)
+    //
+    // Blocks until done: must not be called from a task running on the same scheduler
+    template <typename Scheduler>
+    void rehash(size_t count, Scheduler& scheduler) {
+        count = std::max(count, MIN_BUCKET_COUNT);
+        count = std::max(count, static_cast<size_t>(std::ceil(size_ / MAX_LOAD_FACTOR)));
+
+        if (count == bucket_count_)
+            return;
+
+        const size_t hardware_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        const size_t parts = std::min({hardware_threads, size_ / MIN_PARALLEL_CHUNK, count});
+
+        if (parts <= 1) {
+            rehash(count);
+            return;
+        }
+
+        const size_t n = size_;
+
+        // The walk is inherently sequential, everything after it is not
+        DynamicArray<ListIterator> nodes;
+        nodes.reserve(n);
+        for (auto it = elements_.begin(); it != elements_.end(); ++it) {
+            nodes.push_back(it);
+        }
+
+        DynamicArray<size_t> indices(n, 0);
+        DynamicArray<size_t> range_counts(parts * parts, 0);  // [part][range]
+
+        auto part_begin = [n, parts](size_t p) { return p * n / parts; };
+        auto range_of = [count, parts](size_t bucket) { return bucket * parts / count; };
+        auto range_begin = [count, parts](size_t r) { return (r * count + parts - 1) / parts; };
+
+        // 1. New bucket indices + per-part histograms over the bucket ranges
+        parallel_for(scheduler, parts, [&](size_t p) {
+            size_t* counts = &range_counts[p * parts];
+            for (size_t i = part_begin(p); i < part_begin(p + 1); ++i) {
+                indices[i] = nodes[i]->cached_hash_ % count;
+                ++counts[range_of(indices[i])];
+            }
+        });
+
+        // Exclusive prefix sums, range-major => every range gets one contiguous slice of 'grouped'
+        DynamicArray<size_t> offsets(parts * parts, 0);
+        DynamicArray<size_t> range_offsets(parts + 1, 0);
+        size_t offset = 0;
+        for (size_t r = 0; r < parts; ++r) {
+            range_offsets[r] = offset;
+            for (size_t p = 0; p < parts; ++p) {
+                offsets[p * parts + r] = offset;
+                offset += range_counts[p * parts + r];
+            }
+        }
+        range_offsets[parts] = offset;
+
+        // 2. Scatter into the bucket ranges
+        DynamicArray<size_t> grouped(n, 0);  // Positions in 'nodes'
+        parallel_for(scheduler, parts, [&](size_t p) {
+            size_t* slots = &offsets[p * parts];
+            for (size_t i = part_begin(p); i < part_begin(p + 1); ++i) {
+                grouped[slots[range_of(indices[i])]++] = i;
+            }
+        });
+
+        // 3. Counting sort inside every range, bucket heads of the new table
+        DynamicArray<ListIterator> order(n, elements_.end());
+        DynamicArray<ListIterator> new_table(count, elements_.end());
+        parallel_for(scheduler, parts, [&](size_t r) {
+            const size_t first_bucket = range_begin(r);
+            const size_t buckets = range_begin(r + 1) - first_bucket;
+
+            DynamicArray<size_t> starts(buckets + 1, 0);
+            for (size_t j = range_offsets[r]; j < range_offsets[r + 1]; ++j) {
+                ++starts[indices[grouped[j]] - first_bucket + 1];
+            }
+            for (size_t b = 0; b < buckets; ++b) {
+                starts[b + 1] += starts[b];
+            }
+            for (size_t j = range_offsets[r]; j < range_offsets[r + 1]; ++j) {
+                const size_t i = grouped[j];
+                order[range_offsets[r] + starts[indices[i] - first_bucket]++] = nodes[i];
+            }
+            // starts[b] now is the end of bucket b
+            for (size_t b = 0, begin = 0; b < buckets; begin = starts[b++]) {
+                if (begin != starts[b]) {
+                    new_table[first_bucket + b] = order[range_offsets[r] + begin];
+                }
+            }
+        });
+
+        // 4. Relink the list in the new order
+        parallel_for(scheduler, parts, [&](size_t p) {
+            elements_.relink_range(&order[0], part_begin(p), part_begin(p + 1));
+        });
+
+        install_buckets(std::move(new_table), count);
+    }
+
     void clear() {
         elements_.clear();
+        if (bloom_) {
+            bloom_->clear();
+        }
         hash_table_ = DynamicArray<ListIterator>(MIN_BUCKET_COUNT, elements_.end());
         size_ = 0;
         bucket_count_ = MIN_BUCKET_COUNT;
@@ -217,9 +358,14 @@ class HashTable {
             allocator_ = std::move(other.allocator_);
             hash_table_ = std::move(other.hash_table_);
             elements_ = std::move(other.elements_);
+            size_ = other.size_;
             bucket_count_ = other.bucket_count_;
             rehash_threshold_ = other.rehash_threshold_;
+            rehash_count_ = other.rehash_count_;
+            bloom_ = std::move(other.bloom_);
+            bloom_bits_per_key_ = other.bloom_bits_per_key_;
 
+            other.bloom_.reset();
             other.elements_.clear();
             other.hash_table_.clear();
             other.size_ = 0;
@@ -237,8 +383,12 @@ class HashTable {
                                             hash_table_(std::move(other.hash_table_)),
                                             size_(other.size_),
                                             bucket_count_(other.bucket_count_),
-                                            rehash_threshold_(other.rehash_threshold_) {
+                                            rehash_threshold_(other.rehash_threshold_),
+                                            rehash_count_(other.rehash_count_),
+                                            bloom_(std::move(other.bloom_)),
+                                            bloom_bits_per_key_(other.bloom_bits_per_key_) {
 
+        other.bloom_.reset();
         other.size_ = 0;
         other.bucket_count_ = MIN_BUCKET_COUNT;
         other.rehash_threshold_ = static_cast<size_t>(MIN_BUCKET_COUNT * MAX_LOAD_FACTOR);
@@ -249,7 +399,9 @@ class HashTable {
                                         allocator_(AllocTraits::select_on_container_copy_construction(other.allocator_)),
                                         elements_(), hash_table_(other.bucket_count_, elements_.end()),
                                         size_(0), bucket_count_(other.bucket_count_),
-                                        rehash_threshold_(other.rehash_threshold_) {
+                                        rehash_threshold_(other.rehash_threshold_),
+                                        bloom_(other.bloom_),
+                                        bloom_bits_per_key_(other.bloom_bits_per_key_) {
 
         for (const auto& elem : other.elements_) {
             insert(elem);
@@ -263,7 +415,9 @@ class HashTable {
                                                                 hash_table_(other.bucket_count_, elements_.end()),
                                                                 size_(0),
                                                                 bucket_count_(other.bucket_count_),
-                                                                rehash_threshold_(other.rehash_threshold_) {
+                                                                rehash_threshold_(other.rehash_threshold_),
+                                                                bloom_(other.bloom_),
+                                                                bloom_bits_per_key_(other.bloom_bits_per_key_) {
         for (const auto& elem : other.elements_) {
             insert(elem);
         }
@@ -317,21 +471,29 @@ class HashTable {
             BaseNodeType tmp_pair(std::forward<Args>(args)...);
 
             // Calculate hash value for the key
-            const size_t hash_value = hash_(tmp_pair.first_);
+            const size_t hash_value = hash_(tmp_pair.first);
 
             // Determine bucket index using modulo
             size_t bucket_index = hash_value % bucket_count_;
 
             // Check if key already exists in the bucket
             auto current = hash_table_[bucket_index];
+            size_t chain_length = 0;
 
             while (current != elements_.end() && current->cached_hash_ % bucket_count_ == bucket_index) {
-                if (equal_(current->data_.first_, tmp_pair.first_)) {
+                if (equal_(current->data_.first, tmp_pair.first)) {
                     return {iterator(current), false};  // Key exists, return false
                 }
                 ++current;
+                ++chain_length;
             }
 
+#ifndef NDEBUG
+            if (chain_length >= DEGENERATE_CHAIN_LENGTH) {
+                warn_degenerate_chain(bucket_index, chain_length);
+            }
+#endif
+
             // Check if rehashing is needed (load factor exceeded)
             if (size_ + 1 > rehash_threshold_) {
                 try {
@@ -346,8 +508,8 @@ class HashTable {
 
             // Create new node with the hash value and moved data
             HashNode node(hash_value,
-                          std::move(const_cast<Key&>(tmp_pair.first_)),
-                          std::move(tmp_pair.second_));
+                          std::move(const_cast<Key&>(tmp_pair.first)),
+                          std::move(tmp_pair.second));
 
             // Find insertion position in the bucket
             auto inserted_position = hash_table_[bucket_index];
@@ -358,6 +520,10 @@ class HashTable {
             // Insert the node into the list
             auto inserted_it = elements_.emplace(inserted_position, std::move(node));
 
+            if (bloom_) {
+                bloom_->insert_hash(hash_value);
+            }
+
             // Update bucket head if needed
             if (hash_table_[bucket_index] == elements_.end()) {
                 hash_table_[bucket_index] = inserted_it;
@@ -439,11 +605,17 @@ class HashTable {
 
     iterator find(const Key& key) {
         const size_t hash_value = hash_(key);
+
+        // Most misses end here without touching the bucket chain
+        if (bloom_ && !bloom_->may_contain_hash(hash_value)) {
+            return end();
+        }
+
         const size_t bucket_index = hash_value % bucket_count_;
 
         auto current = hash_table_[bucket_index];
         while (current != elements_.end() && current->cached_hash_ % bucket_count_ == bucket_index) {
-            if (equal_(current->data_.first_, key)) {
+            if (equal_(current->data_.first, key)) {
                 return iterator(current);
             }
             ++current;
@@ -453,12 +625,18 @@ class HashTable {
 
     const_iterator find(const Key& key) const {
         const size_t hash_value = hash_(key);
+
+        // Most misses end here without touching the bucket chain
+        if (bloom_ && !bloom_->may_contain_hash(hash_value)) {
+            return end();
+        }
+
         const size_t bucket_index = hash_value % bucket_count_;
 
 
         auto current = hash_table_[bucket_index];
         while (current != elements_.end() && current->cached_hash_ % bucket_count_ == bucket_index) {
-            if (equal_(current->data_.first_, key)) {
+            if (equal_(current->data_.first, key)) {
                 return const_iterator(current);
             }
             ++current;
@@ -470,11 +648,11 @@ class HashTable {
         auto it = find(key);
 
         if (it != end()) {
-            return it.it_->data_.second_;
+            return it.it_->data_.second;
         }
 
         auto [inserted_it, success] = emplace(key, Value{});
-        return inserted_it.it_->data_.second_;
+        return inserted_it.it_->data_.second;
     }
 
     const Value& operator[](const Key& key) const {
@@ -483,7 +661,7 @@ class HashTable {
         if (it == end())
             throw std::out_of_range("Key not found!");
 
-        return it.it_->data_.second_;
+        return it.it_->data_.second;
     }
 
     Value& at(const Key& key) {
@@ -492,7 +670,7 @@ class HashTable {
         if (it == end())
             throw std::out_of_range("Key not found");
 
-        return it.it_->data_.second_;
+        return it.it_->data_.second;
     }
 
     bool contains(const Key& key) const {
@@ -504,11 +682,12 @@ class HashTable {
     }
 
     iterator end(size_t n) {
-        auto next_bucket = n + 1;
-        while (next_bucket < bucket_count_ && hash_table_[next_bucket] == elements_.end()) {
-            ++next_bucket;
+        // Buckets are contiguous runs of the element list, but runs are not ordered by index
+        auto current = hash_table_[n];
+        while (current != elements_.end() && current->cached_hash_ % bucket_count_ == n) {
+            ++current;
         }
-        return iterator(next_bucket < bucket_count_ ? hash_table_[next_bucket] : elements_.end());
+        return iterator(current);
     }
 
     size_t bucket(const Key& key) const {
@@ -543,6 +722,69 @@ class HashTable {
         return count;
     }
 
+    // Negative-lookup front for miss-heavy workloads: find()/contains() consult a blocked Bloom filter
+    // over the cached hashes first, so most misses cost one cache line instead of a chain walk
+    // The filter is resized on every rehash; erased keys keep their bits until then (false positives only)
+    void enable_bloom_filter(size_t expected_elements = 0,
+                             size_t bits_per_key = BlockedBloomFilter::DEFAULT_BITS_PER_KEY) {
+        bloom_bits_per_key_ = bits_per_key;
+        rebuild_bloom_filter(std::max({expected_elements, size_, rehash_threshold_}));
+    }
+
+    void disable_bloom_filter() noexcept {
+        bloom_.reset();
+    }
+
+    bool has_bloom_filter() const noexcept {
+        return bloom_.has_value();
+    }
+
+    // One pass over the element list: every bucket is a contiguous run, so chain lengths are run lengths
+    // O(size + bucket_count), intended for diagnostics, not for hot paths
+    HashTableStats stats() const {
+        HashTableStats result;
+        result.size = size_;
+        result.bucket_count = bucket_count_;
+        result.load_factor = load_factor();
+        result.rehash_count = rehash_count_;
+
+        size_t used_buckets = 0;
+        size_t longest_bucket = 0;
+
+        for (auto it = elements_.begin(); it != elements_.end();) {
+            const size_t bucket_index = it->cached_hash_ % bucket_count_;
+            size_t chain_length = 0;
+
+            while (it != elements_.end() && it->cached_hash_ % bucket_count_ == bucket_index) {
+                ++chain_length;
+                ++it;
+            }
+
+            ++used_buckets;
+            ++result.chain_histogram[std::min(chain_length, HashTableStats::HISTOGRAM_BINS - 1)];
+            if (chain_length > result.max_chain_length) {
+                result.max_chain_length = chain_length;
+                longest_bucket = bucket_index;
+            }
+        }
+
+        result.empty_buckets = bucket_count_ - used_buckets;
+        result.chain_histogram[0] = result.empty_buckets;
+        result.empty_bucket_fraction = static_cast<float>(result.empty_buckets) / bucket_count_;
+        result.mean_chain_length = used_buckets == 0 ? 0.0f : static_cast<float>(size_) / used_buckets;
+
+        // List node = HashNode + prev/next links, plus the sentinel node
+        result.node_bytes = size_ * NODE_FOOTPRINT + 2 * sizeof(void*);
+        result.bucket_bytes = hash_table_.capacity() * sizeof(ListIterator);
+
+#ifndef NDEBUG
+        if (result.max_chain_length >= DEGENERATE_CHAIN_LENGTH) {
+            warn_degenerate_chain(longest_bucket, result.max_chain_length);
+        }
+#endif
+        return result;
+    }
+
     Hash hash_function() const {
         return hash_;
     }
@@ -564,6 +806,9 @@ class HashTable {
         std::swap(size_, other.size_);
         std::swap(bucket_count_, other.bucket_count_);
         std::swap(rehash_threshold_, other.rehash_threshold_);
+        std::swap(rehash_count_, other.rehash_count_);
+        std::swap(bloom_, other.bloom_);
+        std::swap(bloom_bits_per_key_, other.bloom_bits_per_key_);
         std::swap(equal_, other.equal_);
 
         if (AllocTraits::propagate_on_container_swap::value) {
@@ -572,6 +817,56 @@ class HashTable {
     }
 
   private:
+    // Common tail of both rehash versions
+    void install_buckets(DynamicArray<ListIterator>&& new_table, size_t count) {
+        hash_table_ = std::move(new_table);
+        bucket_count_ = count;
+        // Recalculate rehashing threshold
+        rehash_threshold_ = static_cast<size_t>(bucket_count_ * MAX_LOAD_FACTOR);
+        ++rehash_count_;
+
+        // The table grows => resize the filter for the new threshold (drops bits of erased keys too)
+        if (bloom_) {
+            rebuild_bloom_filter(std::max(rehash_threshold_, bloom_->expected_elements()));
+        }
+    }
+
+    // Runs body(0) .. body(parts - 1) on the scheduler and waits for all of them
+    template <typename Scheduler, typename Body>
+    static void parallel_for(Scheduler& scheduler, size_t parts, Body&& body) {
+        sync::WaitGroup wg;
+        wg.add(parts);
+
+        for (size_t p = 0; p < parts; ++p) {
+            scheduler.submit([&body, &wg, p] {
+                body(p);
+                wg.done();
+            });
+        }
+        wg.wait();
+    }
+
+    void rebuild_bloom_filter(size_t expected_elements) {
+        BlockedBloomFilter filter(expected_elements, bloom_bits_per_key_);
+
+        for (auto it = elements_.begin(); it != elements_.end(); ++it) {
+            filter.insert_hash(it->cached_hash_);
+        }
+        bloom_ = std::move(filter);
+    }
+
+    // Fires once per table: a chain that long means the hash collapses keys (e.g. it returns a constant)
+    void warn_degenerate_chain(size_t bucket_index, size_t chain_length) const {
+        if (degenerate_warned_) {
+            return;
+        }
+        degenerate_warned_ = true;
+
+        std::cerr << "[renn::HashTable] degenerate chain of " << chain_length << " elements"
+                  << " (bucket " << bucket_index << ", size " << size_ << ", buckets " << bucket_count_ << ")."
+                  << " Check the hash function" << std::endl;
+    }
+
     bool is_prime(size_t n) const noexcept {
         if (n <= 1)
             return false;
@@ -614,8 +909,16 @@ class HashTable {
     size_t size_;                            // Number of elements
     size_t bucket_count_{MIN_BUCKET_COUNT};  // Number of buckets
     size_t rehash_threshold_;                // Threshold for rehashing
+    size_t rehash_count_{0};                 // Number of performed rehashes (diagnostics)
+    mutable bool degenerate_warned_{false};
+
+    std::optional<BlockedBloomFilter> bloom_;  // Optional pre-check for find()/contains()
+    size_t bloom_bits_per_key_{BlockedBloomFilter::DEFAULT_BITS_PER_KEY};
 
     static constexpr float MAX_LOAD_FACTOR = 0.8f;
     static constexpr size_t MIN_BUCKET_COUNT = 7;
+    static constexpr size_t DEGENERATE_CHAIN_LENGTH = 32;
+    static constexpr size_t MIN_PARALLEL_CHUNK = 1 << 14;  // Elements per part below which threads don't pay off
+    static constexpr size_t NODE_FOOTPRINT = sizeof(HashNode) + 2 * sizeof(void*);
 };
 }  // namespace renn::containers
@@ -2,18 +2,23 @@
 
 #include "../../../_deps/smhasher-src/src/City.h"
 #include <string>
+#include <string_view>
 #include <type_traits>
 
 template <typename T>
 struct CityHash {
-    size_t operator()(const T& key) const {
+    size_t operator()(const T& key) const noexcept {
         if constexpr (std::is_integral_v<T>) {
             return CityHash64(reinterpret_cast<const char*>(&key), sizeof(T));
         } else if constexpr (std::is_floating_point_v<T>) {
             return CityHash64(reinterpret_cast<const char*>(&key), sizeof(T));
-        } else if constexpr (std::is_same_v<T, std::string>) {
-            return CityHash64(key.c_str(), key.length());
+        } else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) {
+            return CityHash64(key.data(), key.length());
+        } else {
+            // Padding bytes are indeterminate => only types whose bytes are their value can be hashed raw
+            static_assert(std::has_unique_object_representations_v<T>,
+                          "CityHash: type has padding or no byte representation, use WyHash with hash_append");
+            return CityHash64(reinterpret_cast<const char*>(&key), sizeof(T));
         }
-        return 0;
     }
 };
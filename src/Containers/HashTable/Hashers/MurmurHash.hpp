@@ -8,7 +8,7 @@
 
 template<typename T>
 struct MurmurHash3 {
-    size_t operator()(const T& key) const {
+    size_t operator()(const T& key) const noexcept {
         uint64_t hash[2];
         if constexpr (std::is_integral_v<T> || std::is_floating_point_v<T>) {
             MurmurHash3_x64_128(&key, sizeof(T), 0, &hash);
@@ -18,6 +18,8 @@ struct MurmurHash3 {
             auto ptr_value = reinterpret_cast<std::uintptr_t>(key);
             MurmurHash3_x64_128(&ptr_value, sizeof(std::uintptr_t), 0, hash);
         } else {
+            static_assert(std::has_unique_object_representations_v<T>,
+                          "MurmurHash3: type has padding, use WyHash with hash_append");
             MurmurHash3_x64_128(&key, sizeof(T), 0, hash);
         }
         return hash[0];
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace renn::hashing {
+
+// wyhash (Wang Yi, public domain), final version 4
+// Bytes are consumed 16 / 48 at a time through 64x64 -> 128 bit multiplications
+// => one mul + xor per 8 bytes, no table lookups, short keys (<= 16 bytes) take 2 multiplications
+//
+// Scalar on purpose: for the key sizes hash tables see, the 128-bit multiply already keeps the port busy,
+// vector kernels (XXH3) only win on inputs of hundreds of bytes
+
+namespace detail {
+
+inline constexpr uint64_t WY_SECRET[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull,
+};
+
+// Full 128-bit product of a and b, low half in a, high half in b
+inline void wy_mum(uint64_t& a, uint64_t& b) noexcept {
+    const __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+}
+
+inline uint64_t wy_mix(uint64_t a, uint64_t b) noexcept {
+    wy_mum(a, b);
+    return a ^ b;
+}
+
+inline uint64_t wy_read8(const uint8_t* p) noexcept {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    if constexpr (std::endian::native == std::endian::big) {
+        v = __builtin_bswap64(v);
+    }
+    return v;
+}
+
+inline uint64_t wy_read4(const uint8_t* p) noexcept {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    if constexpr (std::endian::native == std::endian::big) {
+        v = __builtin_bswap32(v);
+    }
+    return v;
+}
+
+// 1..3 bytes: first, middle and last byte (they overlap for short inputs)
+inline uint64_t wy_read3(const uint8_t* p, size_t len) noexcept {
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+}
+
+}  // namespace detail
+
+inline uint64_t wyhash(const void* key, size_t len, uint64_t seed = 0) noexcept {
+    using namespace detail;
+
+    const uint8_t* p = static_cast<const uint8_t*>(key);
+    seed ^= wy_mix(seed ^ WY_SECRET[0], WY_SECRET[1]);
+
+    uint64_t a = 0;
+    uint64_t b = 0;
+
+    if (len <= 16) {
+        if (len >= 4) {
+            const size_t shift = (len >> 3) << 2;
+            a = (wy_read4(p) << 32) | wy_read4(p + shift);
+            b = (wy_read4(p + len - 4) << 32) | wy_read4(p + len - 4 - shift);
+        } else if (len > 0) {
+            a = wy_read3(p, len);
+        }
+    } else {
+        size_t i = len;
+
+        if (i >= 48) {
+            // Three independent lanes => three multiplications in flight
+            uint64_t see1 = seed;
+            uint64_t see2 = seed;
+            do {
+                seed = wy_mix(wy_read8(p) ^ WY_SECRET[1], wy_read8(p + 8) ^ seed);
+                see1 = wy_mix(wy_read8(p + 16) ^ WY_SECRET[2], wy_read8(p + 24) ^ see1);
+                see2 = wy_mix(wy_read8(p + 32) ^ WY_SECRET[3], wy_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i >= 48);
+            seed ^= see1 ^ see2;
+        }
+
+        while (i > 16) {
+            seed = wy_mix(wy_read8(p) ^ WY_SECRET[1], wy_read8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+
+        // Last 16 bytes, possibly overlapping the already consumed ones
+        a = wy_read8(p + i - 16);
+        b = wy_read8(p + i - 8);
+    }
+
+    a ^= WY_SECRET[1];
+    b ^= seed;
+    wy_mum(a, b);
+    return wy_mix(a ^ WY_SECRET[0] ^ len, b ^ WY_SECRET[1]);
+}
+
+// Integer fast path: a single 64x64 -> 128 multiply folded with xor
+// Every input bit reaches both halves => fine for power-of-two and prime bucket counts alike
+inline uint64_t mix_integer(uint64_t x, uint64_t seed = 0) noexcept {
+    return detail::wy_mix(x ^ seed ^ detail::WY_SECRET[0], detail::WY_SECRET[1]);
+}
+
+// -----------------------------------------------
+// Composable hashing
+//
+// A type is hashed by feeding its parts into a HashState with hash_append(state, part)
+// Overloads below cover scalars, strings, pairs, tuples, arrays and padding-free trivially copyable types
+// User types add their own overload next to the type (found by ADL):
+//
+//   struct Point { int x; double y; };
+//   void hash_append(renn::hashing::HashState& state, const Point& p) { hash_append(state, p.x, p.y); }
+//
+// hash_value(key) then works for Point, std::pair<Point, std::string>, std::tuple<...>, ...
+
+class HashState {
+  public:
+    explicit HashState(uint64_t seed = 0) noexcept : state_(seed) {}
+
+    void update(uint64_t word) noexcept {
+        state_ = detail::wy_mix(state_ ^ detail::WY_SECRET[2], word ^ detail::WY_SECRET[1]);
+    }
+
+    void update(const void* data, size_t len) noexcept {
+        state_ = wyhash(data, len, state_);
+    }
+
+    uint64_t finish() const noexcept {
+        return detail::wy_mix(state_ ^ detail::WY_SECRET[3], detail::WY_SECRET[0]);
+    }
+
+  private:
+    uint64_t state_;
+};
+
+// Composite overloads call each other (pair of tuples, ...) => declared up front
+template <typename T, typename U>
+void hash_append(HashState& state, const std::pair<T, U>& pair);
+
+template <typename... Ts>
+void hash_append(HashState& state, const std::tuple<Ts...>& tuple);
+
+template <typename T, size_t N>
+void hash_append(HashState& state, const std::array<T, N>& array);
+
+template <typename T>
+    requires std::is_integral_v<T> || std::is_enum_v<T>
+void hash_append(HashState& state, T value) noexcept {
+    if constexpr (std::is_enum_v<T>) {
+        state.update(static_cast<uint64_t>(static_cast<std::underlying_type_t<T>>(value)));
+    } else {
+        state.update(static_cast<uint64_t>(value));
+    }
+}
+
+template <typename T>
+    requires std::is_floating_point_v<T>
+void hash_append(HashState& state, T value) noexcept {
+    // 0.0 == -0.0 => equal keys must hash equally
+    if (value == T{0}) {
+        value = T{0};
+    }
+    if constexpr (sizeof(T) == sizeof(uint64_t)) {
+        state.update(std::bit_cast<uint64_t>(value));
+    } else if constexpr (sizeof(T) == sizeof(uint32_t)) {
+        state.update(std::bit_cast<uint32_t>(value));
+    } else {
+        // long double: only the value bytes, x87 padding is garbage
+        state.update(&value, std::numeric_limits<T>::digits == 64 ? 10 : sizeof(T));
+    }
+}
+
+template <typename T>
+void hash_append(HashState& state, T* pointer) noexcept {
+    state.update(reinterpret_cast<std::uintptr_t>(pointer));
+}
+
+inline void hash_append(HashState& state, std::nullptr_t) noexcept {
+    state.update(uint64_t{0});
+}
+
+// Length goes in as well => ("ab", "c") and ("a", "bc") differ
+template <typename CharT, typename Traits>
+void hash_append(HashState& state, std::basic_string_view<CharT, Traits> str) noexcept {
+    state.update(str.data(), str.size() * sizeof(CharT));
+    state.update(static_cast<uint64_t>(str.size()));
+}
+
+template <typename CharT, typename Traits, typename Alloc>
+void hash_append(HashState& state, const std::basic_string<CharT, Traits, Alloc>& str) noexcept {
+    hash_append(state, std::basic_string_view<CharT, Traits>(str));
+}
+
+template <typename T, typename U>
+void hash_append(HashState& state, const std::pair<T, U>& pair) {
+    hash_append(state, pair.first);
+    hash_append(state, pair.second);
+}
+
+template <typename... Ts>
+void hash_append(HashState& state, const std::tuple<Ts...>& tuple) {
+    std::apply([&state](const auto&... parts) { (hash_append(state, parts), ...); }, tuple);
+}
+
+template <typename T, size_t N>
+void hash_append(HashState& state, const std::array<T, N>& array) {
+    for (const auto& item : array) {
+        hash_append(state, item);
+    }
+}
+
+// Several parts at once: hash_append(state, a, b, c)
+template <typename First, typename Second, typename... Rest>
+void hash_append(HashState& state, const First& first, const Second& second, const Rest&... rest) {
+    hash_append(state, first);
+    hash_append(state, second);
+    (hash_append(state, rest), ...);
+}
+
+namespace detail {
+
+template <typename T>
+concept HashAppendable = requires(HashState& state, const T& value) { hash_append(state, value); };
+
+// Trivially copyable without padding bytes => the object representation is the value, hash it in one go
+template <typename T>
+concept ByteHashable = std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>;
+
+}  // namespace detail
+
+template <typename T>
+    requires detail::HashAppendable<T> || detail::ByteHashable<T>
+uint64_t hash_value(const T& key, uint64_t seed = 0) noexcept {
+    if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+        return mix_integer(static_cast<uint64_t>(key), seed);
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view> && !std::is_pointer_v<T>) {
+        const std::string_view str = key;
+        return wyhash(str.data(), str.size(), seed);
+    } else if constexpr (detail::HashAppendable<T>) {
+        HashState state(seed);
+        hash_append(state, key);
+        return state.finish();
+    } else {
+        return wyhash(&key, sizeof(T), seed);
+    }
+}
+}  // namespace renn::hashing
+
+// Drop-in hasher in the style of CityHash / MurmurHash3, for every type renn::hashing::hash_value accepts
+// Types it doesn't know are a compile error instead of a constant hash
+template <typename T>
+struct WyHash {
+    size_t operator()(const T& key) const noexcept {
+        return static_cast<size_t>(renn::hashing::hash_value(key));
+    }
+};
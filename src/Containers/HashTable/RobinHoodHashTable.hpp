@@ -0,0 +1,550 @@
+#pragma once
+
+#include "../DynamicArray.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace renn::containers {
+
+// Open-addressing hash table with Robin Hood insertion and backward-shift deletion
+//
+// Every slot has one byte of metadata: 0 = empty, otherwise (probe distance + 1)
+// - insert : the element displaces any resident that is closer to its home slot ("takes from the rich")
+//            => probe distances stay short and uniform even at load factor 0.9+
+// - lookup : stops as soon as the resident's distance is smaller than the current probe length,
+//            because our key would have displaced it => misses are cheap
+// - erase  : shifts the following cluster one slot back, no tombstones
+//
+// Keys and values are stored inline in the slot array, no per-element allocation and no cached hash
+
+template <typename Key, typename Value,
+          typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<std::pair<Key, Value>>>
+class RobinHoodHashTable {
+  private:
+    using Slot = std::pair<Key, Value>;
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using SlotAllocator = typename AllocTraits::template rebind_alloc<Slot>;
+    using SlotAllocTraits = std::allocator_traits<SlotAllocator>;
+    using MetaArray = DynamicArray<uint8_t, typename AllocTraits::template rebind_alloc<uint8_t>>;
+
+  public:
+    template <bool is_const>
+    class Iterator {
+      private:
+        using SlotPtr = std::conditional_t<is_const, const Slot*, Slot*>;
+        using ValueRef = std::conditional_t<is_const, const Value&, Value&>;
+
+        SlotPtr slot_;
+        const uint8_t* meta_;
+        const uint8_t* meta_end_;
+
+        void skip_empty() {
+            while (meta_ != meta_end_ && *meta_ == EMPTY) {
+                ++meta_;
+                ++slot_;
+            }
+        }
+
+      public:
+        struct Reference {
+            const Key& first;
+            ValueRef second;
+        };
+
+        struct Arrow {
+            Reference ref_;
+
+            const Reference* operator->() const { return &ref_; }
+        };
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Reference;
+        using difference_type = std::ptrdiff_t;
+        using reference = Reference;
+
+        Iterator(SlotPtr slot, const uint8_t* meta, const uint8_t* meta_end) : slot_(slot), meta_(meta), meta_end_(meta_end) {
+            skip_empty();
+        }
+
+        Reference operator*() const {
+            return Reference{slot_->first, slot_->second};
+        }
+
+        Arrow operator->() const {
+            return Arrow{**this};
+        }
+
+        Iterator& operator++() {
+            ++meta_;
+            ++slot_;
+            skip_empty();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return meta_ == other.meta_;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return meta_ != other.meta_;
+        }
+
+        operator Iterator<true>() const { return Iterator<true>(slot_, meta_, meta_end_); }
+
+        friend class RobinHoodHashTable;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+  public:
+    RobinHoodHashTable() {
+        allocate(MIN_CAPACITY);
+    }
+
+    explicit RobinHoodHashTable(size_t expected_size, float max_load_factor = DEFAULT_MAX_LOAD_FACTOR,
+                                const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                                const Allocator& alloc = Allocator()) : hash_(hash), equal_(equal),
+                                                                        allocator_(alloc),
+                                                                        max_load_factor_(checked_load_factor(max_load_factor)) {
+        allocate(capacity_for(expected_size));
+    }
+
+    RobinHoodHashTable(std::initializer_list<std::pair<const Key, Value>> init) : RobinHoodHashTable(init.size()) {
+        for (const auto& item : init) {
+            emplace(item.first, item.second);
+        }
+    }
+
+    RobinHoodHashTable(const RobinHoodHashTable& other) : hash_(other.hash_),
+                                                          equal_(other.equal_),
+                                                          allocator_(SlotAllocTraits::select_on_container_copy_construction(other.allocator_)),
+                                                          max_load_factor_(other.max_load_factor_) {
+        if (other.capacity_ == 0) {
+            return;  // A moved-from table
+        }
+        allocate(other.capacity_);
+
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (other.meta_[i] != EMPTY) {
+                SlotAllocTraits::construct(allocator_, slots_ + i, other.slots_[i]);
+                meta_[i] = other.meta_[i];
+            }
+        }
+        size_ = other.size_;
+    }
+
+    // The moved-from table is left empty without storage (allocates again on its next insert)
+    RobinHoodHashTable(RobinHoodHashTable&& other) noexcept : hash_(std::move(other.hash_)),
+                                                              equal_(std::move(other.equal_)),
+                                                              allocator_(std::move(other.allocator_)),
+                                                              slots_(other.slots_),
+                                                              meta_(std::move(other.meta_)),
+                                                              capacity_(other.capacity_),
+                                                              size_(other.size_),
+                                                              shift_(other.shift_),
+                                                              max_load_factor_(other.max_load_factor_) {
+        other.slots_ = nullptr;
+        other.capacity_ = 0;
+        other.size_ = 0;
+        other.shift_ = 64;
+    }
+
+    RobinHoodHashTable& operator=(const RobinHoodHashTable& other) {
+        if (this != &other) {
+            RobinHoodHashTable tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    RobinHoodHashTable& operator=(RobinHoodHashTable&& other) noexcept {
+        if (this != &other) {
+            RobinHoodHashTable tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~RobinHoodHashTable() {
+        destroy_all();
+        deallocate();
+    }
+
+    // -----------------------------------------------
+
+    iterator begin() { return iterator(slots_, meta_.begin(), meta_.end()); }
+
+    iterator end() { return iterator(slots_ + capacity_, meta_.end(), meta_.end()); }
+
+    const_iterator begin() const { return const_iterator(slots_, meta_.cbegin(), meta_.cend()); }
+
+    const_iterator end() const { return const_iterator(slots_ + capacity_, meta_.cend(), meta_.cend()); }
+
+    template <typename K, typename V>
+    std::pair<iterator, bool> emplace(K&& key, V&& value) {
+        const size_t found = lookup(key);
+        if (found != NOT_FOUND) {
+            return {iterator_at(found), false};
+        }
+
+        if (size_ + 1 > static_cast<size_t>(capacity_ * max_load_factor_)) {
+            grow();
+        }
+
+        auto placement = find_placement(home_slot(key));
+
+        // A probe sequence outgrows the one-byte distance only on pathological clustering => grow until it fits
+        while (!placement) {
+            if (load_factor() < MIN_OVERFLOW_LOAD_FACTOR) {
+                throw std::overflow_error("RobinHoodHashTable: probe distance overflow, the hash function is degenerate");
+            }
+            grow();
+            placement = find_placement(home_slot(key));
+        }
+
+        const size_t position = place(*placement, std::forward<K>(key), std::forward<V>(value));
+        ++size_;
+        return {iterator_at(position), true};
+    }
+
+    std::pair<iterator, bool> insert(const std::pair<const Key, Value>& kv) {
+        return emplace(kv.first, kv.second);
+    }
+
+    iterator find(const Key& key) {
+        const size_t found = lookup(key);
+        return found == NOT_FOUND ? end() : iterator_at(found);
+    }
+
+    const_iterator find(const Key& key) const {
+        const size_t found = lookup(key);
+        return found == NOT_FOUND ? end() : const_iterator(slots_ + found, meta_.cbegin() + found, meta_.cend());
+    }
+
+    bool contains(const Key& key) const {
+        return lookup(key) != NOT_FOUND;
+    }
+
+    Value& at(const Key& key) {
+        const size_t found = lookup(key);
+
+        if (found == NOT_FOUND)
+            throw std::out_of_range("Key not found");
+
+        return slots_[found].second;
+    }
+
+    const Value& at(const Key& key) const {
+        const size_t found = lookup(key);
+
+        if (found == NOT_FOUND)
+            throw std::out_of_range("Key not found");
+
+        return slots_[found].second;
+    }
+
+    Value& operator[](const Key& key) {
+        return (*emplace(key, Value{}).first).second;
+    }
+
+    bool erase(const Key& key) {
+        const size_t found = lookup(key);
+
+        if (found == NOT_FOUND) {
+            return false;
+        }
+
+        erase_at(found);
+        return true;
+    }
+
+    void clear() noexcept {
+        destroy_all();
+        size_ = 0;
+    }
+
+    void reserve(size_t count) {
+        const size_t capacity = capacity_for(count);
+        if (capacity > capacity_) {
+            rehash(capacity);
+        }
+    }
+
+    size_t size() const noexcept { return size_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+    size_t bucket_count() const noexcept { return capacity_; }
+
+    float load_factor() const noexcept { return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / capacity_; }
+
+    float max_load_factor() const noexcept { return max_load_factor_; }
+
+    // Longest probe sequence currently in the table (diagnostics)
+    size_t max_probe_distance() const noexcept {
+        size_t result = 0;
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (meta_[i] != EMPTY) {
+                result = std::max<size_t>(result, meta_[i] - 1);
+            }
+        }
+        return result;
+    }
+
+    void swap(RobinHoodHashTable& other) noexcept {
+        std::swap(hash_, other.hash_);
+        std::swap(equal_, other.equal_);
+        std::swap(slots_, other.slots_);
+        std::swap(meta_, other.meta_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(size_, other.size_);
+        std::swap(shift_, other.shift_);
+        std::swap(max_load_factor_, other.max_load_factor_);
+
+        if (SlotAllocTraits::propagate_on_container_swap::value) {
+            std::swap(allocator_, other.allocator_);
+        }
+    }
+
+  private:
+    iterator iterator_at(size_t position) {
+        return iterator(slots_ + position, meta_.begin() + position, meta_.end());
+    }
+
+    // Fibonacci hashing: spreads weak hashes (std::hash<int> is the identity) over the high bits
+    size_t home_slot(const Key& key) const {
+        return (hash_(key) * FIBONACCI_MULTIPLIER) >> shift_;
+    }
+
+    size_t lookup(const Key& key) const {
+        if (size_ == 0) {
+            return NOT_FOUND;  // Also covers a moved-from table, which has no slots
+        }
+
+        const size_t mask = capacity_ - 1;
+        size_t position = home_slot(key);
+
+        for (uint8_t distance = 1;; ++distance) {
+            const uint8_t resident = meta_[position];
+
+            // Empty slot or a resident richer than us => the key would have been placed before it
+            if (resident < distance) {
+                return NOT_FOUND;
+            }
+
+            // Only residents with the same distance share our home slot
+            if (resident == distance && equal_(slots_[position].first, key)) {
+                return position;
+            }
+
+            position = (position + 1) & mask;
+
+            if (distance == MAX_DISTANCE) {
+                return NOT_FOUND;
+            }
+        }
+    }
+
+    // Robin Hood keeps every cluster sorted by home slot, so inserting an absent key means:
+    // skip the residents at least as poor as us, then shift the rest of the cluster one slot right
+    // Computed without touching the table => an overflowing insert can be retried after growing
+    struct Placement {
+        size_t position;
+        size_t empty;
+        uint8_t distance;
+    };
+
+    std::optional<Placement> find_placement(size_t home) const noexcept {
+        const size_t mask = capacity_ - 1;
+        size_t position = home;
+        uint8_t distance = 1;
+
+        while (meta_[position] >= distance) {
+            if (distance == MAX_DISTANCE) {
+                return std::nullopt;
+            }
+            position = (position + 1) & mask;
+            ++distance;
+        }
+
+        size_t empty = position;
+        while (meta_[empty] != EMPTY) {
+            // This resident moves one slot further from home
+            if (meta_[empty] == MAX_DISTANCE) {
+                return std::nullopt;
+            }
+            empty = (empty + 1) & mask;
+        }
+
+        return Placement{position, empty, distance};
+    }
+
+    template <typename... Args>
+    size_t place(const Placement& placement, Args&&... args) {
+        const size_t mask = capacity_ - 1;
+
+        for (size_t i = placement.empty; i != placement.position;) {
+            const size_t prev = (i - 1) & mask;
+
+            SlotAllocTraits::construct(allocator_, slots_ + i, std::move(slots_[prev]));
+            SlotAllocTraits::destroy(allocator_, slots_ + prev);
+            meta_[i] = meta_[prev] + 1;
+            meta_[prev] = EMPTY;  // Until refilled => a throwing move can't leave a slot destroyed twice
+
+            i = prev;
+        }
+
+        SlotAllocTraits::construct(allocator_, slots_ + placement.position, std::forward<Args>(args)...);
+        meta_[placement.position] = placement.distance;
+
+        return placement.position;
+    }
+
+    void erase_at(size_t position) {
+        const size_t mask = capacity_ - 1;
+
+        SlotAllocTraits::destroy(allocator_, slots_ + position);
+        meta_[position] = EMPTY;
+
+        // Backward shift: pull the rest of the cluster one step closer to home
+        size_t next = (position + 1) & mask;
+
+        while (meta_[next] > 1) {
+            SlotAllocTraits::construct(allocator_, slots_ + position, std::move(slots_[next]));
+            SlotAllocTraits::destroy(allocator_, slots_ + next);
+            meta_[position] = meta_[next] - 1;
+            meta_[next] = EMPTY;
+
+            position = next;
+            next = (next + 1) & mask;
+        }
+
+        --size_;
+    }
+
+    void grow() {
+        rehash(std::max(capacity_ * 2, MIN_CAPACITY));
+    }
+
+    // The new arrays are filled in a separate table, swapped in once every element is placed
+    // => if a hash or a copy throws, this table is unchanged and the new arrays are freed
+    // Elements are moved only when neither the move nor the hash of a later element can throw, else copied
+    // Placement can't overflow when growing: homes are the top bits of the hash, so the elements keep their
+    // order in the larger table and no probe distance grows
+    void rehash(size_t new_capacity) {
+        RobinHoodHashTable fresh(*this, new_capacity);
+
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (meta_[i] != EMPTY) {
+                auto placement = fresh.find_placement(fresh.home_slot(slots_[i].first));
+
+                if (!placement) {
+                    throw std::overflow_error("RobinHoodHashTable: probe distance overflow, the hash function is degenerate");
+                }
+
+                if constexpr (NOTHROW_REHASH) {
+                    fresh.place(*placement, std::move(slots_[i]));
+                } else {
+                    fresh.place(*placement, std::as_const(slots_[i]));
+                }
+                ++fresh.size_;
+            }
+        }
+
+        swap(fresh);  // 'fresh' now destroys the old (moved-from or copied) elements and frees the old arrays
+    }
+
+    // Empty table with the functors, allocator and load factor of 'like' (what rehash fills)
+    RobinHoodHashTable(const RobinHoodHashTable& like, size_t capacity) : hash_(like.hash_),
+                                                                          equal_(like.equal_),
+                                                                          allocator_(like.allocator_),
+                                                                          max_load_factor_(like.max_load_factor_) {
+        allocate(capacity);
+    }
+
+    void allocate(size_t capacity) {
+        slots_ = SlotAllocTraits::allocate(allocator_, capacity);
+        meta_ = MetaArray(capacity, static_cast<uint8_t>(EMPTY));
+        capacity_ = capacity;
+        shift_ = 64 - log2(capacity);
+    }
+
+    void deallocate() noexcept {
+        if (slots_ != nullptr) {
+            SlotAllocTraits::deallocate(allocator_, slots_, capacity_);
+            slots_ = nullptr;
+        }
+    }
+
+    void destroy_all() noexcept {
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (meta_[i] != EMPTY) {
+                SlotAllocTraits::destroy(allocator_, slots_ + i);
+                meta_[i] = EMPTY;
+            }
+        }
+    }
+
+    size_t capacity_for(size_t count) const noexcept {
+        size_t capacity = MIN_CAPACITY;
+        while (static_cast<size_t>(capacity * max_load_factor_) < count) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    static float checked_load_factor(float load_factor) {
+        if (!(load_factor > 0.0f && load_factor < 1.0f)) {
+            throw std::invalid_argument("RobinHoodHashTable: max load factor must be in (0, 1)");
+        }
+        return load_factor;
+    }
+
+    static size_t log2(size_t n) noexcept {
+        size_t result = 0;
+        while ((size_t{1} << result) < n) {
+            ++result;
+        }
+        return result;
+    }
+
+  private:
+    Hash hash_;
+    KeyEqual equal_;
+    SlotAllocator allocator_;
+
+    Slot* slots_{nullptr};  // Raw storage, a slot is alive iff meta_[i] != EMPTY
+    MetaArray meta_;        // Probe distance + 1 per slot
+
+    size_t capacity_{0};  // Always a power of two
+    size_t size_{0};
+    size_t shift_{64};
+    float max_load_factor_{DEFAULT_MAX_LOAD_FACTOR};
+
+    static constexpr bool NOTHROW_REHASH = std::is_nothrow_move_constructible_v<Slot> &&
+                                           std::is_nothrow_invocable_v<const Hash&, const Key&>;
+
+    static constexpr uint8_t EMPTY = 0;
+    static constexpr uint8_t MAX_DISTANCE = 255;
+    static constexpr size_t MIN_CAPACITY = 8;
+    static constexpr size_t NOT_FOUND = ~size_t{0};
+    static constexpr size_t FIBONACCI_MULTIPLIER = 0x9E3779B97F4A7C15ull;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.9f;
+    static constexpr float MIN_OVERFLOW_LOAD_FACTOR = 0.125f;
+};
+}  // namespace renn::containers
@@ -0,0 +1,334 @@
+#pragma once
+
+#include "HashTable.hpp"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace renn::containers {
+
+// Hash table with inline storage for small sizes
+//
+// Up to N entries live in an inline array and are found by a linear scan with KeyEqual (no hashing at all)
+// => an empty or small table performs no allocation: no List sentinel, no bucket array, no nodes
+// The (N + 1)-th insert moves everything into a heap-allocated HashTable, which is kept until clear()
+//
+// Erase in small mode moves the last entry into the hole => iteration order is not stable
+
+template <typename Key, typename Value, size_t N = 8,
+          typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<std::pair<Key, Value>>>
+class SmallHashTable {
+    static_assert(N > 0, "SmallHashTable needs at least one inline slot");
+
+  private:
+    using Slot = std::pair<Key, Value>;
+    using LargeTable = HashTable<Key, Value, Hash, KeyEqual, Allocator>;
+
+  public:
+    template <bool is_const>
+    class Iterator {
+      private:
+        using SlotPtr = std::conditional_t<is_const, const Slot*, Slot*>;
+        using LargeIt = std::conditional_t<is_const, typename LargeTable::const_iterator, typename LargeTable::iterator>;
+        using ValueRef = std::conditional_t<is_const, const Value&, Value&>;
+
+        SlotPtr small_{nullptr};
+        std::optional<LargeIt> large_;
+
+      public:
+        struct Reference {
+            const Key& first;
+            ValueRef second;
+        };
+
+        struct Arrow {
+            Reference ref_;
+
+            const Reference* operator->() const { return &ref_; }
+        };
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Reference;
+        using difference_type = std::ptrdiff_t;
+        using reference = Reference;
+
+        explicit Iterator(SlotPtr small) : small_(small) {}
+
+        explicit Iterator(LargeIt large) : large_(large) {}
+
+        Reference operator*() const {
+            if (large_) {
+                // Through a non-const copy: HashTable::iterator's const operator-> allocates
+                LargeIt it = *large_;
+                return Reference{it->data_.first, it->data_.second};
+            }
+            return Reference{small_->first, small_->second};
+        }
+
+        Arrow operator->() const {
+            return Arrow{**this};
+        }
+
+        Iterator& operator++() {
+            if (large_) {
+                ++*large_;
+            } else {
+                ++small_;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return large_ ? (other.large_ && *large_ == *other.large_) : (!other.large_ && small_ == other.small_);
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+  public:
+    SmallHashTable() = default;
+
+    explicit SmallHashTable(const Hash& hash, const KeyEqual& equal = KeyEqual(),
+                            const Allocator& alloc = Allocator()) : hash_(hash), equal_(equal), allocator_(alloc) {}
+
+    SmallHashTable(std::initializer_list<std::pair<const Key, Value>> init) {
+        for (const auto& item : init) {
+            emplace(item.first, item.second);
+        }
+    }
+
+    SmallHashTable(const SmallHashTable& other) : hash_(other.hash_), equal_(other.equal_), allocator_(other.allocator_) {
+        if (other.large_) {
+            large_ = std::make_unique<LargeTable>(*other.large_);
+        } else {
+            for (size_t i = 0; i < other.small_size_; ++i) {
+                new (slot(i)) Slot(*other.slot(i));
+                ++small_size_;
+            }
+        }
+    }
+
+    SmallHashTable(SmallHashTable&& other) noexcept : large_(std::move(other.large_)),
+                                                      hash_(std::move(other.hash_)),
+                                                      equal_(std::move(other.equal_)),
+                                                      allocator_(std::move(other.allocator_)) {
+        for (size_t i = 0; i < other.small_size_; ++i) {
+            new (slot(i)) Slot(std::move(*other.slot(i)));
+        }
+        small_size_ = other.small_size_;
+        other.destroy_small();
+    }
+
+    SmallHashTable& operator=(const SmallHashTable& other) {
+        if (this != &other) {
+            SmallHashTable tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    SmallHashTable& operator=(SmallHashTable&& other) noexcept {
+        if (this != &other) {
+            destroy_small();
+
+            hash_ = std::move(other.hash_);
+            equal_ = std::move(other.equal_);
+            allocator_ = std::move(other.allocator_);
+            large_ = std::move(other.large_);
+
+            for (size_t i = 0; i < other.small_size_; ++i) {
+                new (slot(i)) Slot(std::move(*other.slot(i)));
+            }
+            small_size_ = other.small_size_;
+            other.destroy_small();
+        }
+        return *this;
+    }
+
+    ~SmallHashTable() {
+        destroy_small();
+    }
+
+    // -----------------------------------------------
+
+    iterator begin() {
+        return large_ ? iterator(large_->begin()) : iterator(slot(0));
+    }
+
+    iterator end() {
+        return large_ ? iterator(large_->end()) : iterator(slot(small_size_));
+    }
+
+    const_iterator begin() const {
+        return large_ ? const_iterator(std::as_const(*large_).begin()) : const_iterator(slot(0));
+    }
+
+    const_iterator end() const {
+        return large_ ? const_iterator(std::as_const(*large_).end()) : const_iterator(slot(small_size_));
+    }
+
+    template <typename K, typename V>
+    std::pair<iterator, bool> emplace(K&& key, V&& value) {
+        if (large_) {
+            auto [it, inserted] = large_->emplace(std::forward<K>(key), std::forward<V>(value));
+            return {iterator(it), inserted};
+        }
+
+        if (Slot* found = find_small(key)) {
+            return {iterator(found), false};
+        }
+
+        if (small_size_ == N) {
+            grow();
+            auto [it, inserted] = large_->emplace(std::forward<K>(key), std::forward<V>(value));
+            return {iterator(it), inserted};
+        }
+
+        Slot* position = new (slot(small_size_)) Slot(std::forward<K>(key), std::forward<V>(value));
+        ++small_size_;
+        return {iterator(position), true};
+    }
+
+    std::pair<iterator, bool> insert(const std::pair<const Key, Value>& kv) {
+        return emplace(kv.first, kv.second);
+    }
+
+    iterator find(const Key& key) {
+        if (large_) {
+            return iterator(large_->find(key));
+        }
+        Slot* found = find_small(key);
+        return found ? iterator(found) : end();
+    }
+
+    const_iterator find(const Key& key) const {
+        if (large_) {
+            return const_iterator(std::as_const(*large_).find(key));
+        }
+        const Slot* found = const_cast<SmallHashTable*>(this)->find_small(key);
+        return found ? const_iterator(found) : end();
+    }
+
+    bool contains(const Key& key) const {
+        return large_ ? large_->contains(key) : const_cast<SmallHashTable*>(this)->find_small(key) != nullptr;
+    }
+
+    Value& at(const Key& key) {
+        if (large_) {
+            return large_->at(key);
+        }
+
+        Slot* found = find_small(key);
+        if (found == nullptr)
+            throw std::out_of_range("Key not found");
+
+        return found->second;
+    }
+
+    Value& operator[](const Key& key) {
+        return (*emplace(key, Value{}).first).second;
+    }
+
+    bool erase(const Key& key) {
+        if (large_) {
+            const size_t before = large_->size();
+            large_->erase(key);
+            return large_->size() != before;
+        }
+
+        Slot* found = find_small(key);
+        if (found == nullptr) {
+            return false;
+        }
+
+        Slot* last = slot(small_size_ - 1);
+        if (found != last) {
+            *found = std::move(*last);
+        }
+        last->~Slot();
+        --small_size_;
+        return true;
+    }
+
+    // Returns to the inline representation
+    void clear() {
+        large_.reset();
+        destroy_small();
+    }
+
+    size_t size() const noexcept {
+        return large_ ? large_->size() : small_size_;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    // true while the entries are stored inline
+    bool is_small() const noexcept { return !large_; }
+
+    static constexpr size_t inline_capacity() noexcept { return N; }
+
+  private:
+    Slot* slot(size_t i) noexcept {
+        return std::launder(reinterpret_cast<Slot*>(storage_)) + i;
+    }
+
+    const Slot* slot(size_t i) const noexcept {
+        return std::launder(reinterpret_cast<const Slot*>(storage_)) + i;
+    }
+
+    Slot* find_small(const Key& key) {
+        for (size_t i = 0; i < small_size_; ++i) {
+            if (equal_(slot(i)->first, key)) {
+                return slot(i);
+            }
+        }
+        return nullptr;
+    }
+
+    // Moves the inline entries into a freshly allocated HashTable
+    void grow() {
+        auto large = std::make_unique<LargeTable>(GROWN_BUCKET_COUNT, hash_, equal_, allocator_);
+
+        for (size_t i = 0; i < small_size_; ++i) {
+            large->emplace(std::move(slot(i)->first), std::move(slot(i)->second));
+        }
+
+        destroy_small();
+        large_ = std::move(large);
+    }
+
+    void destroy_small() noexcept {
+        for (size_t i = 0; i < small_size_; ++i) {
+            slot(i)->~Slot();
+        }
+        small_size_ = 0;
+    }
+
+  private:
+    static constexpr size_t GROWN_BUCKET_COUNT = N * 4 > 7 ? N * 4 : 7;
+
+    alignas(Slot) unsigned char storage_[N * sizeof(Slot)];
+    size_t small_size_{0};
+    std::unique_ptr<LargeTable> large_;  // Non-null => hashed representation
+
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] KeyEqual equal_;
+    [[no_unique_address]] Allocator allocator_;
+};
+}  // namespace renn::containers
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "../Scheduling/IScheduler.hpp"
+#include "../Sync/WaitGroup.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace renn::containers {
+
+// Allocator for big arrays: huge-page backed anonymous mappings
+//
+// A 2MB page covers 512x the memory of a 4KB one per TLB entry => far fewer TLB misses when scanning
+// or randomly accessing a multi-GB array, and 512x fewer page faults to populate it
+// Every block of at least HUGE_PAGE_SIZE bytes is its own mapping, sized in whole huge pages:
+//   1. MAP_HUGETLB - explicit huge pages, only if the administrator reserved a pool (vm.nr_hugepages)
+//   2. otherwise a 2MB-aligned mapping with MADV_HUGEPAGE => transparent huge pages (THP)
+//      (unless THP is disabled system-wide, then it's still a plain mapping)
+// Smaller blocks come from operator new: a huge page per small array would waste most of it
+//
+// With a scheduler the fresh pages are pre-faulted in parallel before allocate() returns
+// => the first-touch page faults are paid by all workers at once instead of by the first scan
+// (allocate() waits for those tasks => don't allocate from a task of the same scheduler)
+//
+// reallocate() (used by DynamicArray for trivially relocatable T) moves the old pages into the new
+// mapping with mremap instead of copying them; shrinking returns the unused pages with
+// munmap / MADV_DONTNEED (see DynamicArray::shrink_to_fit)
+
+template <typename T>
+class HugePageAllocator {
+  public:
+    using value_type = T;
+
+    static constexpr size_t HUGE_PAGE_SIZE = 2u << 20;
+
+    // Pre-faulting below this is not worth a task
+    static constexpr size_t MIN_PREFAULT_CHUNK = 16u << 20;
+
+    HugePageAllocator() noexcept = default;
+
+    explicit HugePageAllocator(sched::IScheduler& prefault_scheduler) noexcept : scheduler_(&prefault_scheduler) {}
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>& other) noexcept : scheduler_(other.prefault_scheduler()) {}
+
+    sched::IScheduler* prefault_scheduler() const noexcept {
+        return scheduler_;
+    }
+
+    T* allocate(size_t n) {
+        const size_t size = bytes(n);
+        if (!is_mapped(size)) {
+            return static_cast<T*>(::operator new(size, std::align_val_t{alignof(T)}));
+        }
+
+        auto* block = static_cast<std::byte*>(map(mapping_length(size)));
+        prefault(block, mapping_length(size));
+        return reinterpret_cast<T*>(block);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (p == nullptr) {
+            return;
+        }
+
+        const size_t size = n * sizeof(T);
+        if (!is_mapped(size)) {
+            ::operator delete(p, std::align_val_t{alignof(T)});
+            return;
+        }
+#if defined(__linux__)
+        ::munmap(p, mapping_length(size));
+#endif
+    }
+
+    // Moves the first min(old_n, new_n) elements' bytes into a block for new_n elements, frees 'p'
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        if (p == nullptr) {
+            return allocate(new_n);
+        }
+        if (new_n == 0) {
+            deallocate(p, old_n);
+            return nullptr;
+        }
+
+        const size_t old_bytes = bytes(old_n);
+        const size_t new_bytes = bytes(new_n);
+
+#if defined(__linux__)
+        if (is_mapped(old_bytes) && is_mapped(new_bytes)) {
+            const size_t old_length = mapping_length(old_bytes);
+            const size_t new_length = mapping_length(new_bytes);
+            auto* block = reinterpret_cast<std::byte*>(p);
+
+            if (new_length <= old_length) {
+                shrink(block, new_bytes, old_length);
+                return p;
+            }
+
+            // Old pages are moved (page table entries, huge pages stay huge) into the front of an
+            // aligned fresh mapping, only the new tail is faulted in
+            auto* fresh = static_cast<std::byte*>(map(new_length));
+            void* moved = ::mremap(block, old_length, old_length, MREMAP_MAYMOVE | MREMAP_FIXED, fresh);
+            if (moved == MAP_FAILED) {
+                // E.g. from a hugetlb mapping into a THP one
+                std::memcpy(fresh, block, old_bytes);
+                ::munmap(block, old_length);
+            }
+            prefault(fresh + old_length, new_length - old_length);
+            return reinterpret_cast<T*>(fresh);
+        }
+#endif
+
+        T* fresh = allocate(new_n);
+        std::memcpy(static_cast<void*>(fresh), p, std::min(old_bytes, new_bytes));
+        deallocate(p, old_n);
+        return fresh;
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept {
+        return true;  // Any instance frees any block, the scheduler only affects pre-faulting
+    }
+
+  private:
+    static size_t bytes(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T) - HUGE_PAGE_SIZE) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    static bool is_mapped(size_t size) noexcept {
+#if defined(__linux__)
+        return size >= HUGE_PAGE_SIZE;
+#else
+        (void)size;
+        return false;
+#endif
+    }
+
+    static size_t mapping_length(size_t size) noexcept {
+        return (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+
+#if defined(__linux__)
+    static size_t page_size() noexcept {
+        static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    // 'length' is a multiple of HUGE_PAGE_SIZE, the result is HUGE_PAGE_SIZE-aligned
+    static void* map(size_t length) {
+        constexpr int PROTECTION = PROT_READ | PROT_WRITE;
+        constexpr int FLAGS = MAP_PRIVATE | MAP_ANONYMOUS;
+
+#if defined(MAP_HUGETLB)
+        void* huge = ::mmap(nullptr, length, PROTECTION, FLAGS | MAP_HUGETLB, -1, 0);
+        if (huge != MAP_FAILED) {
+            return huge;
+        }
+#endif
+
+        // One extra huge page to cut an aligned window out of: THP only backs aligned 2MB ranges
+        const size_t padded = length + HUGE_PAGE_SIZE;
+        auto* raw = static_cast<std::byte*>(::mmap(nullptr, padded, PROTECTION, FLAGS, -1, 0));
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        const auto address = reinterpret_cast<uintptr_t>(raw);
+        const size_t head = (HUGE_PAGE_SIZE - address % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+        std::byte* aligned = raw + head;
+
+        if (head != 0) {
+            ::munmap(raw, head);
+        }
+        if (padded - head - length != 0) {
+            ::munmap(aligned + length, padded - head - length);
+        }
+
+        ::madvise(aligned, length, MADV_HUGEPAGE);  // Fails only if THP is unsupported => plain pages
+        return aligned;
+    }
+
+    // Keeps [block, block + new_bytes) of a mapping of 'old_length' bytes
+    static void shrink(std::byte* block, size_t new_bytes, size_t old_length) noexcept {
+        const size_t new_length = mapping_length(new_bytes);
+        if (new_length < old_length) {
+            ::munmap(block + new_length, old_length - new_length);
+        }
+
+        // Inside the last huge page: the pages past the data go back to the kernel, the range stays
+        // mapped (they'd be faulted in again as zeros). Splits a transparent huge page; fails
+        // harmlessly on a hugetlb one
+        const size_t used = (new_bytes + page_size() - 1) / page_size() * page_size();
+        if (used < new_length) {
+            ::madvise(block + used, new_length - used, MADV_DONTNEED);
+        }
+    }
+#else
+    static void* map(size_t) {
+        throw std::bad_alloc();
+    }
+
+    static void shrink(std::byte*, size_t, size_t) noexcept {}
+#endif
+
+    // Writes one byte per page of [begin, begin + length), split over the scheduler's workers
+    void prefault(std::byte* begin, size_t length) const {
+        if (scheduler_ == nullptr || length == 0) {
+            return;
+        }
+
+        const size_t workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+        const size_t chunks = std::clamp<size_t>(length / MIN_PREFAULT_CHUNK, 1, workers);
+        // Chunk boundaries on huge pages => no huge page is faulted by two workers
+        const size_t chunk = mapping_length((length + chunks - 1) / chunks);
+
+        if (chunks == 1) {
+            touch_pages(begin, begin + length);
+            return;
+        }
+
+        sync::WaitGroup wg;
+        wg.add((length + chunk - 1) / chunk);
+
+        for (size_t offset = 0; offset < length; offset += chunk) {
+            std::byte* from = begin + offset;
+            std::byte* to = begin + std::min(length, offset + chunk);
+            scheduler_->submit([from, to, &wg] {
+                touch_pages(from, to);
+                wg.done();
+            });
+        }
+        wg.wait();
+    }
+
+    static void touch_pages(std::byte* from, std::byte* to) noexcept {
+#if defined(__linux__)
+        const size_t step = page_size();
+#else
+        const size_t step = 4096;
+#endif
+        for (volatile std::byte* page = from; page < to; page += step) {
+            *page = std::byte{0};  // The memory is fresh (zero) => only the fault matters
+        }
+    }
+
+  private:
+    sched::IScheduler* scheduler_{nullptr};
+};
+}  // namespace renn::containers
@@ -0,0 +1,427 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace renn::containers {
+
+// Intrusive doubly linked list: the links live inside the elements (a hook member), the list allocates nothing
+//
+// struct Timer {
+//     IntrusiveListHook<> hook;
+//     ...
+// };
+// IntrusiveList<Timer, &Timer::hook> timers;
+// timers.push_back(timer);   // Links 'timer' in place, it must outlive its membership
+// timers.erase(timer);       // O(1) by reference, no search
+//
+// The list never owns the elements: clear() / the destructor only unlink them
+// An element is in at most one list per hook (a second hook member => a second list)
+//
+// LinkMode::AUTO_UNLINK hooks unlink themselves when their element is destroyed, so an object may die while
+// still linked (e.g. a waiter that times out). The list can't see that happening => it keeps no size counter,
+// size() walks the list
+
+enum class LinkMode {
+    NORMAL,
+    AUTO_UNLINK,
+};
+
+namespace detail {
+
+struct IntrusiveLinks {
+    IntrusiveLinks* prev{nullptr};
+    IntrusiveLinks* next{nullptr};
+
+    bool is_linked() const noexcept {
+        return next != nullptr;
+    }
+
+    void link_before(IntrusiveLinks* position) noexcept {
+        prev = position->prev;
+        next = position;
+        position->prev->next = this;
+        position->prev = this;
+    }
+
+    void unlink() noexcept {
+        prev->next = next;
+        next->prev = prev;
+        prev = nullptr;
+        next = nullptr;
+    }
+};
+
+}  // namespace detail
+
+template <LinkMode MODE = LinkMode::NORMAL>
+class IntrusiveListHook : private detail::IntrusiveLinks {
+  public:
+    static constexpr LinkMode MODE_VALUE = MODE;
+
+    IntrusiveListHook() = default;
+
+    // A copy of a linked object is a new object => it starts unlinked, the original stays where it was
+    IntrusiveListHook(const IntrusiveListHook&) noexcept {}
+
+    IntrusiveListHook& operator=(const IntrusiveListHook&) noexcept {
+        return *this;
+    }
+
+    ~IntrusiveListHook() {
+        if constexpr (MODE == LinkMode::AUTO_UNLINK) {
+            unlink();
+        }
+    }
+
+    bool is_linked() const noexcept {
+        return IntrusiveLinks::is_linked();
+    }
+
+    // Only auto-unlink hooks may leave their list behind its back (a NORMAL list counts its elements)
+    void unlink() noexcept
+        requires(MODE == LinkMode::AUTO_UNLINK)
+    {
+        if (is_linked()) {
+            IntrusiveLinks::unlink();
+        }
+    }
+
+  private:
+    template <typename, auto>
+    friend class IntrusiveList;
+};
+
+template <typename T, auto HOOK>
+class IntrusiveList {
+  private:
+    using Links = detail::IntrusiveLinks;
+    using Hook = std::remove_cvref_t<decltype(std::declval<T&>().*HOOK)>;
+
+    static_assert(std::is_same_v<Hook, IntrusiveListHook<Hook::MODE_VALUE>>,
+                  "HOOK must point to an IntrusiveListHook member of T");
+
+    static constexpr bool COUNTED = Hook::MODE_VALUE != LinkMode::AUTO_UNLINK;
+
+    static Links* links_of(T& value) noexcept {
+        return static_cast<Links*>(std::addressof(value.*HOOK));
+    }
+
+    // Offset of the hook inside T, from a T-sized buffer (T need not be default constructible)
+    static T* owner_of(Links* links) noexcept {
+        static const std::ptrdiff_t offset = [] {
+            alignas(T) static unsigned char probe[sizeof(T)];
+            T* object = reinterpret_cast<T*>(probe);
+            return reinterpret_cast<unsigned char*>(std::addressof(object->*HOOK)) - probe;
+        }();
+        return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(static_cast<Hook*>(links)) - offset);
+    }
+
+  public:
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+
+    template <bool is_const>
+    class Iterator {
+      public:
+        using value_type = std::conditional_t<is_const, const T, T>;
+        using reference = std::conditional_t<is_const, const T&, T&>;
+        using pointer = std::conditional_t<is_const, const T*, T*>;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+
+        explicit Iterator(Links* node) : node_(node) {}
+
+        reference operator*() const {
+            return *owner_of(node_);
+        }
+
+        pointer operator->() const {
+            return owner_of(node_);
+        }
+
+        Iterator& operator++() {
+            node_ = node_->next;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator tmp = *this;
+            node_ = node_->next;
+            return tmp;
+        }
+
+        Iterator& operator--() {
+            node_ = node_->prev;
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator tmp = *this;
+            node_ = node_->prev;
+            return tmp;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return node_ == other.node_;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return node_ != other.node_;
+        }
+
+        operator Iterator<true>() const {
+            return Iterator<true>(node_);
+        }
+
+      private:
+        friend class IntrusiveList;
+
+        Links* node_{nullptr};
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    IntrusiveList() noexcept {
+        sentinel_.prev = &sentinel_;
+        sentinel_.next = &sentinel_;
+    }
+
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+    IntrusiveList(IntrusiveList&& other) noexcept : IntrusiveList() {
+        splice(end(), other);
+    }
+
+    IntrusiveList& operator=(IntrusiveList&& other) noexcept {
+        if (this != &other) {
+            clear();
+            splice(end(), other);
+        }
+        return *this;
+    }
+
+    ~IntrusiveList() {
+        clear();
+    }
+
+    iterator begin() noexcept {
+        return iterator(sentinel_.next);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(sentinel_.next);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(&sentinel_);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(const_cast<Links*>(&sentinel_));
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    // Iterator to an element known to be in this list, O(1)
+    iterator iterator_to(T& value) noexcept {
+        return iterator(links_of(value));
+    }
+
+    const_iterator iterator_to(const T& value) const noexcept {
+        return const_iterator(links_of(const_cast<T&>(value)));
+    }
+
+    void push_back(T& value) {
+        insert(end(), value);
+    }
+
+    void push_front(T& value) {
+        insert(begin(), value);
+    }
+
+    void pop_back() {
+        erase(--end());
+    }
+
+    void pop_front() {
+        erase(begin());
+    }
+
+    T& front() {
+        if (empty()) {
+            throw std::out_of_range("List is empty!");
+        }
+        return *begin();
+    }
+
+    const T& front() const {
+        if (empty()) {
+            throw std::out_of_range("List is empty!");
+        }
+        return *begin();
+    }
+
+    T& back() {
+        if (empty()) {
+            throw std::out_of_range("List is empty!");
+        }
+        return *--end();
+    }
+
+    const T& back() const {
+        if (empty()) {
+            throw std::out_of_range("List is empty!");
+        }
+        return *--end();
+    }
+
+    // Links 'value' before 'position'; it must not be in a list already (through this hook)
+    iterator insert(const_iterator position, T& value) {
+        Links* links = links_of(value);
+        if (links->is_linked()) {
+            throw std::logic_error("Element is already linked");
+        }
+        links->link_before(position.node_);
+        if constexpr (COUNTED) {
+            ++size_;
+        }
+        return iterator(links);
+    }
+
+    // Unlinks the element at 'position', returns the next one
+    iterator erase(const_iterator position) {
+        if (position == end()) {
+            throw std::out_of_range("Can't erase end()");
+        }
+        Links* next = position.node_->next;
+        position.node_->unlink();
+        if constexpr (COUNTED) {
+            --size_;
+        }
+        return iterator(next);
+    }
+
+    // Unlinks an element of this list by reference, O(1)
+    void erase(T& value) {
+        erase(iterator_to(value));
+    }
+
+    void clear() noexcept {
+        Links* node = sentinel_.next;
+        while (node != &sentinel_) {
+            Links* next = node->next;
+            node->prev = nullptr;
+            node->next = nullptr;
+            node = next;
+        }
+        sentinel_.prev = &sentinel_;
+        sentinel_.next = &sentinel_;
+        if constexpr (COUNTED) {
+            size_ = 0;
+        }
+    }
+
+    // Moves all of 'other' before 'position', O(1)
+    void splice(const_iterator position, IntrusiveList& other) noexcept {
+        if (other.empty() || &other == this) {
+            return;
+        }
+        if constexpr (COUNTED) {
+            size_ += std::exchange(other.size_, 0);
+        }
+        relink(position.node_, other.sentinel_.next, &other.sentinel_);
+    }
+
+    // Moves the element at 'it' of 'other' (may be this list) before 'position', O(1)
+    void splice(const_iterator position, IntrusiveList& other, const_iterator it) noexcept {
+        Links* node = it.node_;
+        if (node == position.node_ || node->next == position.node_) {
+            return;
+        }
+        if constexpr (COUNTED) {
+            --other.size_;
+            ++size_;
+        }
+        relink(position.node_, node, node->next);
+    }
+
+    // Moves [first, last) of 'other' before 'position' (not inside the range)
+    // O(1) within a list or for auto-unlink lists, otherwise O(distance) to keep the sizes
+    void splice(const_iterator position, IntrusiveList& other, const_iterator first, const_iterator last) noexcept {
+        if (first == last) {
+            return;
+        }
+        if constexpr (COUNTED) {
+            if (&other != this) {
+                const size_t moved = static_cast<size_t>(std::distance(first, last));
+                other.size_ -= moved;
+                size_ += moved;
+            }
+        }
+        relink(position.node_, first.node_, last.node_);
+    }
+
+    size_t size() const noexcept {
+        if constexpr (COUNTED) {
+            return size_;
+        } else {
+            return static_cast<size_t>(std::distance(begin(), end()));
+        }
+    }
+
+    bool empty() const noexcept {
+        return sentinel_.next == &sentinel_;
+    }
+
+  private:
+    // Cuts [first, last) out of its chain and links it before 'position'
+    static void relink(Links* position, Links* first, Links* last) noexcept {
+        Links* tail = last->prev;
+        first->prev->next = last;
+        last->prev = first->prev;
+
+        first->prev = position->prev;
+        tail->next = position;
+        position->prev->next = first;
+        position->prev = tail;
+    }
+
+  private:
+    Links sentinel_;  // Inside the list object => moving the list re-points the end elements at the new one
+    size_t size_{0};  // Unused for auto-unlink hooks
+};
+}  // namespace renn::containers
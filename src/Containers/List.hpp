@@ -1,10 +1,12 @@
 #pragma once
 
 #include <cstddef>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
 
 namespace renn::containers {
 
@@ -336,6 +338,165 @@ class List {
         }
     }
 
+    // Moves the node pointed by 'it' from 'other' before 'position'
+    // Nodes are relinked, not copied => iterators to the moved element stay valid
+    // 'other' may be *this
+    void splice(iterator position, List& other, iterator it) {
+        BaseNode* node = it.node_;
+
+        if (node == position.node_ || node->next == position.node_) {
+            return;
+        }
+
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+
+        node->prev = position.node_->prev;
+        node->next = position.node_;
+
+        position.node_->prev->next = node;
+        position.node_->prev = node;
+
+        if (&other != this) {
+            --other.size_;
+            ++size_;
+        }
+    }
+
+    // Moves all of 'other' before 'position', O(1)
+    void splice(iterator position, List& other) {
+        if (&other == this || other.empty()) {
+            return;
+        }
+        transfer(position.node_, other.head_->next, other.head_);
+        size_ += std::exchange(other.size_, 0);
+    }
+
+    // Moves [first, last) of 'other' before 'position' (which must not be inside the range)
+    // O(1) within one list, O(distance) from another list to keep both sizes
+    void splice(iterator position, List& other, iterator first, iterator last) {
+        if (first == last) {
+            return;
+        }
+        if (&other != this) {
+            const size_t moved = static_cast<size_t>(std::distance(first, last));
+            other.size_ -= moved;
+            size_ += moved;
+        }
+        transfer(position.node_, first.node_, last.node_);
+    }
+
+    // Merges the sorted 'other' into this sorted list in one linear pass, relinking its nodes (no T is moved)
+    // Stable: equal elements of *this come first. 'other' ends up empty
+    template <typename Compare = std::less<>>
+    void merge(List& other, Compare comp = Compare{}) {
+        if (&other == this) {
+            return;
+        }
+
+        BaseNode* a = head_->next;
+        BaseNode* b = other.head_->next;
+        while (b != other.head_) {
+            if (a == head_) {
+                // The rest of 'other' is not less than anything here
+                transfer(head_, b, other.head_);
+                size_ += std::exchange(other.size_, 0);
+                return;
+            }
+            if (comp(value_of(b), value_of(a))) {
+                BaseNode* next = b->next;
+                transfer(a, b, next);
+                --other.size_;
+                ++size_;
+                b = next;
+            } else {
+                a = a->next;
+            }
+        }
+    }
+
+    // Stable bottom-up merge sort on the links: nodes are relinked, no T is moved or copied
+    // => iterators and references stay valid and follow their elements
+    //
+    // Works on the 'next' chain only (prev pointers are rebuilt in one pass at the end) and keeps
+    // runs[i] = a sorted run of 2^i nodes, like a binary counter: each new node is merged with the runs
+    // built just before it, which are still in cache, instead of merging whole-list passes of width 1, 2, 4...
+    // If comp throws, the list keeps all its elements in an unspecified order
+    template <typename Compare = std::less<>>
+    void sort(Compare comp = Compare{}) {
+        if (size_ < 2) {
+            return;
+        }
+
+        static constexpr size_t MAX_RUNS = 64;
+        BaseNode* runs[MAX_RUNS] = {};
+
+        BaseNode* rest = head_->next;
+        head_->prev->next = nullptr;
+
+        try {
+            while (rest != nullptr) {
+                BaseNode* run = rest;
+                rest = rest->next;
+                run->next = nullptr;
+
+                size_t i = 0;
+                for (; runs[i] != nullptr; ++i) {
+                    merge_chains(runs[i], run, comp);  // runs[i] holds the earlier elements
+                    run = std::exchange(runs[i], nullptr);
+                }
+                runs[i] = run;
+            }
+
+            for (size_t i = 1; i < MAX_RUNS; ++i) {
+                if (runs[i - 1] == nullptr) {
+                    continue;
+                }
+                BaseNode* later = std::exchange(runs[i - 1], nullptr);
+                if (runs[i] == nullptr) {
+                    runs[i] = later;
+                } else {
+                    merge_chains(runs[i], later, comp);
+                }
+            }
+        } catch (...) {
+            // Every node is in runs[] or in 'rest' => chain them back together
+            BaseNode* chain = rest;
+            for (BaseNode* run : runs) {
+                if (run != nullptr) {
+                    BaseNode* last = run;
+                    while (last->next != nullptr) {
+                        last = last->next;
+                    }
+                    last->next = chain;
+                    chain = run;
+                }
+            }
+            restore_links(chain);
+            throw;
+        }
+
+        restore_links(runs[MAX_RUNS - 1]);
+    }
+
+    // Rebuilds the links from 'order', a permutation of all size() nodes: order[i] becomes the i-th element
+    // Only the nodes in [first, last) (and the sentinel's ends) are written
+    // => disjoint ranges covering [0, size()) may be relinked concurrently
+    void relink_range(const iterator* order, size_t first, size_t last) noexcept {
+        for (size_t i = first; i < last; ++i) {
+            BaseNode* node = order[i].node_;
+            node->prev = i == 0 ? head_ : order[i - 1].node_;
+            node->next = i + 1 == size_ ? head_ : order[i + 1].node_;
+        }
+
+        if (first == 0 && last > 0) {
+            head_->next = order[0].node_;
+        }
+        if (last == size_ && last > first) {
+            head_->prev = order[size_ - 1].node_;
+        }
+    }
+
     iterator insert(iterator position, const T& value) {
         return emplace(position, value);
     }
@@ -343,5 +504,72 @@ class List {
     iterator insert(iterator position, T&& value) {
         return emplace(position, std::move(value));
     }
+
+  private:
+    static T& value_of(BaseNode* node) {
+        return static_cast<Node*>(node)->data_;
+    }
+
+    // Cuts [first, last) out of its list and links it before 'position'
+    static void transfer(BaseNode* position, BaseNode* first, BaseNode* last) noexcept {
+        BaseNode* tail = last->prev;
+        first->prev->next = last;
+        last->prev = first->prev;
+
+        first->prev = position->prev;
+        tail->next = position;
+        position->prev->next = first;
+        position->prev = tail;
+    }
+
+    // Merges the null-terminated 'next' chain 'from' into 'into', ties keep 'into' first
+    // If comp throws, 'into' still holds the nodes of both chains
+    template <typename Compare>
+    static void merge_chains(BaseNode*& into, BaseNode* from, Compare& comp) {
+        BaseNode head;
+        BaseNode* tail = &head;
+        BaseNode* a = into;
+        try {
+            while (a != nullptr && from != nullptr) {
+                // The taken chain's next-but-one node is the next miss on that side => start it now
+                if (comp(value_of(from), value_of(a))) {
+                    tail->next = from;
+                    from = from->next;
+                    if (from != nullptr) {
+                        __builtin_prefetch(from->next);
+                    }
+                } else {
+                    tail->next = a;
+                    a = a->next;
+                    if (a != nullptr) {
+                        __builtin_prefetch(a->next);
+                    }
+                }
+                tail = tail->next;
+            }
+        } catch (...) {
+            tail->next = a;
+            while (tail->next != nullptr) {
+                tail = tail->next;
+            }
+            tail->next = from;
+            into = head.next;
+            throw;
+        }
+        tail->next = a != nullptr ? a : from;
+        into = head.next;
+    }
+
+    // Links the null-terminated 'next' chain of all size() nodes back into the circular list
+    void restore_links(BaseNode* chain) noexcept {
+        BaseNode* prev = head_;
+        for (BaseNode* node = chain; node != nullptr; node = node->next) {
+            node->prev = prev;
+            prev->next = node;
+            prev = node;
+        }
+        prev->next = head_;
+        head_->prev = prev;
+    }
 };
 }  // namespace renn::containers
@@ -0,0 +1,389 @@
+#pragma once
+
+#include "DynamicArray.hpp"
+#include "HashTable/HashTable.hpp"
+#include "List.hpp"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace renn::containers {
+
+enum class EvictionPolicy {
+    // Exact recency order: every hit relinks the entry to the front of the list
+    Lru,
+
+    // Second chance: a hit only sets the entry's reference bit, the list is never reordered
+    // Eviction sweeps a hand over the ring, clearing bits until it finds an unreferenced entry
+    // => hits are read-only for the list and may run under a shared lock (see ShardedLruCache)
+    Clock,
+};
+
+struct CacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t size = 0;
+    size_t weight = 0;
+};
+
+// Every entry costs 1 => the capacity bounds the number of entries
+struct UnitWeight {
+    template <typename K, typename V>
+    size_t operator()(const K&, const V&) const noexcept {
+        return 1;
+    }
+};
+
+// Bounded cache: HashTable<Key, List iterator> index over a List of entries
+// The bound is on the total weight of the entries, given by Weigher(key, value)
+// Not thread-safe, see ShardedLruCache
+
+template <typename Key, typename Value,
+          typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+          typename Weigher = UnitWeight>
+class LruCache {
+  private:
+    struct Entry {
+        Key key_;
+        Value value_;
+        size_t weight_;
+        mutable std::atomic<bool> referenced_{false};  // Clock only, may be set under a shared lock
+
+        template <typename K, typename V>
+        Entry(K&& key, V&& value, size_t weight) : key_(std::forward<K>(key)), value_(std::forward<V>(value)), weight_(weight) {}
+    };
+
+    using EntryList = List<Entry>;
+    using EntryIterator = typename EntryList::iterator;
+    using Index = HashTable<Key, EntryIterator, Hash, KeyEqual>;
+
+  public:
+    explicit LruCache(size_t capacity, EvictionPolicy policy = EvictionPolicy::Lru,
+                      const Weigher& weigher = Weigher()) : weigher_(weigher),
+                                                            capacity_(capacity),
+                                                            policy_(policy) {
+        if (capacity == 0) {
+            throw std::invalid_argument("LruCache: capacity must be positive");
+        }
+        hand_ = entries_.end();
+    }
+
+    LruCache(const LruCache&) = delete;
+    LruCache& operator=(const LruCache&) = delete;
+
+    ~LruCache() = default;
+
+    // Returns nullptr on a miss
+    // The pointer stays valid until the entry is evicted or erased
+    Value* get(const Key& key) {
+        auto it = index_.find(key);
+
+        if (it == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+
+        ++hits_;
+        EntryIterator entry = it->data_.second;
+        touch(entry);
+        return &entry->value_;
+    }
+
+    // Lookup without counting and without reordering
+    // With mark_referenced the Clock reference bit is set, which is safe under a shared lock
+    const Value* peek(const Key& key, bool mark_referenced = false) const {
+        auto it = index_.find(key);
+
+        if (it == index_.end()) {
+            return nullptr;
+        }
+
+        EntryIterator entry = it->data_.second;
+        if (mark_referenced && policy_ == EvictionPolicy::Clock) {
+            entry->referenced_.store(true, std::memory_order_relaxed);
+        }
+        return &entry->value_;
+    }
+
+    bool contains(const Key& key) const {
+        return index_.contains(key);
+    }
+
+    // Inserts or overwrites, then evicts until the total weight fits the capacity
+    // Returns false (and stores nothing) if the entry alone is heavier than the capacity
+    template <typename K, typename V>
+    bool put(K&& key, V&& value) {
+        const size_t weight = weigher_(key, value);
+
+        if (weight > capacity_) {
+            erase(key);
+            return false;
+        }
+
+        auto it = index_.find(key);
+
+        if (it != index_.end()) {
+            EntryIterator entry = it->data_.second;
+            weight_ = weight_ - entry->weight_ + weight;
+            entry->value_ = std::forward<V>(value);
+            entry->weight_ = weight;
+            touch(entry);
+        } else {
+            EntryIterator entry = entries_.emplace(insert_position(), std::forward<K>(key), std::forward<V>(value), weight);
+            index_.emplace(entry->key_, entry);
+            weight_ += weight;
+        }
+
+        while (weight_ > capacity_) {
+            evict_one();
+        }
+        return true;
+    }
+
+    bool erase(const Key& key) {
+        auto it = index_.find(key);
+
+        if (it == index_.end()) {
+            return false;
+        }
+
+        EntryIterator entry = it->data_.second;
+        index_.erase(it);
+        remove(entry);
+        return true;
+    }
+
+    void clear() {
+        index_.clear();
+        entries_.clear();
+        hand_ = entries_.end();
+        weight_ = 0;
+    }
+
+    size_t size() const noexcept { return index_.size(); }
+
+    bool empty() const noexcept { return index_.empty(); }
+
+    size_t capacity() const noexcept { return capacity_; }
+
+    size_t weight() const noexcept { return weight_; }
+
+    EvictionPolicy policy() const noexcept { return policy_; }
+
+    CacheStats stats() const noexcept {
+        return CacheStats{hits_, misses_, evictions_, size(), weight_};
+    }
+
+  private:
+    void touch(EntryIterator entry) {
+        if (policy_ == EvictionPolicy::Lru) {
+            entries_.splice(entries_.begin(), entries_, entry);
+        } else {
+            entry->referenced_.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // Lru : new entries are the most recent => front
+    // Clock : new entries go right behind the hand => examined last
+    EntryIterator insert_position() {
+        return policy_ == EvictionPolicy::Lru ? entries_.begin() : hand_;
+    }
+
+    void evict_one() {
+        EntryIterator victim;
+
+        if (policy_ == EvictionPolicy::Lru) {
+            victim = --entries_.end();
+        } else {
+            // Terminates: every pass clears the bits it skips
+            for (;;) {
+                if (hand_ == entries_.end()) {
+                    hand_ = entries_.begin();
+                }
+                if (!hand_->referenced_.exchange(false, std::memory_order_relaxed)) {
+                    break;
+                }
+                ++hand_;
+            }
+            victim = hand_;
+        }
+
+        index_.erase(victim->key_);
+        remove(victim);
+        ++evictions_;
+    }
+
+    void remove(EntryIterator entry) {
+        weight_ -= entry->weight_;
+
+        if (entry == hand_) {
+            hand_ = entries_.erase(entry);
+        } else {
+            entries_.erase(entry);
+        }
+    }
+
+  private:
+    EntryList entries_;
+    Index index_;
+    Weigher weigher_;
+    EntryIterator hand_;  // Clock hand, entries_.end() means "wrap to the beginning"
+
+    size_t capacity_;
+    size_t weight_{0};
+    EvictionPolicy policy_;
+
+    size_t hits_{0};
+    size_t misses_{0};
+    size_t evictions_{0};
+};
+
+// Concurrent cache: the key space is split over independently locked LruCache shards
+// Clock hits take only a shared lock (they set a reference bit), Lru hits need the exclusive one
+// get() returns a copy of the value, since the entry may be evicted once the lock is released
+
+template <typename Key, typename Value,
+          typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+          typename Weigher = UnitWeight>
+class ShardedLruCache {
+  private:
+    using Cache = LruCache<Key, Value, Hash, KeyEqual, Weigher>;
+
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t DEFAULT_SHARD_COUNT = 16;
+    static constexpr size_t FIBONACCI_MULTIPLIER = 0x9E3779B97F4A7C15ull;
+
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        mutable std::shared_mutex mutex_;
+        Cache cache_;
+
+        // Hits and misses served under the shared lock
+        std::atomic<size_t> shared_hits_{0};
+        std::atomic<size_t> shared_misses_{0};
+
+        Shard(size_t capacity, EvictionPolicy policy, const Weigher& weigher) : cache_(capacity, policy, weigher) {}
+    };
+
+  public:
+    // shard_count is rounded up to a power of two, then down to at most 'capacity' shards
+    // The shard capacities add up to 'capacity': an equal share each, the first capacity % shards get one more
+    explicit ShardedLruCache(size_t capacity, size_t shard_count = DEFAULT_SHARD_COUNT,
+                             EvictionPolicy policy = EvictionPolicy::Clock,
+                             const Weigher& weigher = Weigher()) : capacity_(capacity), policy_(policy) {
+        while ((size_t{1} << shard_bits_) < shard_count) {
+            ++shard_bits_;
+        }
+        while (shard_bits_ > 0 && (size_t{1} << shard_bits_) > capacity) {
+            --shard_bits_;  // Every shard holds at least one entry
+        }
+
+        const size_t shards = size_t{1} << shard_bits_;
+        const size_t per_shard = capacity / shards;
+        const size_t remainder = capacity % shards;
+
+        shards_.reserve(shards);
+        for (size_t i = 0; i < shards; ++i) {
+            shards_.push_back(std::make_unique<Shard>(per_shard + (i < remainder ? 1 : 0), policy, weigher));
+        }
+    }
+
+    ShardedLruCache(const ShardedLruCache&) = delete;
+    ShardedLruCache& operator=(const ShardedLruCache&) = delete;
+
+    std::optional<Value> get(const Key& key) {
+        Shard& shard = shard_for(key);
+
+        if (policy_ == EvictionPolicy::Clock) {
+            std::shared_lock lock(shard.mutex_);
+            const Value* value = shard.cache_.peek(key, /*mark_referenced=*/true);
+
+            if (value == nullptr) {
+                shard.shared_misses_.fetch_add(1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+            shard.shared_hits_.fetch_add(1, std::memory_order_relaxed);
+            return *value;
+        }
+
+        std::unique_lock lock(shard.mutex_);
+        Value* value = shard.cache_.get(key);
+
+        if (value == nullptr) {
+            return std::nullopt;
+        }
+        return *value;
+    }
+
+    template <typename K, typename V>
+    bool put(K&& key, V&& value) {
+        Shard& shard = shard_for(key);
+        std::unique_lock lock(shard.mutex_);
+        return shard.cache_.put(std::forward<K>(key), std::forward<V>(value));
+    }
+
+    bool erase(const Key& key) {
+        Shard& shard = shard_for(key);
+        std::unique_lock lock(shard.mutex_);
+        return shard.cache_.erase(key);
+    }
+
+    bool contains(const Key& key) const {
+        Shard& shard = shard_for(key);
+        std::shared_lock lock(shard.mutex_);
+        return shard.cache_.contains(key);
+    }
+
+    void clear() {
+        for (auto& shard : shards_) {
+            std::unique_lock lock(shard->mutex_);
+            shard->cache_.clear();
+        }
+    }
+
+    // Approximate under concurrent updates: shards are summed one at a time
+    CacheStats stats() const {
+        CacheStats total;
+
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            const Shard& shard = *shards_[i];
+            std::shared_lock lock(shard.mutex_);
+            CacheStats stats = shard.cache_.stats();
+
+            total.hits += stats.hits + shard.shared_hits_.load(std::memory_order_relaxed);
+            total.misses += stats.misses + shard.shared_misses_.load(std::memory_order_relaxed);
+            total.evictions += stats.evictions;
+            total.size += stats.size;
+            total.weight += stats.weight;
+        }
+        return total;
+    }
+
+    size_t shard_count() const noexcept { return shards_.size(); }
+
+    size_t capacity() const noexcept { return capacity_; }
+
+  private:
+    Shard& shard_for(const Key& key) const {
+        if (shard_bits_ == 0) {
+            return *shards_[0];
+        }
+        // High bits of the mixed hash, the shard's own index uses the low ones
+        const size_t mixed = hash_(key) * FIBONACCI_MULTIPLIER;
+        return *shards_[mixed >> (64 - shard_bits_)];
+    }
+
+  private:
+    Hash hash_;
+    DynamicArray<std::unique_ptr<Shard>> shards_;
+    size_t shard_bits_{0};
+    size_t capacity_;
+    EvictionPolicy policy_;
+};
+}  // namespace renn::containers
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace renn::containers {
+
+// Allocator with a reallocate() hook, picked up by DynamicArray for trivially relocatable T
+//
+// Small blocks come from malloc and grow with realloc (in place when the next chunk is free)
+// Blocks of at least MREMAP_THRESHOLD bytes are private anonymous mappings and grow with mremap
+// => the kernel moves page table entries instead of copying, growing a multi-GB array costs
+//    about as much as growing a small one
+// (glibc's malloc does mmap big chunks too, but its threshold adapts upwards to 32MB after frees,
+//  so whether a given realloc copies would depend on the allocation history)
+//
+// The bytes are relocated, never constructed or destroyed => only for trivially relocatable T
+
+template <typename T>
+class MallocAllocator {
+  public:
+    using value_type = T;
+
+    static constexpr size_t MREMAP_THRESHOLD = 1u << 20;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "MallocAllocator: over-aligned types are not supported");
+
+    MallocAllocator() noexcept = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        return static_cast<T*>(allocate_bytes(bytes(n)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (p == nullptr) {
+            return;
+        }
+#if defined(__linux__)
+        if (is_mapped(bytes(n))) {
+            ::munmap(p, round_to_pages(bytes(n)));
+            return;
+        }
+#endif
+        std::free(p);
+    }
+
+    // Moves the first min(old_n, new_n) elements' bytes into a block for new_n elements, frees 'p'
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        if (p == nullptr) {
+            return allocate(new_n);
+        }
+        if (new_n == 0) {
+            deallocate(p, old_n);
+            return nullptr;
+        }
+
+        const size_t old_bytes = bytes(old_n);
+        const size_t new_bytes = bytes(new_n);
+
+#if defined(__linux__)
+        const bool old_mapped = is_mapped(old_bytes);
+        const bool new_mapped = is_mapped(new_bytes);
+
+        if (old_mapped && new_mapped) {
+            void* moved = ::mremap(p, round_to_pages(old_bytes), round_to_pages(new_bytes), MREMAP_MAYMOVE);
+            if (moved == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(moved);
+        }
+
+        if (old_mapped || new_mapped) {
+            // Crossing the threshold => one copy between the two kinds of blocks
+            void* fresh = allocate_bytes(new_bytes);
+            std::memcpy(fresh, p, old_bytes < new_bytes ? old_bytes : new_bytes);
+            deallocate(p, old_n);
+            return static_cast<T*>(fresh);
+        }
+#endif
+
+        void* moved = std::realloc(p, new_bytes);
+        if (moved == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(moved);
+    }
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>&) const noexcept {
+        return true;
+    }
+
+  private:
+    static size_t bytes(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    static void* allocate_bytes(size_t size) {
+#if defined(__linux__)
+        if (is_mapped(size)) {
+            void* mapping = ::mmap(nullptr, round_to_pages(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                                   -1, 0);
+            if (mapping == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return mapping;
+        }
+#endif
+        void* block = std::malloc(size);
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        return block;
+    }
+
+#if defined(__linux__)
+    static bool is_mapped(size_t size) noexcept {
+        return size >= MREMAP_THRESHOLD;
+    }
+
+    static size_t round_to_pages(size_t size) noexcept {
+        static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        return (size + page - 1) / page * page;
+    }
+#endif
+};
+}  // namespace renn::containers
@@ -0,0 +1,450 @@
+#pragma once
+
+#include "Simd.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace renn::containers {
+
+// Array of trivially copyable T stored in a file and accessed through a shared mapping
+//
+// Opening costs one mmap: elements are paged in by the first access to them (lazy load, no parse),
+// and the kernel can evict clean pages => arrays larger than RAM work, at the cost of page faults
+//
+// File: a 64-byte header (magic, sizeof(T), size) followed by the elements in native byte order
+// The file is 'capacity' elements long while writable; growing extends it with ftruncate and the mapping
+// with mremap (no copy through user space). Closing a writable array trims the file to size()
+//
+// Writes land in the page cache right away: other mappings of the file see them, and the kernel writes
+// them back eventually. sync() (msync) waits until they are on disk, e.g. before acknowledging a commit
+//
+// A read-only array is mapped PROT_READ: reading works through either API (operator[], at(), data(),
+// iterators), writing through the references or pointers they return faults, and the mutating members
+// (push_back, resize, ...) throw std::logic_error. Not synchronized, like DynamicArray
+
+template <typename T>
+class MappedArray {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedArray stores the bytes of its elements in a file");
+    static_assert(alignof(T) <= 64, "Elements start 64 bytes into a page-aligned mapping");
+
+  public:
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // New empty file (fails if it exists), writable
+    static MappedArray create(const std::filesystem::path& path, size_t capacity = 0) {
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw_errno("create", path);
+        }
+
+        MappedArray array(path, fd, true);
+        array.map(file_length(std::max<size_t>(capacity, 1)));
+        array.header()->magic = MAGIC;
+        array.header()->element_size = sizeof(T);
+        array.header()->size = 0;
+        return array;
+    }
+
+    // Existing file created by MappedArray<T>
+    static MappedArray open(const std::filesystem::path& path, bool writable = false) {
+        const int fd = ::open(path.c_str(), (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+        if (fd < 0) {
+            throw_errno("open", path);
+        }
+
+        MappedArray array(path, fd, writable);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            throw_errno("fstat", path);
+        }
+        const auto length = static_cast<size_t>(st.st_size);
+        if (length < HEADER_SIZE) {
+            throw std::runtime_error("MappedArray: " + path.string() + " is too short for a header");
+        }
+
+        array.map(length);
+        const Header* header = array.header();
+        if (header->magic != MAGIC) {
+            throw std::runtime_error("MappedArray: " + path.string() + " is not a MappedArray file");
+        }
+        if (header->element_size != sizeof(T)) {
+            throw std::runtime_error("MappedArray: " + path.string() + " holds elements of " +
+                                     std::to_string(header->element_size) + " bytes, not " +
+                                     std::to_string(sizeof(T)));
+        }
+        if (header->size > array.capacity_) {
+            throw std::runtime_error("MappedArray: " + path.string() + " is truncated");
+        }
+        array.size_ = static_cast<size_t>(header->size);
+        return array;
+    }
+
+    MappedArray(const MappedArray&) = delete;
+    MappedArray& operator=(const MappedArray&) = delete;
+
+    MappedArray(MappedArray&& other) noexcept
+        : path_(std::move(other.path_)),
+          fd_(std::exchange(other.fd_, -1)),
+          mapping_(std::exchange(other.mapping_, nullptr)),
+          mapping_length_(std::exchange(other.mapping_length_, 0)),
+          size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          writable_(other.writable_) {}
+
+    MappedArray& operator=(MappedArray&& other) noexcept {
+        if (this != &other) {
+            close();
+            path_ = std::move(other.path_);
+            fd_ = std::exchange(other.fd_, -1);
+            mapping_ = std::exchange(other.mapping_, nullptr);
+            mapping_length_ = std::exchange(other.mapping_length_, 0);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+            writable_ = other.writable_;
+        }
+        return *this;
+    }
+
+    ~MappedArray() {
+        close();
+    }
+
+    const T& operator[](size_t index) const {
+        return elements()[index];
+    }
+
+    T& operator[](size_t index) {
+        return elements()[index];
+    }
+
+    const T& at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return elements()[index];
+    }
+
+    T& at(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return elements()[index];
+    }
+
+    const T& front() const {
+        return elements()[0];
+    }
+
+    const T& back() const {
+        return elements()[size_ - 1];
+    }
+
+    T* data() noexcept {
+        return elements();
+    }
+
+    const T* data() const noexcept {
+        return elements();
+    }
+
+    iterator begin() noexcept {
+        return elements();
+    }
+
+    const_iterator begin() const noexcept {
+        return elements();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return elements();
+    }
+
+    iterator end() noexcept {
+        return elements() + size_;
+    }
+
+    const_iterator end() const noexcept {
+        return elements() + size_;
+    }
+
+    const_iterator cend() const noexcept {
+        return elements() + size_;
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return const_reverse_iterator(cend());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return const_reverse_iterator(cbegin());
+    }
+
+    const_iterator find(const T& value) const {
+        return cbegin() + index_of(value);
+    }
+
+    bool contains(const T& value) const {
+        return index_of(value) != size_;
+    }
+
+    size_t count(const T& value) const {
+        if constexpr (simd::Arithmetic<T>) {
+            return simd::count(elements(), size_, value);
+        } else {
+            return static_cast<size_t>(std::count(cbegin(), cend(), value));
+        }
+    }
+
+    // Writable arrays only (std::logic_error otherwise)
+
+    void push_back(const T& value) {
+        require_writable();
+        if (size_ == capacity_) {
+            T copy(value);  // 'value' may be an element => the remap would move it
+            grow(size_ + 1);
+            elements()[size_] = copy;
+        } else {
+            elements()[size_] = value;
+        }
+        set_size(size_ + 1);
+    }
+
+    // One memcpy for a contiguous range of T (e.g. a DynamicArray), element by element otherwise
+    // (must not refer to this array's elements)
+    template <std::ranges::input_range Range>
+    void append_range(Range&& range) {
+        require_writable();
+        if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>) {
+            const auto count = static_cast<size_t>(std::ranges::distance(range));
+            if (count > capacity_ - size_) {
+                grow(size_ + count);
+            }
+            if constexpr (std::ranges::contiguous_range<Range> &&
+                          std::is_same_v<std::remove_cvref_t<std::ranges::range_reference_t<Range>>, T>) {
+                if (count != 0) {
+                    std::memcpy(static_cast<void*>(elements() + size_), std::ranges::data(range), count * sizeof(T));
+                }
+            } else {
+                std::ranges::copy(range, elements() + size_);
+            }
+            set_size(size_ + count);
+        } else {
+            for (auto&& item : range) {
+                push_back(static_cast<T>(item));
+            }
+        }
+    }
+
+    void pop_back() {
+        require_writable();
+        if (size_ > 0) {
+            set_size(size_ - 1);
+        }
+    }
+
+    // New elements are zero bytes (value-initialized for the arithmetic types this is meant for)
+    void resize(size_t new_size) {
+        require_writable();
+        if (new_size > capacity_) {
+            reserve(new_size);
+        }
+        if (new_size > size_) {
+            std::memset(static_cast<void*>(elements() + size_), 0, (new_size - size_) * sizeof(T));
+        }
+        set_size(new_size);
+    }
+
+    void clear() {
+        resize(0);
+    }
+
+    // Extends the file and the mapping; the new pages are sparse until written
+    void reserve(size_t new_capacity) {
+        require_writable();
+        if (new_capacity > capacity_) {
+            remap(file_length(new_capacity));
+        }
+    }
+
+    void shrink_to_fit() {
+        require_writable();
+        if (file_length(std::max<size_t>(size_, 1)) < mapping_length_) {
+            remap(file_length(std::max<size_t>(size_, 1)));
+        }
+    }
+
+    // Blocks until the header and the elements are on disk
+    void sync() const {
+        require_writable();
+        const size_t length = HEADER_SIZE + size_ * sizeof(T);
+        if (::msync(mapping_, length, MS_SYNC) != 0) {
+            throw_errno("msync", path_);
+        }
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    bool writable() const noexcept {
+        return writable_;
+    }
+
+    const std::filesystem::path& path() const noexcept {
+        return path_;
+    }
+
+  private:
+    struct Header {
+        uint64_t magic;
+        uint64_t element_size;
+        uint64_t size;
+        uint64_t reserved[5];
+    };
+
+    static constexpr size_t HEADER_SIZE = 64;
+    static constexpr uint64_t MAGIC = 0x3150414D4E4E4552;  // "RENNMAP1"
+    static_assert(sizeof(Header) == HEADER_SIZE);
+
+    MappedArray(std::filesystem::path path, int fd, bool writable)
+        : path_(std::move(path)), fd_(fd), writable_(writable) {}
+
+    [[noreturn]] static void throw_errno(const std::string& what, const std::filesystem::path& path) {
+        throw std::system_error(errno, std::generic_category(), "MappedArray: " + what + " " + path.string());
+    }
+
+    // Bytes of a file with room for 'capacity' elements
+    static size_t file_length(size_t capacity) {
+        if (capacity > (std::numeric_limits<size_t>::max() - HEADER_SIZE) / sizeof(T)) {
+            throw std::length_error("MappedArray: capacity too large");
+        }
+        return HEADER_SIZE + capacity * sizeof(T);
+    }
+
+    Header* header() const noexcept {
+        return static_cast<Header*>(mapping_);
+    }
+
+    T* elements() const noexcept {
+        return reinterpret_cast<T*>(static_cast<std::byte*>(mapping_) + HEADER_SIZE);
+    }
+
+    size_t index_of(const T& value) const {
+        if constexpr (simd::Arithmetic<T>) {
+            return simd::find(elements(), size_, value);
+        } else {
+            return static_cast<size_t>(std::find(cbegin(), cend(), value) - cbegin());
+        }
+    }
+
+    void require_writable() const {
+        if (!writable_) {
+            throw std::logic_error("MappedArray: " + path_.string() + " is open read-only");
+        }
+    }
+
+    void set_size(size_t size) noexcept {
+        size_ = size;
+        header()->size = size;
+    }
+
+    void grow(size_t needed) {
+        reserve(std::max({needed, 2 * capacity_, size_t{16}}));
+    }
+
+    // First mapping of a file of 'length' bytes (extended to it when writable)
+    void map(size_t length) {
+        if (writable_ && ::ftruncate(fd_, static_cast<off_t>(length)) != 0) {
+            throw_errno("ftruncate", path_);
+        }
+
+        const int protection = writable_ ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* mapping = ::mmap(nullptr, length, protection, MAP_SHARED, fd_, 0);
+        if (mapping == MAP_FAILED) {
+            throw_errno("mmap", path_);
+        }
+        mapping_ = mapping;
+        mapping_length_ = length;
+        capacity_ = (length - HEADER_SIZE) / sizeof(T);
+    }
+
+    // The file and the mapping to 'length' bytes; the pages keep their contents, only the address may change
+    void remap(size_t length) {
+        if (::ftruncate(fd_, static_cast<off_t>(length)) != 0) {
+            throw_errno("ftruncate", path_);
+        }
+
+#if defined(__linux__)
+        void* mapping = ::mremap(mapping_, mapping_length_, length, MREMAP_MAYMOVE);
+        if (mapping == MAP_FAILED) {
+            throw_errno("mremap", path_);
+        }
+#else
+        void* mapping = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapping == MAP_FAILED) {
+            throw_errno("mmap", path_);
+        }
+        ::munmap(mapping_, mapping_length_);
+#endif
+        mapping_ = mapping;
+        mapping_length_ = length;
+        capacity_ = (length - HEADER_SIZE) / sizeof(T);
+    }
+
+    void close() noexcept {
+        if (mapping_ != nullptr) {
+            ::munmap(mapping_, mapping_length_);
+            mapping_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            if (writable_) {
+                // Drops the unused capacity; failure only leaves a longer file
+                [[maybe_unused]] int ignored = ::ftruncate(fd_, static_cast<off_t>(HEADER_SIZE + size_ * sizeof(T)));
+            }
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+  private:
+    std::filesystem::path path_;
+    int fd_{-1};
+    void* mapping_{nullptr};
+    size_t mapping_length_{0};
+    size_t size_{0};
+    size_t capacity_{0};
+    bool writable_{false};
+};
+}  // namespace renn::containers
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace renn::containers {
+
+// constexpr hash for PerfectHashMap: string-like keys and integers
+// (the runtime hashers use memcpy / 128-bit multiplies, which are not usable in constant evaluation everywhere)
+template <typename Key>
+struct PerfectHash {
+    static constexpr uint64_t fmix(uint64_t h) noexcept {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    constexpr uint64_t operator()(const Key& key, uint64_t seed) const noexcept {
+        if constexpr (std::is_integral_v<Key> || std::is_enum_v<Key>) {
+            return fmix(static_cast<uint64_t>(key) ^ fmix(seed + 0x9E3779B97F4A7C15ULL));
+        } else {
+            // FNV-1a over the characters, then the Murmur3 finalizer
+            const std::string_view str(key);
+            uint64_t h = 0xcbf29ce484222325ULL ^ seed;
+            for (char c : str) {
+                h ^= static_cast<unsigned char>(c);
+                h *= 0x100000001b3ULL;
+            }
+            return fmix(h ^ str.size());
+        }
+    }
+};
+
+// Static map over a key set known at compile time, built by make_perfect_hash_map in a constant expression
+//
+// PTHash-style construction: keys are split into buckets of ~4 by hash, then, largest bucket first,
+// every bucket gets the smallest "pilot" p such that all its keys land in free slots at
+//     position = ((hash(key) ^ mix(p)) * FIBONACCI_MULTIPLIER) >> (64 - log2(SLOTS))
+// => a lookup is hash + one pilot load + one slot compare, no probing, no collisions, no runtime setup
+// A miss is answered by the same single compare
+//
+// SLOTS is the power of two >= N => load factor in (0.5, 1]
+
+template <typename Key, typename Value, size_t N, typename Hash = PerfectHash<Key>>
+class PerfectHashMap {
+    static_assert(N > 0, "PerfectHashMap needs at least one key");
+
+  private:
+    static constexpr size_t KEYS_PER_BUCKET = 4;
+    static constexpr uint32_t MAX_PILOT = 1u << 16;  // Per bucket, before a new seed is tried
+    static constexpr uint64_t MAX_SEEDS = 64;
+    static constexpr uint64_t FIBONACCI_MULTIPLIER = 0x9E3779B97F4A7C15ull;
+
+  public:
+    static constexpr size_t SLOTS = std::bit_ceil(N);
+    static constexpr size_t BUCKETS = (N + KEYS_PER_BUCKET - 1) / KEYS_PER_BUCKET;
+
+  private:
+    static constexpr size_t SLOT_BITS = std::countr_zero(SLOTS);
+
+    struct Slot {
+        Key key_{};
+        Value value_{};
+        bool used_{false};
+    };
+
+  public:
+    using value_type = std::pair<Key, Value>;
+
+    // Use make_perfect_hash_map, the search needs constant evaluation to pay off
+    consteval explicit PerfectHashMap(const std::array<value_type, N>& entries) {
+        for (uint64_t seed = 0; seed < MAX_SEEDS; ++seed) {
+            if (build(entries, seed)) {
+                return;
+            }
+        }
+        throw std::logic_error("PerfectHashMap: no perfect hash found");
+    }
+
+    constexpr const Value* find(const Key& key) const noexcept {
+        const Slot& slot = slots_[position(hash_(key, seed_))];
+        return slot.used_ && slot.key_ == key ? &slot.value_ : nullptr;
+    }
+
+    constexpr bool contains(const Key& key) const noexcept {
+        return find(key) != nullptr;
+    }
+
+    constexpr const Value& at(const Key& key) const {
+        const Value* value = find(key);
+        if (value == nullptr) {
+            throw std::out_of_range("Key not found");
+        }
+        return *value;
+    }
+
+    static constexpr size_t size() noexcept { return N; }
+
+    static constexpr size_t slot_count() noexcept { return SLOTS; }
+
+    // Calls fn(key, value) for every entry, in slot order
+    template <typename Fn>
+    constexpr void for_each(Fn&& fn) const {
+        for (const Slot& slot : slots_) {
+            if (slot.used_) {
+                fn(slot.key_, slot.value_);
+            }
+        }
+    }
+
+  private:
+    static constexpr uint64_t mix_pilot(uint64_t pilot) noexcept {
+        return PerfectHash<uint64_t>::fmix(pilot * FIBONACCI_MULTIPLIER + 1);
+    }
+
+    // High bits pick the bucket, the low ones (xored with the pilot) the slot
+    static constexpr size_t bucket_of(uint64_t hash) noexcept {
+        return static_cast<size_t>(((hash >> 32) * BUCKETS) >> 32);
+    }
+
+    // Multiply-shift, not a mask: keys of one bucket that agree in their low bits
+    // would otherwise stay together for every pilot
+    static constexpr size_t slot_of(uint64_t hash, uint64_t pilot) noexcept {
+        if constexpr (SLOTS == 1) {
+            return 0;
+        } else {
+            return static_cast<size_t>(((hash ^ mix_pilot(pilot)) * FIBONACCI_MULTIPLIER) >> (64 - SLOT_BITS));
+        }
+    }
+
+    constexpr size_t position(uint64_t hash) const noexcept {
+        return slot_of(hash, pilots_[bucket_of(hash)]);
+    }
+
+    constexpr bool build(const std::array<value_type, N>& entries, uint64_t seed) {
+        seed_ = seed;
+        slots_ = {};
+        pilots_ = {};
+
+        std::array<uint64_t, N> hashes{};
+        std::array<size_t, BUCKETS> bucket_sizes{};
+        for (size_t i = 0; i < N; ++i) {
+            hashes[i] = hash_(entries[i].first, seed);
+            ++bucket_sizes[bucket_of(hashes[i])];
+        }
+
+        // Keys grouped by bucket (counting sort)
+        std::array<size_t, BUCKETS + 1> bucket_begin{};
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            bucket_begin[b + 1] = bucket_begin[b] + bucket_sizes[b];
+        }
+        std::array<size_t, N> grouped{};
+        std::array<size_t, BUCKETS> fill{};
+        for (size_t i = 0; i < N; ++i) {
+            const size_t b = bucket_of(hashes[i]);
+            grouped[bucket_begin[b] + fill[b]++] = i;
+        }
+
+        // Largest buckets first, while the table is still empty (insertion sort, N is small)
+        std::array<size_t, BUCKETS> order{};
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            size_t j = b;
+            while (j > 0 && bucket_sizes[order[j - 1]] < bucket_sizes[b]) {
+                order[j] = order[j - 1];
+                --j;
+            }
+            order[j] = b;
+        }
+
+        // Equal keys share the hash and the bucket => checked here, they would defeat every pilot
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            for (size_t k = bucket_begin[b]; k < bucket_begin[b + 1]; ++k) {
+                for (size_t other = bucket_begin[b]; other < k; ++other) {
+                    if (hashes[grouped[k]] != hashes[grouped[other]]) {
+                        continue;
+                    }
+                    if (entries[grouped[k]].first == entries[grouped[other]].first) {
+                        throw std::logic_error("PerfectHashMap: duplicate key");
+                    }
+                    return false;  // Full 64-bit collision => next seed
+                }
+            }
+        }
+
+        std::array<size_t, KEYS_PER_BUCKET * 4> positions{};
+
+        for (size_t b : order) {
+            const size_t first = bucket_begin[b];
+            const size_t count = bucket_sizes[b];
+            if (count == 0) {
+                break;
+            }
+            if (count > positions.size()) {
+                return false;  // Degenerate seed
+            }
+
+            bool placed = false;
+            for (uint32_t pilot = 0; pilot < MAX_PILOT && !placed; ++pilot) {
+                placed = true;
+                for (size_t k = 0; k < count && placed; ++k) {
+                    const uint64_t hash = hashes[grouped[first + k]];
+                    positions[k] = slot_of(hash, pilot);
+
+                    if (slots_[positions[k]].used_) {
+                        placed = false;
+                    }
+                    for (size_t other = 0; other < k && placed; ++other) {
+                        if (positions[other] == positions[k]) {
+                            placed = false;
+                        }
+                    }
+                }
+
+                if (placed) {
+                    pilots_[b] = pilot;
+                    for (size_t k = 0; k < count; ++k) {
+                        const auto& entry = entries[grouped[first + k]];
+                        slots_[positions[k]] = Slot{entry.first, entry.second, true};
+                    }
+                }
+            }
+
+            if (!placed) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    std::array<Slot, SLOTS> slots_{};
+    std::array<uint32_t, BUCKETS> pilots_{};
+    uint64_t seed_{0};
+    [[no_unique_address]] Hash hash_{};
+};
+
+// constexpr auto keywords = make_perfect_hash_map<std::string_view, Token>({{
+//     {"if", Token::If},
+//     {"else", Token::Else},
+// }});
+// static_assert(keywords.at("if") == Token::If);
+//
+// Duplicate keys are a compile error
+template <typename Key, typename Value, typename Hash = PerfectHash<Key>, size_t N>
+consteval auto make_perfect_hash_map(const std::array<std::pair<Key, Value>, N>& entries) {
+    return PerfectHashMap<Key, Value, N, Hash>(entries);
+}
+}  // namespace renn::containers
@@ -0,0 +1,716 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace renn::containers {
+
+// Persistent (immutable) hash map: hash array mapped trie with structural sharing (CHAMP layout)
+//
+// Every node covers 5 bits of the hash => up to 32 slots, stored compactly:
+//   datamap - which slots hold an entry inline, nodemap - which hold a child node
+//   the entry / child of a slot is at popcount(map & (bit - 1)) in the node's arrays
+// Keys whose whole hash is equal end up in a collision node below the last level
+//
+// set/erase copy only the path from the root to the changed slot (O(log32 n) nodes) and share the rest
+// => a copy of the map (a snapshot) is O(1), versions never change once built and may be read from any
+// number of threads while others build newer versions, nothing is locked
+// Nodes are reference counted (atomically), the last version referencing a node frees it
+//
+// Transient: batch-update mode. Nodes created by a transient carry its edit token and are mutated in
+// place by later updates of the same transient instead of being copied again; persistent() hands out
+// the current version and takes a fresh token => the nodes it shares are copy-on-write again
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class PersistentHashMap {
+  public:
+    using value_type = std::pair<Key, Value>;
+    class Transient;
+
+  private:
+    using Entry = value_type;
+
+    static constexpr uint32_t BITS_PER_LEVEL = 5;
+    static constexpr uint32_t LEVEL_MASK = (1u << BITS_PER_LEVEL) - 1;
+    static constexpr uint32_t HASH_BITS = std::numeric_limits<size_t>::digits;
+
+    // Bitmap levels + the collision level
+    static constexpr uint32_t MAX_DEPTH = (HASH_BITS + BITS_PER_LEVEL - 1) / BITS_PER_LEVEL + 1;
+
+    struct Node {
+        std::atomic<size_t> refs_{1};
+        uint64_t owner_;  // Edit token of the transient that may mutate it in place, 0 => frozen
+        uint32_t datamap_{0};
+        uint32_t nodemap_{0};
+        uint32_t entry_count_{0};
+        uint32_t child_count_{0};
+        bool collision_{false};  // Entries only, all with the same hash, no bitmaps
+        Entry* entries_{nullptr};
+        Node** children_{nullptr};
+
+        explicit Node(uint64_t owner) : owner_(owner) {}
+    };
+
+    using EntryAllocator = std::allocator<Entry>;
+    using ChildAllocator = std::allocator<Node*>;
+
+  public:
+    class const_iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PersistentHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const noexcept { return *current_; }
+
+        pointer operator->() const noexcept { return current_; }
+
+        const_iterator& operator++() noexcept {
+            advance();
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator copy = *this;
+            advance();
+            return copy;
+        }
+
+        bool operator==(const const_iterator& other) const noexcept { return current_ == other.current_; }
+
+      private:
+        friend class PersistentHashMap;
+
+        struct Frame {
+            const Node* node;
+            uint32_t entry;
+            uint32_t child;
+        };
+
+        explicit const_iterator(const Node* root) noexcept {
+            if (root != nullptr) {
+                stack_[0] = {root, 0, 0};
+                depth_ = 0;
+                advance();
+            }
+        }
+
+        // Entries of a node first, then depth-first into its children
+        void advance() noexcept {
+            while (depth_ >= 0) {
+                Frame& frame = stack_[depth_];
+                if (frame.entry < frame.node->entry_count_) {
+                    current_ = &frame.node->entries_[frame.entry++];
+                    return;
+                }
+                if (frame.child < frame.node->child_count_) {
+                    stack_[depth_ + 1] = {frame.node->children_[frame.child++], 0, 0};
+                    ++depth_;
+                    continue;
+                }
+                --depth_;
+            }
+            current_ = nullptr;
+        }
+
+        Frame stack_[MAX_DEPTH + 1];
+        int depth_{-1};
+        const Entry* current_{nullptr};
+    };
+
+    using iterator = const_iterator;
+
+  public:
+    PersistentHashMap() = default;
+
+    PersistentHashMap(std::initializer_list<value_type> init) {
+        Transient transient = this->transient();
+        for (const auto& [key, value] : init) {
+            transient.set(key, value);
+        }
+        *this = std::move(transient).persistent();
+    }
+
+    // O(1): the copy shares every node
+    PersistentHashMap(const PersistentHashMap& other) noexcept : root_(other.root_), size_(other.size_) {
+        retain(root_);
+    }
+
+    PersistentHashMap(PersistentHashMap&& other) noexcept : root_(std::exchange(other.root_, nullptr)),
+                                                            size_(std::exchange(other.size_, 0)) {}
+
+    PersistentHashMap& operator=(const PersistentHashMap& other) noexcept {
+        if (this != &other) {
+            retain(other.root_);
+            release(root_);
+            root_ = other.root_;
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    PersistentHashMap& operator=(PersistentHashMap&& other) noexcept {
+        if (this != &other) {
+            release(root_);
+            root_ = std::exchange(other.root_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~PersistentHashMap() { release(root_); }
+
+    size_t size() const noexcept { return size_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+    const Value* find(const Key& key) const { return lookup(root_, key, Hash{}(key)); }
+
+    bool contains(const Key& key) const { return find(key) != nullptr; }
+
+    const Value& at(const Key& key) const {
+        const Value* value = find(key);
+        if (value == nullptr) {
+            throw std::out_of_range("PersistentHashMap::at: key not found");
+        }
+        return *value;
+    }
+
+    // New version with key => value, this one is left untouched
+    [[nodiscard]] PersistentHashMap set(Key key, Value value) const {
+        Entry entry(std::move(key), std::move(value));
+        const size_t hash = Hash{}(entry.first);
+
+        if (root_ == nullptr) {
+            return PersistentHashMap(singleton(std::move(entry), hash, 0), 1);
+        }
+
+        bool added = false;
+        Node* root = insert(root_, entry, hash, 0, /*edit=*/0, added);
+        return PersistentHashMap(root, size_ + added);
+    }
+
+    // New version without key (shares everything with this one if there was no such key)
+    [[nodiscard]] PersistentHashMap erase(const Key& key) const {
+        bool removed = false;
+        Node* root = root_ == nullptr ? nullptr : remove(root_, key, Hash{}(key), 0, /*edit=*/0, removed);
+
+        if (!removed) {
+            return *this;
+        }
+        return PersistentHashMap(normalize_root(root), size_ - 1);
+    }
+
+    // Batch of updates starting from this version
+    Transient transient() const { return Transient(*this); }
+
+    const_iterator begin() const noexcept { return const_iterator(root_); }
+
+    const_iterator end() const noexcept { return const_iterator(); }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& [key, value] : *this) {
+            fn(key, value);
+        }
+    }
+
+  public:
+    class Transient {
+      public:
+        Transient(const Transient&) = delete;
+        Transient& operator=(const Transient&) = delete;
+
+        Transient(Transient&& other) noexcept : root_(std::exchange(other.root_, nullptr)),
+                                                size_(std::exchange(other.size_, 0)),
+                                                edit_(other.edit_) {}
+
+        ~Transient() { release(root_); }
+
+        size_t size() const noexcept { return size_; }
+
+        const Value* find(const Key& key) const { return lookup(root_, key, Hash{}(key)); }
+
+        bool contains(const Key& key) const { return find(key) != nullptr; }
+
+        // Returns true if the key was inserted, false if its value was replaced
+        bool set(Key key, Value value) {
+            Entry entry(std::move(key), std::move(value));
+            const size_t hash = Hash{}(entry.first);
+
+            if (root_ == nullptr) {
+                root_ = singleton(std::move(entry), hash, edit_);
+                size_ = 1;
+                return true;
+            }
+
+            bool added = false;
+            install(insert(root_, entry, hash, 0, edit_, added));
+            size_ += added;
+            return added;
+        }
+
+        bool erase(const Key& key) {
+            if (root_ == nullptr) {
+                return false;
+            }
+
+            bool removed = false;
+            Node* root = remove(root_, key, Hash{}(key), 0, edit_, removed);
+            if (removed) {
+                install(root);
+                root_ = normalize_root(root_);
+                --size_;
+            }
+            return removed;
+        }
+
+        // Snapshot of the updates so far; the transient stays usable, the shared nodes are frozen
+        PersistentHashMap persistent() & {
+            retain(root_);
+            edit_ = next_edit();
+            return PersistentHashMap(root_, size_);
+        }
+
+        PersistentHashMap persistent() && {
+            return PersistentHashMap(std::exchange(root_, nullptr), std::exchange(size_, 0));
+        }
+
+      private:
+        friend class PersistentHashMap;
+
+        explicit Transient(const PersistentHashMap& map) : root_(map.root_), size_(map.size_), edit_(next_edit()) {
+            retain(root_);
+        }
+
+        void install(Node* root) noexcept {
+            if (root != root_) {
+                release(root_);
+                root_ = root;
+            }
+        }
+
+      private:
+        Node* root_;
+        size_t size_;
+        uint64_t edit_;
+    };
+
+  private:
+    PersistentHashMap(Node* root, size_t size) noexcept : root_(root), size_(size) {}
+
+    static uint64_t next_edit() noexcept {
+        static std::atomic<uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    static uint32_t slot(size_t hash, uint32_t shift) noexcept {
+        return 1u << ((hash >> shift) & LEVEL_MASK);
+    }
+
+    static uint32_t index(uint32_t map, uint32_t bit) noexcept {
+        return static_cast<uint32_t>(std::popcount(map & (bit - 1)));
+    }
+
+    static bool owned(const Node* node, uint64_t edit) noexcept {
+        return edit != 0 && node->owner_ == edit;
+    }
+
+    // Node allocation / reference counting
+
+    static Entry* allocate_entries(size_t count) {
+        if (count == 0) {
+            return nullptr;
+        }
+        EntryAllocator allocator;
+        return std::allocator_traits<EntryAllocator>::allocate(allocator, count);
+    }
+
+    static void deallocate_entries(Entry* entries, size_t count) noexcept {
+        if (entries != nullptr) {
+            EntryAllocator allocator;
+            std::allocator_traits<EntryAllocator>::deallocate(allocator, entries, count);
+        }
+    }
+
+    static Node** allocate_children(size_t count) {
+        if (count == 0) {
+            return nullptr;
+        }
+        ChildAllocator allocator;
+        return std::allocator_traits<ChildAllocator>::allocate(allocator, count);
+    }
+
+    static void deallocate_children(Node** children, size_t count) noexcept {
+        if (children != nullptr) {
+            ChildAllocator allocator;
+            std::allocator_traits<ChildAllocator>::deallocate(allocator, children, count);
+        }
+    }
+
+    static void retain(Node* node) noexcept {
+        if (node != nullptr) {
+            node->refs_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static void release(Node* node) noexcept {
+        if (node == nullptr || node->refs_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        std::destroy_n(node->entries_, node->entry_count_);
+        deallocate_entries(node->entries_, node->entry_count_);
+        for (uint32_t i = 0; i < node->child_count_; ++i) {
+            release(node->children_[i]);  // Depth is bounded by MAX_DEPTH
+        }
+        deallocate_children(node->children_, node->child_count_);
+        delete node;
+    }
+
+    // Root of an erase result: an empty root is dropped
+    static Node* normalize_root(Node* root) noexcept {
+        if (root != nullptr && root->entry_count_ == 0 && root->child_count_ == 0) {
+            release(root);
+            return nullptr;
+        }
+        return root;
+    }
+
+    // Exactly one entry and no children => its parent takes the entry inline (canonical form)
+    static bool is_singleton(const Node* node) noexcept {
+        return node->entry_count_ == 1 && node->child_count_ == 0;
+    }
+
+    // Builders
+
+    static Node* singleton(Entry&& entry, size_t hash, uint64_t edit) {
+        auto node = std::make_unique<Node>(edit);
+        node->entries_ = allocate_entries(1);
+        try {
+            std::construct_at(node->entries_, std::move(entry));
+        } catch (...) {
+            deallocate_entries(node->entries_, 1);
+            node->entries_ = nullptr;
+            throw;
+        }
+        node->entry_count_ = 1;
+        node->datamap_ = slot(hash, 0);
+        return node.release();
+    }
+
+    // Node holding two entries that share the hash bits above 'shift'
+    static Node* merge(const Entry& first, size_t first_hash, Entry&& second, size_t second_hash,
+                       uint32_t shift, uint64_t edit) {
+        auto node = std::make_unique<Node>(edit);
+
+        if (shift >= HASH_BITS) {
+            node->collision_ = true;
+            node->entries_ = allocate_entries(2);
+            fill_pair(node.get(), first, std::move(second), false);
+            return node.release();
+        }
+
+        const uint32_t first_bit = slot(first_hash, shift);
+        const uint32_t second_bit = slot(second_hash, shift);
+
+        if (first_bit == second_bit) {
+            node->children_ = allocate_children(1);
+            try {
+                node->children_[0] = merge(first, first_hash, std::move(second), second_hash,
+                                           shift + BITS_PER_LEVEL, edit);
+            } catch (...) {
+                deallocate_children(node->children_, 1);
+                throw;
+            }
+            node->child_count_ = 1;
+            node->nodemap_ = first_bit;
+            return node.release();
+        }
+
+        node->entries_ = allocate_entries(2);
+        fill_pair(node.get(), first, std::move(second), second_bit < first_bit);
+        node->datamap_ = first_bit | second_bit;
+        return node.release();
+    }
+
+    static void fill_pair(Node* node, const Entry& first, Entry&& second, bool second_first) {
+        Entry* lhs = node->entries_ + (second_first ? 1 : 0);
+        Entry* rhs = node->entries_ + (second_first ? 0 : 1);
+        try {
+            std::construct_at(lhs, first);
+            try {
+                std::construct_at(rhs, std::move(second));
+            } catch (...) {
+                std::destroy_at(lhs);
+                throw;
+            }
+        } catch (...) {
+            deallocate_entries(node->entries_, 2);
+            node->entries_ = nullptr;
+            throw;
+        }
+        node->entry_count_ = 2;
+    }
+
+    // 'node' with the entry at erase_entry (old index) removed, insert_entry placed at insert_entry_at (new index),
+    // and likewise for children; bitmaps are left for the caller to update
+    // An owned node is rebuilt in place (entries moved), any other is copied (children retained)
+    // => the returned node is 'node' itself or a new one with one reference, owned by 'edit'
+    static Node* reshape(Node* node, uint64_t edit,
+                         int64_t erase_entry, Entry* insert_entry, int64_t insert_entry_at,
+                         int64_t erase_child, Node* insert_child, int64_t insert_child_at) {
+        const bool in_place = owned(node, edit);
+
+        const uint32_t entry_count = node->entry_count_ - (erase_entry >= 0) + (insert_entry != nullptr);
+        const uint32_t child_count = node->child_count_ - (erase_child >= 0) + (insert_child != nullptr);
+
+        Entry* entries = allocate_entries(entry_count);
+        uint32_t constructed = 0;
+        try {
+            uint32_t from = 0;
+            for (; constructed < entry_count; ++constructed) {
+                if (insert_entry != nullptr && constructed == insert_entry_at) {
+                    std::construct_at(entries + constructed, std::move(*insert_entry));
+                    continue;
+                }
+                if (from == erase_entry) {
+                    ++from;
+                }
+                Entry& source = node->entries_[from++];
+                if (in_place) {
+                    std::construct_at(entries + constructed, std::move_if_noexcept(source));
+                } else {
+                    std::construct_at(entries + constructed, std::as_const(source));
+                }
+            }
+        } catch (...) {
+            std::destroy_n(entries, constructed);
+            deallocate_entries(entries, entry_count);
+            throw;
+        }
+
+        Node** children;
+        try {
+            children = allocate_children(child_count);
+        } catch (...) {
+            std::destroy_n(entries, entry_count);
+            deallocate_entries(entries, entry_count);
+            throw;
+        }
+        for (uint32_t to = 0, from = 0; to < child_count; ++to) {
+            if (insert_child != nullptr && to == insert_child_at) {
+                children[to] = insert_child;  // Takes the caller's reference
+                continue;
+            }
+            if (from == erase_child) {
+                ++from;
+            }
+            children[to] = node->children_[from++];
+            if (!in_place) {
+                retain(children[to]);
+            }
+        }
+
+        Node* result = node;
+        if (in_place) {
+            if (erase_child >= 0) {
+                release(node->children_[erase_child]);
+            }
+            std::destroy_n(node->entries_, node->entry_count_);
+            deallocate_entries(node->entries_, node->entry_count_);
+            deallocate_children(node->children_, node->child_count_);
+        } else {
+            result = new Node(edit);
+            result->datamap_ = node->datamap_;
+            result->nodemap_ = node->nodemap_;
+            result->collision_ = node->collision_;
+        }
+
+        result->entries_ = entries;
+        result->entry_count_ = entry_count;
+        result->children_ = children;
+        result->child_count_ = child_count;
+        return result;
+    }
+
+    static Node* copy(Node* node, uint64_t edit) {
+        return reshape(node, edit, -1, nullptr, -1, -1, nullptr, -1);
+    }
+
+    // Operations
+
+    static const Value* lookup(const Node* node, const Key& key, size_t hash) {
+        for (uint32_t shift = 0; node != nullptr; shift += BITS_PER_LEVEL) {
+            if (node->collision_) {
+                for (uint32_t i = 0; i < node->entry_count_; ++i) {
+                    if (KeyEqual{}(node->entries_[i].first, key)) {
+                        return &node->entries_[i].second;
+                    }
+                }
+                return nullptr;
+            }
+
+            const uint32_t bit = slot(hash, shift);
+            if (node->datamap_ & bit) {
+                const Entry& entry = node->entries_[index(node->datamap_, bit)];
+                return KeyEqual{}(entry.first, key) ? &entry.second : nullptr;
+            }
+            if (!(node->nodemap_ & bit)) {
+                return nullptr;
+            }
+            node = node->children_[index(node->nodemap_, bit)];
+        }
+        return nullptr;
+    }
+
+    // Returns 'node' itself if it was updated in place, otherwise its new version (one reference)
+    static Node* insert(Node* node, Entry& entry, size_t hash, uint32_t shift, uint64_t edit, bool& added) {
+        if (node->collision_) {
+            for (uint32_t i = 0; i < node->entry_count_; ++i) {
+                if (KeyEqual{}(node->entries_[i].first, entry.first)) {
+                    return replace_value(node, i, entry, edit);
+                }
+            }
+            added = true;
+            return reshape(node, edit, -1, &entry, node->entry_count_, -1, nullptr, -1);
+        }
+
+        const uint32_t bit = slot(hash, shift);
+
+        if (node->datamap_ & bit) {
+            const uint32_t at = index(node->datamap_, bit);
+            const Entry& existing = node->entries_[at];
+            if (KeyEqual{}(existing.first, entry.first)) {
+                return replace_value(node, at, entry, edit);
+            }
+
+            // Slot taken by another key => both move one level down
+            added = true;
+            Node* child = merge(existing, Hash{}(existing.first), std::move(entry), hash, shift + BITS_PER_LEVEL, edit);
+
+            const uint32_t nodemap = node->nodemap_ | bit;
+            Node* result;
+            try {
+                result = reshape(node, edit, at, nullptr, -1, -1, child, index(nodemap, bit));
+            } catch (...) {
+                release(child);
+                throw;
+            }
+            result->datamap_ &= ~bit;
+            result->nodemap_ = nodemap;
+            return result;
+        }
+
+        if (node->nodemap_ & bit) {
+            const uint32_t at = index(node->nodemap_, bit);
+            Node* child = node->children_[at];
+            Node* updated = insert(child, entry, hash, shift + BITS_PER_LEVEL, edit, added);
+            return updated == child ? node : replace_child(node, at, updated, edit);
+        }
+
+        added = true;
+        const uint32_t datamap = node->datamap_ | bit;
+        Node* result = reshape(node, edit, -1, &entry, index(datamap, bit), -1, nullptr, -1);
+        result->datamap_ = datamap;
+        return result;
+    }
+
+    // Returns 'node' itself if nothing was removed or it was updated in place, otherwise its new version
+    static Node* remove(Node* node, const Key& key, size_t hash, uint32_t shift, uint64_t edit, bool& removed) {
+        if (node->collision_) {
+            for (uint32_t i = 0; i < node->entry_count_; ++i) {
+                if (KeyEqual{}(node->entries_[i].first, key)) {
+                    removed = true;
+                    return reshape(node, edit, i, nullptr, -1, -1, nullptr, -1);
+                }
+            }
+            return node;
+        }
+
+        const uint32_t bit = slot(hash, shift);
+
+        if (node->datamap_ & bit) {
+            const uint32_t at = index(node->datamap_, bit);
+            if (!KeyEqual{}(node->entries_[at].first, key)) {
+                return node;
+            }
+            removed = true;
+            Node* result = reshape(node, edit, at, nullptr, -1, -1, nullptr, -1);
+            result->datamap_ &= ~bit;
+            return result;
+        }
+
+        if (!(node->nodemap_ & bit)) {
+            return node;
+        }
+
+        const uint32_t at = index(node->nodemap_, bit);
+        Node* child = node->children_[at];
+        Node* updated = remove(child, key, hash, shift + BITS_PER_LEVEL, edit, removed);
+        if (!removed) {
+            return node;
+        }
+
+        if (!is_singleton(updated)) {
+            return updated == child ? node : replace_child(node, at, updated, edit);
+        }
+
+        // The child is down to one entry => it comes back inline here
+        // 'updated' is referenced only by us (new version, or owned and updated in place)
+        Entry entry(std::move_if_noexcept(updated->entries_[0]));
+        const uint32_t datamap = node->datamap_ | bit;
+        Node* result;
+        try {
+            result = reshape(node, edit, -1, &entry, index(datamap, bit), at, nullptr, -1);
+        } catch (...) {
+            if (updated != child) {
+                release(updated);
+            }
+            throw;
+        }
+        if (updated != child) {
+            release(updated);  // The child in place was released by reshape
+        }
+        result->datamap_ = datamap;
+        result->nodemap_ &= ~bit;
+        return result;
+    }
+
+    static Node* replace_value(Node* node, uint32_t at, Entry& entry, uint64_t edit) {
+        Node* result = owned(node, edit) ? node : copy(node, edit);
+        result->entries_[at].second = std::move(entry.second);
+        return result;
+    }
+
+    static Node* replace_child(Node* node, uint32_t at, Node* child, uint64_t edit) {
+        Node* result;
+        try {
+            result = owned(node, edit) ? node : copy(node, edit);
+        } catch (...) {
+            release(child);
+            throw;
+        }
+        release(result->children_[at]);
+        result->children_[at] = child;
+        return result;
+    }
+
+  private:
+    Node* root_{nullptr};
+    size_t size_{0};
+};
+}  // namespace renn::containers
@@ -0,0 +1,540 @@
+#pragma once
+
+#include "DynamicArray.hpp"
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace renn::containers {
+
+// Array of fixed-size chunks (a chunked vector / deque)
+//
+// Elements live in chunks of CHUNK_SIZE (a power of two) slots that never move; a DynamicArray of chunk
+// pointers (the index) maps positions to chunks: element i is at position p = front + i,
+// in chunk p >> SHIFT, slot p & MASK => O(1) indexing with a shift and a mask
+//
+// vs DynamicArray:
+//   + growth allocates one chunk, nothing is relocated => pointers / references to elements stay valid
+//     across push_back / push_front / pop at the other end, and peak memory stays ~1x the elements
+//     (DynamicArray holds the old and the new block at once: 3x with 2x growth)
+//   + push_front is O(1) amortized: the index keeps free slots at both ends
+//   - indexing costs an extra dependent load (the index), elements are contiguous only within a chunk
+//     (for_each_segment hands out the contiguous runs)
+// A chunk emptied by pop_front / pop_back is kept as the spare (the next chunk needed takes it) or freed if
+// there already is one, and free index slots rotate from one end to the other instead of growing the index
+// => a queue (push_back + pop_front) cycles through the same two or three chunks and a bounded index
+// Chunks allocated by reserve() stay until shrink_to_fit()
+
+template <typename T>
+inline constexpr size_t DEFAULT_CHUNK_SIZE = std::bit_floor(std::max<size_t>(16, 4096 / sizeof(T)));  // ~4KB chunks
+
+template <typename T, size_t CHUNK_SIZE = DEFAULT_CHUNK_SIZE<T>, typename Allocator = std::allocator<T>>
+class SegmentedArray {
+    static_assert(std::has_single_bit(CHUNK_SIZE), "CHUNK_SIZE must be a power of two");
+
+  private:
+    static constexpr size_t SHIFT = std::countr_zero(CHUNK_SIZE);
+    static constexpr size_t MASK = CHUNK_SIZE - 1;
+
+    template <bool CONST>
+    class Iterator {
+        using Array = std::conditional_t<CONST, const SegmentedArray, SegmentedArray>;
+
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<CONST, const T*, T*>;
+        using reference = std::conditional_t<CONST, const T&, T&>;
+
+        Iterator() = default;
+
+        Iterator(Array* array, size_t index) : array_(array), index_(index) {}
+
+        // iterator => const_iterator
+        template <bool OTHER_CONST>
+            requires(CONST && !OTHER_CONST)
+        Iterator(const Iterator<OTHER_CONST>& other) : array_(other.array_), index_(other.index_) {}
+
+        reference operator*() const {
+            return (*array_)[index_];
+        }
+
+        pointer operator->() const {
+            return &(*array_)[index_];
+        }
+
+        reference operator[](difference_type n) const {
+            return (*array_)[index_ + n];
+        }
+
+        Iterator& operator++() {
+            ++index_;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator copy = *this;
+            ++index_;
+            return copy;
+        }
+
+        Iterator& operator--() {
+            --index_;
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator copy = *this;
+            --index_;
+            return copy;
+        }
+
+        Iterator& operator+=(difference_type n) {
+            index_ += n;
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type n) {
+            index_ -= n;
+            return *this;
+        }
+
+        friend Iterator operator+(Iterator it, difference_type n) {
+            return it += n;
+        }
+
+        friend Iterator operator+(difference_type n, Iterator it) {
+            return it += n;
+        }
+
+        friend Iterator operator-(Iterator it, difference_type n) {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const Iterator& a, const Iterator& b) {
+            return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) {
+            return a.index_ == b.index_;
+        }
+
+        friend auto operator<=>(const Iterator& a, const Iterator& b) {
+            return a.index_ <=> b.index_;
+        }
+
+      private:
+        template <bool>
+        friend class Iterator;
+
+        Array* array_{nullptr};
+        size_t index_{0};
+    };
+
+  public:
+    using allocator_type = Allocator;
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_t chunk_size() noexcept {
+        return CHUNK_SIZE;
+    }
+
+    SegmentedArray() = default;
+
+    explicit SegmentedArray(const Allocator& alloc) : allocator_(alloc) {}
+
+    explicit SegmentedArray(size_t n) {
+        resize(n);
+    }
+
+    SegmentedArray(size_t n, const T& value) {
+        for (size_t i = 0; i < n; ++i) {
+            push_back(value);
+        }
+    }
+
+    SegmentedArray(std::initializer_list<T> ilist) {
+        for (const T& item : ilist) {
+            push_back(item);
+        }
+    }
+
+    SegmentedArray(const SegmentedArray& other)
+        : allocator_(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.allocator_)) {
+        for (size_t i = 0; i < other.size_; ++i) {
+            push_back(other[i]);
+        }
+    }
+
+    SegmentedArray(SegmentedArray&& other) noexcept
+        : index_(std::move(other.index_)),
+          front_(std::exchange(other.front_, 0)),
+          size_(std::exchange(other.size_, 0)),
+          spare_(std::exchange(other.spare_, nullptr)),
+          allocator_(std::move(other.allocator_)) {}
+
+    SegmentedArray& operator=(const SegmentedArray& other) {
+        if (this != &other) {
+            SegmentedArray tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    SegmentedArray& operator=(SegmentedArray&& other) noexcept {
+        if (this != &other) {
+            release();
+            index_ = std::move(other.index_);
+            front_ = std::exchange(other.front_, 0);
+            size_ = std::exchange(other.size_, 0);
+            spare_ = std::exchange(other.spare_, nullptr);
+            allocator_ = std::move(other.allocator_);
+        }
+        return *this;
+    }
+
+    ~SegmentedArray() {
+        release();
+    }
+
+    T& operator[](size_t index) {
+        const size_t position = front_ + index;
+        return index_[position >> SHIFT][position & MASK];
+    }
+
+    const T& operator[](size_t index) const {
+        const size_t position = front_ + index;
+        return index_[position >> SHIFT][position & MASK];
+    }
+
+    T& at(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    const T& at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    T& front() {
+        return (*this)[0];
+    }
+
+    const T& front() const {
+        return (*this)[0];
+    }
+
+    T& back() {
+        return (*this)[size_ - 1];
+    }
+
+    const T& back() const {
+        return (*this)[size_ - 1];
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(this, size_);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, size_);
+    }
+
+    const_iterator cend() const noexcept {
+        return const_iterator(this, size_);
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return const_reverse_iterator(cend());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return const_reverse_iterator(cbegin());
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    // Returns the new element: its address is stable until it is popped or erased
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (((front_ + size_) >> SHIFT) >= index_.size()) {
+            open_back();
+        }
+        const size_t position = front_ + size_;
+        T* slot = slot_at(position);  // Allocates before anything changes => the args may refer to elements
+        std::allocator_traits<Allocator>::construct(allocator_, slot, std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void push_front(const T& value) {
+        emplace_front(value);
+    }
+
+    void push_front(T&& value) {
+        emplace_front(std::move(value));
+    }
+
+    template <typename... Args>
+    T& emplace_front(Args&&... args) {
+        if (front_ == 0) {
+            open_front();
+        }
+        T* slot = slot_at(front_ - 1);
+        std::allocator_traits<Allocator>::construct(allocator_, slot, std::forward<Args>(args)...);
+        --front_;
+        ++size_;
+        return *slot;
+    }
+
+    void pop_back() {
+        if (size_ > 0) {
+            std::allocator_traits<Allocator>::destroy(allocator_, &back());
+            --size_;
+            const size_t end = front_ + size_;
+            if ((end & MASK) == 0) {
+                release_chunk(end >> SHIFT);  // The popped element was the first of its chunk
+            }
+        }
+    }
+
+    void pop_front() {
+        if (size_ > 0) {
+            std::allocator_traits<Allocator>::destroy(allocator_, &front());
+            ++front_;
+            --size_;
+            if ((front_ & MASK) == 0) {
+                release_chunk((front_ >> SHIFT) - 1);  // The popped element was the last of its chunk
+            }
+        }
+    }
+
+    void resize(size_t new_size) {
+        while (size_ > new_size) {
+            pop_back();
+        }
+        while (size_ < new_size) {
+            emplace_back();
+        }
+    }
+
+    // Allocates the chunks for 'new_capacity' elements past the front
+    void reserve(size_t new_capacity) {
+        if (new_capacity > size_) {
+            const size_t last = (front_ + new_capacity - 1) >> SHIFT;
+            slot_at(front_ + new_capacity - 1);
+            for (size_t chunk = (front_ + size_) >> SHIFT; chunk < last; ++chunk) {
+                if (index_[chunk] == nullptr) {
+                    index_[chunk] = take_chunk();
+                }
+            }
+        }
+    }
+
+    // Calls f(T* data, size_t count) for every contiguous run, in order
+    template <typename Function>
+    void for_each_segment(Function&& f) {
+        for_each_segment_impl(*this, f);
+    }
+
+    template <typename Function>
+    void for_each_segment(Function&& f) const {
+        for_each_segment_impl(*this, f);
+    }
+
+    // Frees the chunks holding no elements and the unused index slots
+    void shrink_to_fit() {
+        if (size_ == 0) {
+            release();
+            return;
+        }
+        free_chunk(std::exchange(spare_, nullptr));
+
+        const size_t first = front_ >> SHIFT;
+        const size_t last = (front_ + size_ - 1) >> SHIFT;
+
+        DynamicArray<T*> index;
+        index.reserve(last - first + 1);
+        for (size_t chunk = 0; chunk < index_.size(); ++chunk) {
+            if (chunk < first || chunk > last) {
+                free_chunk(index_[chunk]);
+            } else {
+                index.push_back(index_[chunk]);
+            }
+        }
+        index_ = std::move(index);
+        front_ -= first << SHIFT;
+    }
+
+    // Destroys the elements, keeps the chunks
+    void clear() noexcept {
+        for (; size_ > 0; --size_) {
+            std::allocator_traits<Allocator>::destroy(allocator_, &back());
+        }
+        // Recentered => pushes at either end reuse the kept chunks
+        front_ = (index_.size() / 2) << SHIFT;
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    // Elements that fit in the allocated chunks past the front without allocating
+    size_t capacity() const noexcept {
+        size_t chunks = 0;
+        for (size_t chunk = front_ >> SHIFT; chunk < index_.size() && index_[chunk] != nullptr; ++chunk) {
+            ++chunks;
+        }
+        return chunks == 0 ? 0 : (chunks << SHIFT) - (front_ & MASK);
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+  private:
+    template <typename Self, typename Function>
+    static void for_each_segment_impl(Self& self, Function& f) {
+        using Pointer = std::conditional_t<std::is_const_v<Self>, const T*, T*>;
+        size_t position = self.front_;
+        const size_t end = self.front_ + self.size_;
+        while (position < end) {
+            const size_t run = std::min(CHUNK_SIZE - (position & MASK), end - position);
+            f(static_cast<Pointer>(self.index_[position >> SHIFT] + (position & MASK)), run);
+            position += run;
+        }
+    }
+
+    T* allocate_chunk() {
+        return allocator_.allocate(CHUNK_SIZE);
+    }
+
+    void free_chunk(T* chunk) noexcept {
+        if (chunk != nullptr) {
+            allocator_.deallocate(chunk, CHUNK_SIZE);
+        }
+    }
+
+    T* take_chunk() {
+        return spare_ != nullptr ? std::exchange(spare_, nullptr) : allocate_chunk();
+    }
+
+    // An emptied chunk leaves the index: kept as the spare, freed if there is one already
+    void release_chunk(size_t chunk) noexcept {
+        T* emptied = std::exchange(index_[chunk], nullptr);
+        if (spare_ == nullptr) {
+            spare_ = emptied;
+        } else {
+            free_chunk(emptied);
+        }
+    }
+
+    // Slot of 'position', allocating its chunk (and index slots at the back) if needed
+    T* slot_at(size_t position) {
+        const size_t chunk = position >> SHIFT;
+        if (chunk >= index_.size()) {
+            // Grows geometrically through DynamicArray::push_back => O(1) amortized
+            while (index_.size() <= chunk) {
+                index_.push_back(nullptr);
+            }
+        }
+        if (index_[chunk] == nullptr) {
+            index_[chunk] = take_chunk();
+        }
+        return index_[chunk] + (position & MASK);
+    }
+
+    // The back is at the end of the index: if at least half of it is free slots in front (left by pop_front),
+    // they rotate to the back, otherwise slot_at grows the index => bounded index for a queue
+    void open_back() {
+        const size_t first = front_ >> SHIFT;
+        if (first > 0 && first * 2 >= index_.size()) {
+            std::rotate(index_.begin(), index_.begin() + first, index_.end());
+            front_ -= first << SHIFT;
+        }
+    }
+
+    // Free index slots in front: the free slots past the back if they are at least half of the index,
+    // else as many new ones as are in use (at least one) => push_front is O(1) amortized
+    void open_front() {
+        const size_t used_end = size_ == 0 ? 0 : ((front_ + size_ - 1) >> SHIFT) + 1;
+        const size_t tail = index_.size() - used_end;
+        if (tail > 0 && tail * 2 >= index_.size()) {
+            std::rotate(index_.begin(), index_.begin() + used_end, index_.end());
+            front_ += tail << SHIFT;
+            return;
+        }
+
+        const size_t slack = std::max<size_t>(1, index_.size());
+        DynamicArray<T*> index(index_.size() + slack, nullptr);
+        std::copy(index_.begin(), index_.end(), index.begin() + slack);
+        index_ = std::move(index);
+        front_ += slack << SHIFT;
+    }
+
+    void release() noexcept {
+        while (size_ > 0) {
+            pop_back();
+        }
+        for (T* chunk : index_) {
+            free_chunk(chunk);
+        }
+        free_chunk(std::exchange(spare_, nullptr));
+        index_ = DynamicArray<T*>();
+        front_ = 0;
+    }
+
+  private:
+    DynamicArray<T*> index_;  // Chunk pointers, nullptr for chunks not allocated yet
+    size_t front_{0};         // Position of element 0
+    size_t size_{0};
+    T* spare_{nullptr};       // Last emptied chunk, not in the index
+    Allocator allocator_;
+};
+}  // namespace renn::containers
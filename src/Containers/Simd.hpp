@@ -0,0 +1,255 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#    include <immintrin.h>
+#endif
+
+namespace renn::containers::simd {
+
+// Search / compaction kernels over arrays of arithmetic T (DynamicArray::find / count / erase)
+//
+// Dispatch is at compile time like BlockedBloomFilter: AVX2 (32 bytes per step) when built with -mavx2,
+// else SSE2 (16 bytes, always there on x86-64), else plain loops. Element sizes 1/2/4/8: every
+// comparison is turned into a byte mask (movemask_epi8) => sizeof(T) bits per element
+// Floating point compares ordered-equal, the same as operator== (NaN matches nothing, -0.0 == 0.0)
+//
+// remove / remove_if compact in one pass: kept elements are written to 'out' as they are read
+// (no shifting of the tail per erased element)
+//   AVX2, 4/8-byte T: a permutation from a lookup table packs the kept lanes of a block, one store
+//   otherwise: blocks without matches are copied with one store, blocks of only matches are skipped,
+//   mixed blocks go element by element
+
+// Integers (bool and chars included), float, double; not long double (padding bytes, no vector compare)
+// nor __int128 (integral under gnu++ modes, but wider than the widest lane compare) => those take std::find
+template <typename T>
+concept Arithmetic =
+    (std::is_integral_v<T> || std::is_same_v<T, float> || std::is_same_v<T, double>) && sizeof(T) <= 8;
+
+namespace detail {
+
+#if defined(__AVX2__)
+using Vector = __m256i;
+#elif defined(__SSE2__)
+using Vector = __m128i;
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+inline constexpr size_t VECTOR_BYTES = sizeof(Vector);
+
+inline Vector load(const void* p) noexcept {
+#    if defined(__AVX2__)
+    return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+#    else
+    return _mm_loadu_si128(static_cast<const __m128i*>(p));
+#    endif
+}
+
+inline void store(void* p, Vector v) noexcept {
+#    if defined(__AVX2__)
+    _mm256_storeu_si256(static_cast<__m256i*>(p), v);
+#    else
+    _mm_storeu_si128(static_cast<__m128i*>(p), v);
+#    endif
+}
+
+// All-ones in the lanes of the block equal to 'value'
+template <Arithmetic T>
+Vector equal_lanes(const T* p, T value) noexcept {
+#    if defined(__AVX2__)
+    __m256i eq;
+    if constexpr (std::is_same_v<T, float>) {
+        eq = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(p), _mm256_set1_ps(value), _CMP_EQ_OQ));
+    } else if constexpr (std::is_same_v<T, double>) {
+        eq = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_loadu_pd(p), _mm256_set1_pd(value), _CMP_EQ_OQ));
+    } else {
+        const __m256i block = load(p);
+        if constexpr (sizeof(T) == 1) {
+            eq = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(static_cast<char>(value)));
+        } else if constexpr (sizeof(T) == 2) {
+            eq = _mm256_cmpeq_epi16(block, _mm256_set1_epi16(static_cast<short>(value)));
+        } else if constexpr (sizeof(T) == 4) {
+            eq = _mm256_cmpeq_epi32(block, _mm256_set1_epi32(static_cast<int>(value)));
+        } else {
+            eq = _mm256_cmpeq_epi64(block, _mm256_set1_epi64x(static_cast<long long>(value)));
+        }
+    }
+    return eq;
+#    else
+    __m128i eq;
+    if constexpr (std::is_same_v<T, float>) {
+        eq = _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(p), _mm_set1_ps(value)));
+    } else if constexpr (std::is_same_v<T, double>) {
+        eq = _mm_castpd_si128(_mm_cmpeq_pd(_mm_loadu_pd(p), _mm_set1_pd(value)));
+    } else {
+        const __m128i block = load(p);
+        if constexpr (sizeof(T) == 1) {
+            eq = _mm_cmpeq_epi8(block, _mm_set1_epi8(static_cast<char>(value)));
+        } else if constexpr (sizeof(T) == 2) {
+            eq = _mm_cmpeq_epi16(block, _mm_set1_epi16(static_cast<short>(value)));
+        } else if constexpr (sizeof(T) == 4) {
+            eq = _mm_cmpeq_epi32(block, _mm_set1_epi32(static_cast<int>(value)));
+        } else {
+            // No 64-bit compare before SSE4.1 => both 32-bit halves must match
+            eq = _mm_cmpeq_epi32(block, _mm_set1_epi64x(static_cast<long long>(value)));
+            eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    }
+    return eq;
+#    endif
+}
+
+// One bit per byte of the block, set for the bytes of elements equal to 'value'
+template <Arithmetic T>
+uint32_t equal_mask(const T* p, T value) noexcept {
+#    if defined(__AVX2__)
+    return static_cast<uint32_t>(_mm256_movemask_epi8(equal_lanes(p, value)));
+#    else
+    return static_cast<uint32_t>(_mm_movemask_epi8(equal_lanes(p, value)));
+#    endif
+}
+
+inline constexpr uint32_t FULL_MASK = VECTOR_BYTES == 32 ? 0xFFFFFFFFu : 0xFFFFu;
+#endif
+
+#if defined(__AVX2__)
+// For every 8-bit set of kept 32-bit lanes: lane indices that pack them to the front
+inline constexpr auto PACK_32 = [] {
+    std::array<std::array<uint32_t, 8>, 256> table{};
+    for (uint32_t keep = 0; keep < 256; ++keep) {
+        uint32_t out = 0;
+        for (uint32_t lane = 0; lane < 8; ++lane) {
+            if (keep & (1u << lane)) {
+                table[keep][out++] = lane;
+            }
+        }
+    }
+    return table;
+}();
+
+// Same for 4 kept 64-bit lanes, as pairs of 32-bit lanes
+inline constexpr auto PACK_64 = [] {
+    std::array<std::array<uint32_t, 8>, 16> table{};
+    for (uint32_t keep = 0; keep < 16; ++keep) {
+        uint32_t out = 0;
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            if (keep & (1u << lane)) {
+                table[keep][out++] = 2 * lane;
+                table[keep][out++] = 2 * lane + 1;
+            }
+        }
+    }
+    return table;
+}();
+#endif
+
+}  // namespace detail
+
+// Index of the first element equal to 'value', 'size' if none
+template <Arithmetic T>
+size_t find(const T* data, size_t size, T value) noexcept {
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+    constexpr size_t LANES = detail::VECTOR_BYTES / sizeof(T);
+    for (; i + LANES <= size; i += LANES) {
+        if (const uint32_t mask = detail::equal_mask(data + i, value)) {
+            return i + static_cast<size_t>(std::countr_zero(mask)) / sizeof(T);
+        }
+    }
+#endif
+    for (; i < size; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return size;
+}
+
+template <Arithmetic T>
+size_t count(const T* data, size_t size, T value) noexcept {
+    size_t result = 0;
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+    constexpr size_t LANES = detail::VECTOR_BYTES / sizeof(T);
+    for (; i + LANES <= size; i += LANES) {
+        result += static_cast<size_t>(std::popcount(detail::equal_mask(data + i, value)));
+    }
+    result /= sizeof(T);
+#endif
+    for (; i < size; ++i) {
+        result += data[i] == value;
+    }
+    return result;
+}
+
+// Removes every element equal to 'value' keeping the order of the others, returns the new size
+// The elements past it are left with unspecified values
+template <Arithmetic T>
+size_t remove(T* data, size_t size, T value) noexcept {
+    size_t out = 0;
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+    constexpr size_t LANES = detail::VECTOR_BYTES / sizeof(T);
+    // out <= i => a full-width store at 'out' only overwrites elements already loaded
+    for (; i + LANES <= size; i += LANES) {
+#    if defined(__AVX2__)
+        if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+            const __m256i block = detail::load(data + i);
+            const __m256i eq = detail::equal_lanes(data + i, value);
+            uint32_t keep;
+            __m256i permutation;
+            if constexpr (sizeof(T) == 4) {
+                keep = ~static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(eq))) & 0xFFu;
+                permutation = detail::load(detail::PACK_32[keep].data());
+            } else {
+                keep = ~static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(eq))) & 0xFu;
+                permutation = detail::load(detail::PACK_64[keep].data());
+            }
+            detail::store(data + out, _mm256_permutevar8x32_epi32(block, permutation));
+            out += static_cast<size_t>(std::popcount(keep));
+            continue;
+        }
+#    endif
+
+        const uint32_t mask = detail::equal_mask(data + i, value);
+        if (mask == 0) {
+            if (out != i) {
+                detail::store(data + out, detail::load(data + i));
+            }
+            out += LANES;
+        } else if (mask != detail::FULL_MASK) {
+            for (size_t j = i; j < i + LANES; ++j) {
+                data[out] = data[j];
+                out += !(data[j] == value);
+            }
+        }
+    }
+#endif
+    for (; i < size; ++i) {
+        data[out] = data[i];
+        out += !(data[i] == value);
+    }
+    return out;
+}
+
+// Removes every element for which pred(element) holds, keeping the order of the others, returns the new size
+// The predicate is opaque => no vector compare, but the compaction is branch-free: every element is
+// written to 'out', which only advances past the kept ones
+template <Arithmetic T, typename Predicate>
+size_t remove_if(T* data, size_t size, Predicate&& pred) {
+    size_t out = 0;
+    for (size_t i = 0; i < size; ++i) {
+        const T item = data[i];
+        data[out] = item;
+        out += !static_cast<bool>(pred(item));
+    }
+    return out;
+}
+
+}  // namespace renn::containers::simd
@@ -0,0 +1,544 @@
+#pragma once
+
+#include "DynamicArray.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace renn::containers {
+
+// DynamicArray with inline storage for small sizes
+//
+// Up to N elements live in an inline buffer => an empty or small array performs no allocation
+// (a DynamicArray allocates on its first push_back)
+// Growing past N moves everything into a DynamicArray<T, Allocator>, which is kept until clear()
+// Elements are contiguous in both modes => iterators are plain pointers, as for DynamicArray
+//
+// Moving a small array moves its elements one by one (there is no pointer to steal)
+
+template <typename T, size_t N = 8, typename Allocator = std::allocator<T>>
+class SmallArray {
+    static_assert(N > 0, "SmallArray needs at least one inline slot");
+
+  private:
+    using LargeArray = DynamicArray<T, Allocator>;
+
+  public:
+    using allocator_type = Allocator;
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    SmallArray() = default;
+
+    explicit SmallArray(size_t n) {
+        resize(n);
+    }
+
+    SmallArray(size_t n, const T& value) {
+        assign(n, value);
+    }
+
+    SmallArray(std::initializer_list<T> ilist) {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    SmallArray(const SmallArray& other) {
+        large_.set_growth_factor(other.growth_factor());
+        if (!other.is_small()) {
+            large_ = other.large_;
+        } else {
+            for (size_t i = 0; i < other.small_size_; ++i) {
+                std::construct_at(slot(i), *other.slot(i));
+                ++small_size_;
+            }
+        }
+    }
+
+    SmallArray(SmallArray&& other) noexcept : large_(std::move(other.large_)) {
+        for (size_t i = 0; i < other.small_size_; ++i) {
+            std::construct_at(slot(i), std::move(*other.slot(i)));
+        }
+        small_size_ = other.small_size_;
+        other.destroy_small();
+    }
+
+    SmallArray& operator=(const SmallArray& other) {
+        if (this != &other) {
+            SmallArray tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    SmallArray& operator=(SmallArray&& other) noexcept {
+        if (this != &other) {
+            destroy_small();
+            large_ = std::move(other.large_);
+
+            for (size_t i = 0; i < other.small_size_; ++i) {
+                std::construct_at(slot(i), std::move(*other.slot(i)));
+            }
+            small_size_ = other.small_size_;
+            other.destroy_small();
+        }
+        return *this;
+    }
+
+    ~SmallArray() {
+        destroy_small();
+    }
+
+    void assign(size_t n, const T& value) {
+        T copy(value);  // 'value' may be an element
+        clear();
+        reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            push_back(copy);
+        }
+    }
+
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        if constexpr (std::forward_iterator<InputIt>) {
+            reserve(static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    void assign(std::initializer_list<T> ilist) {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    T& operator[](size_t index) {
+        return data()[index];
+    }
+
+    const T& operator[](size_t index) const {
+        return data()[index];
+    }
+
+    T& at(size_t index) {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data()[index];
+    }
+
+    const T& at(size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data()[index];
+    }
+
+    T& front() {
+        return data()[0];
+    }
+
+    const T& front() const {
+        return data()[0];
+    }
+
+    T& back() {
+        return data()[size() - 1];
+    }
+
+    const T& back() const {
+        return data()[size() - 1];
+    }
+
+    T* data() noexcept {
+        return is_small() ? slot(0) : large_.begin();
+    }
+
+    const T* data() const noexcept {
+        return is_small() ? slot(0) : large_.cbegin();
+    }
+
+    iterator begin() noexcept {
+        return data();
+    }
+
+    const_iterator begin() const noexcept {
+        return data();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return data();
+    }
+
+    iterator end() noexcept {
+        return data() + size();
+    }
+
+    const_iterator end() const noexcept {
+        return data() + size();
+    }
+
+    const_iterator cend() const noexcept {
+        return data() + size();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return const_reverse_iterator(cend());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return const_reverse_iterator(cbegin());
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        if (!is_small()) {
+            large_.emplace_back(std::forward<Args>(args)...);
+            return;
+        }
+
+        if (small_size_ == N) {
+            T item(std::forward<Args>(args)...);  // The arguments may refer to inline elements
+            grow(N + 1);
+            large_.push_back(std::move(item));
+            return;
+        }
+
+        std::construct_at(slot(small_size_), std::forward<Args>(args)...);
+        ++small_size_;
+    }
+
+    template <typename U>
+    void insert(size_t index, U&& value) {
+        if (index > size()) {
+            throw std::out_of_range("Index out of range (insert)");
+        }
+
+        if (!is_small()) {
+            large_.insert(index, std::forward<U>(value));
+            return;
+        }
+
+        // Appended, then rotated into place: at most N moves
+        emplace_back(std::forward<U>(value));
+        std::rotate(begin() + index, end() - 1, end());
+    }
+
+    template <typename U>
+    iterator insert(iterator pos, U&& value) {
+        size_t index = pos - begin();
+        insert(index, std::forward<U>(value));
+        return begin() + index;
+    }
+
+    template <typename InputIt>
+    void insert(size_t index, InputIt first, InputIt last) {
+        if (index > size()) {
+            throw std::out_of_range("Index out of range");
+        }
+
+        const size_t count = std::distance(first, last);
+        if (is_small() && small_size_ + count > N) {
+            grow(small_size_ + count);
+        }
+
+        if (!is_small()) {
+            large_.insert(index, first, last);
+            return;
+        }
+
+        const size_t old_size = small_size_;
+        for (; first != last; ++first) {
+            std::construct_at(slot(small_size_), *first);
+            ++small_size_;
+        }
+        std::rotate(begin() + index, begin() + old_size, end());
+    }
+
+    template <typename InputIt>
+    iterator insert(iterator position, InputIt first, InputIt last) {
+        size_t index = position - begin();
+        insert(index, first, last);
+        return begin() + index;
+    }
+
+    void insert(size_t index, std::initializer_list<T> ilist) {
+        insert(index, ilist.begin(), ilist.end());
+    }
+
+    template <std::ranges::input_range Range>
+    void append_range(Range&& range) {
+        insert_range(size(), std::forward<Range>(range));
+    }
+
+    template <std::ranges::input_range Range>
+    void insert_range(size_t index, Range&& range) {
+        if (index > size()) {
+            throw std::out_of_range("Index out of range (insert_range)");
+        }
+
+        if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>) {
+            const auto count = static_cast<size_t>(std::ranges::distance(range));
+            if (is_small() && small_size_ + count > N) {
+                grow(small_size_ + count);
+            }
+        }
+
+        if (!is_small()) {
+            large_.insert_range(index, std::forward<Range>(range));
+            return;
+        }
+
+        // Fits inline (or a single-pass range of unknown length: may move to the heap midway)
+        const size_t old_size = small_size_;
+        for (auto&& item : range) {
+            emplace_back(std::forward<decltype(item)>(item));
+        }
+        std::rotate(begin() + index, begin() + old_size, end());
+    }
+
+    void pop_back() {
+        if (!is_small()) {
+            large_.pop_back();
+        } else if (small_size_ > 0) {
+            --small_size_;
+            std::destroy_at(slot(small_size_));
+        }
+    }
+
+    // Not for arrays of size_t, where it would be ambiguous with erase(value): use erase_at_index there
+    void erase(size_t index)
+        requires(!std::is_same_v<T, size_t>)
+    {
+        erase_at_index(index);
+    }
+
+    size_t erase(const T& value) {
+        if (!is_small()) {
+            return large_.erase(value);
+        }
+
+        if constexpr (simd::Arithmetic<T>) {
+            return truncate_small(simd::remove(slot(0), small_size_, value));
+        } else {
+            return truncate_small(static_cast<size_t>(std::remove(begin(), end(), value) - begin()));
+        }
+    }
+
+    template <typename Predicate>
+    size_t erase_if(Predicate pred) {
+        if (!is_small()) {
+            return large_.erase_if(pred);
+        }
+
+        if constexpr (simd::Arithmetic<T>) {
+            return truncate_small(simd::remove_if(slot(0), small_size_, pred));
+        } else {
+            return truncate_small(static_cast<size_t>(std::remove_if(begin(), end(), pred) - begin()));
+        }
+    }
+
+    iterator find(const T& value) {
+        return begin() + index_of(value);
+    }
+
+    const_iterator find(const T& value) const {
+        return cbegin() + index_of(value);
+    }
+
+    bool contains(const T& value) const {
+        return index_of(value) != size();
+    }
+
+    size_t count(const T& value) const {
+        if constexpr (simd::Arithmetic<T>) {
+            return simd::count(data(), size(), value);
+        } else {
+            return static_cast<size_t>(std::count(cbegin(), cend(), value));
+        }
+    }
+
+    iterator erase(iterator pos) {
+        const size_t index = static_cast<size_t>(pos - begin());
+        erase_at_index(index);
+        return begin() + index;
+    }
+
+    void erase_at_index(size_t index) {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+
+        if (!is_small()) {
+            large_.erase_at_index(index);
+            return;
+        }
+
+        std::move(begin() + index + 1, end(), begin() + index);
+        pop_back();
+    }
+
+    void reserve(size_t new_capacity) {
+        if (!is_small()) {
+            large_.reserve(new_capacity);
+        } else if (new_capacity > N) {
+            grow(new_capacity);
+        }
+    }
+
+    // Only shrinks the heap block, the elements don't move back inline
+    void shrink_to_fit() {
+        if (!is_small()) {
+            large_.shrink_to_fit();
+        }
+    }
+
+    double growth_factor() const noexcept {
+        return large_.growth_factor();
+    }
+
+    void set_growth_factor(double factor) {
+        large_.set_growth_factor(factor);
+    }
+
+    void resize(size_t new_size) {
+        if (is_small() && new_size > N) {
+            grow(new_size);
+        }
+
+        if (!is_small()) {
+            large_.resize(new_size);
+            return;
+        }
+
+        while (small_size_ > new_size) {
+            pop_back();
+        }
+        for (; small_size_ < new_size; ++small_size_) {
+            std::construct_at(slot(small_size_));
+        }
+    }
+
+    void resize_for_overwrite(size_t new_size) {
+        if (is_small() && new_size > N) {
+            grow(new_size);
+        }
+
+        if (!is_small()) {
+            large_.resize_for_overwrite(new_size);
+            return;
+        }
+
+        while (small_size_ > new_size) {
+            pop_back();
+        }
+        for (; small_size_ < new_size; ++small_size_) {
+            ::new (static_cast<void*>(slot(small_size_))) T;
+        }
+    }
+
+    // Returns to the inline representation
+    void clear() {
+        if (!is_small()) {
+            const double factor = large_.growth_factor();
+            large_ = LargeArray();
+            large_.set_growth_factor(factor);
+        }
+        destroy_small();
+    }
+
+    size_t size() const noexcept {
+        return is_small() ? small_size_ : large_.size();
+    }
+
+    size_t capacity() const noexcept {
+        return is_small() ? N : large_.capacity();
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    // true while the elements are stored inline
+    bool is_small() const noexcept {
+        return large_.capacity() == 0;
+    }
+
+    static constexpr size_t inline_capacity() noexcept {
+        return N;
+    }
+
+  private:
+    T* slot(size_t i) noexcept {
+        return std::launder(reinterpret_cast<T*>(storage_)) + i;
+    }
+
+    const T* slot(size_t i) const noexcept {
+        return std::launder(reinterpret_cast<const T*>(storage_)) + i;
+    }
+
+    size_t index_of(const T& value) const {
+        if constexpr (simd::Arithmetic<T>) {
+            return simd::find(data(), size(), value);
+        } else {
+            return static_cast<size_t>(std::find(cbegin(), cend(), value) - cbegin());
+        }
+    }
+
+    size_t truncate_small(size_t new_size) noexcept {
+        const size_t removed = small_size_ - new_size;
+        std::destroy(slot(new_size), slot(small_size_));
+        small_size_ = new_size;
+        return removed;
+    }
+
+    // Moves the inline elements into the DynamicArray, with room for at least 'needed'
+    void grow(size_t needed) {
+        large_.reserve(std::max(needed, 2 * N));
+
+        for (size_t i = 0; i < small_size_; ++i) {
+            large_.push_back(std::move(*slot(i)));
+        }
+
+        destroy_small();
+    }
+
+    void destroy_small() noexcept {
+        std::destroy_n(slot(0), small_size_);
+        small_size_ = 0;
+    }
+
+  private:
+    alignas(T) unsigned char storage_[N * sizeof(T)];
+    size_t small_size_{0};
+    LargeArray large_;  // Non-zero capacity => heap representation
+};
+}  // namespace renn::containers
@@ -0,0 +1,578 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace renn::containers {
+
+// List with up to K elements per node (an unrolled linked list)
+//
+// List pays two pointers and one allocation per element, and every step of an iteration is a pointer
+// chase to a node somewhere else in memory. Here a node holds a small array of K slots plus one pair
+// of links => for small T the pointer overhead drops by ~K times, and iteration walks contiguous slots
+//
+// The elements of a node occupy slots [first, last):
+//   - push_back / pop_front (a queue) touch only the ends of the end nodes => O(1), no shifting,
+//     a node is freed once its last element is popped
+//   - push_front fills the first node downwards (a new front node starts at its last slot)
+//   - insert in the middle shifts the shorter side of its node; a full node is split in half first
+//   - erase shifts the shorter side; a node left less than a quarter full is merged with its next one
+//     when both fit in 3/4 of a node (slack for the next inserts, no split/merge ping-pong)
+// Same iterator interface as List, but insert / erase invalidate the iterators into the nodes they
+// touch (elements move between slots); iterators into other nodes stay valid
+
+template <typename T>
+inline constexpr size_t DEFAULT_UNROLLED_NODE_SIZE = std::max<size_t>(4, 480 / sizeof(T));  // ~512-byte nodes
+
+template <typename T, size_t K = DEFAULT_UNROLLED_NODE_SIZE<T>, typename Allocator = std::allocator<T>>
+class UnrolledList {
+    static_assert(K >= 2, "A node must hold at least two elements");
+    static_assert(K <= UINT32_MAX, "Slot indices are 32-bit");
+
+  private:
+    struct BaseNode {
+        BaseNode* prev;
+        BaseNode* next;
+        uint32_t first{0};  // Occupied slots: [first, last); both 0 for the sentinel
+        uint32_t last{0};
+
+        BaseNode() : prev(this), next(this) {}
+
+        size_t count() const noexcept {
+            return last - first;
+        }
+    };
+
+    struct Node : BaseNode {
+        alignas(T) unsigned char storage_[K * sizeof(T)];
+
+        T* slot(size_t i) noexcept {
+            return std::launder(reinterpret_cast<T*>(storage_)) + i;
+        }
+    };
+
+    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+
+    static Node* as_node(BaseNode* node) noexcept {
+        return static_cast<Node*>(node);
+    }
+
+  public:
+    using allocator_type = Allocator;
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+
+    template <bool is_const>
+    class Iterator {
+      public:
+        using value_type = std::conditional_t<is_const, const T, T>;
+        using reference = std::conditional_t<is_const, const T&, T&>;
+        using pointer = std::conditional_t<is_const, const T*, T*>;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+
+        Iterator(BaseNode* node, size_t slot) : node_(node), slot_(slot) {}
+
+        reference operator*() const {
+            return *as_node(node_)->slot(slot_);
+        }
+
+        pointer operator->() const {
+            return as_node(node_)->slot(slot_);
+        }
+
+        Iterator& operator++() {
+            if (++slot_ == node_->last) {
+                node_ = node_->next;
+                slot_ = node_->first;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        Iterator& operator--() {
+            if (slot_ == node_->first) {
+                node_ = node_->prev;
+                slot_ = node_->last;
+            }
+            --slot_;
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return node_ == other.node_ && slot_ == other.slot_;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+
+        operator Iterator<true>() const {
+            return Iterator<true>(node_, slot_);
+        }
+
+      private:
+        friend class UnrolledList;
+
+        BaseNode* node_{nullptr};
+        size_t slot_{0};
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_t node_capacity() noexcept {
+        return K;
+    }
+
+    UnrolledList() = default;
+
+    UnrolledList(std::initializer_list<T> ilist) {
+        for (const T& value : ilist) {
+            push_back(value);
+        }
+    }
+
+    UnrolledList(const UnrolledList& other) {
+        for (const T& value : other) {
+            push_back(value);
+        }
+    }
+
+    UnrolledList(UnrolledList&& other) noexcept : node_allocator_(std::move(other.node_allocator_)) {
+        steal(other);
+    }
+
+    ~UnrolledList() {
+        clear();
+    }
+
+    UnrolledList& operator=(const UnrolledList& other) {
+        if (this != &other) {
+            clear();
+            for (const T& value : other) {
+                push_back(value);
+            }
+        }
+        return *this;
+    }
+
+    UnrolledList& operator=(UnrolledList&& other) noexcept {
+        if (this != &other) {
+            clear();
+            node_allocator_ = std::move(other.node_allocator_);
+            steal(other);
+        }
+        return *this;
+    }
+
+    bool operator==(const UnrolledList& other) const {
+        return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+    }
+
+    bool operator!=(const UnrolledList& other) const {
+        return !(*this == other);
+    }
+
+    iterator begin() noexcept {
+        return iterator(sentinel_.next, sentinel_.next->first);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(sentinel_.next, sentinel_.next->first);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(&sentinel_, 0);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(const_cast<BaseNode*>(&sentinel_), 0);
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    void push_back(const T& value) {
+        emplace(end(), value);
+    }
+
+    void push_back(T&& value) {
+        emplace(end(), std::move(value));
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        return *emplace(end(), std::forward<Args>(args)...);
+    }
+
+    void push_front(const T& value) {
+        emplace(begin(), value);
+    }
+
+    void push_front(T&& value) {
+        emplace(begin(), std::move(value));
+    }
+
+    template <typename... Args>
+    T& emplace_front(Args&&... args) {
+        return *emplace(begin(), std::forward<Args>(args)...);
+    }
+
+    void pop_back() {
+        erase(--end());
+    }
+
+    void pop_front() {
+        erase(begin());
+    }
+
+    T& front() {
+        if (empty()) {
+            throw std::out_of_range("List is empty!");
+        }
+        return *begin();
+    }
+
+    const T& front() const {
+        if (empty()) {
+            throw std::out_of_range("List is empty!");
+        }
+        return *begin();
+    }
+
+    T& back() {
+        if (empty()) {
+            throw std::out_of_range("List is empty!");
+        }
+        return *--end();
+    }
+
+    const T& back() const {
+        if (empty()) {
+            throw std::out_of_range("List is empty!");
+        }
+        return *--end();
+    }
+
+    iterator insert(iterator position, const T& value) {
+        return emplace(position, value);
+    }
+
+    iterator insert(iterator position, T&& value) {
+        return emplace(position, std::move(value));
+    }
+
+    // Returns the new element
+    template <typename... Args>
+    iterator emplace(iterator position, Args&&... args) {
+        BaseNode* node = position.node_;
+        size_t slot = position.slot_;
+
+        // Before end() == after the last element of the last node
+        if (node == &sentinel_) {
+            BaseNode* last = sentinel_.prev;
+            if (last == &sentinel_ || last->last == K) {
+                return iterator(emplace_new_node(&sentinel_, 0, std::forward<Args>(args)...), 0);
+            }
+            node = last;
+            slot = last->last;
+        }
+
+        if (slot == node->first) {
+            // Room right before the first element (e.g. push_front into a node filled downwards)
+            if (node->first > 0) {
+                construct(as_node(node), node->first - 1, std::forward<Args>(args)...);
+                --node->first;
+                return iterator(node, node->first);
+            }
+            // Front of a full first node => a new node filled from its last slot
+            if (node->prev == &sentinel_ && node->last == K) {
+                return iterator(emplace_new_node(node, K - 1, std::forward<Args>(args)...), K - 1);
+            }
+        }
+
+        if (node->count() == K) {
+            // Split: the upper half moves to a new node after this one
+            T item(std::forward<Args>(args)...);  // Before the split moves what the arguments may refer to
+            const size_t offset = slot - node->first;
+            BaseNode* upper = split(as_node(node));
+            if (offset > node->count()) {
+                node = upper;
+                slot = upper->first + offset - (K / 2);
+            } else {
+                slot = node->first + offset;
+            }
+            return iterator(node, insert_into(as_node(node), slot, std::move(item)));
+        }
+
+        return iterator(node, insert_into(as_node(node), slot, std::forward<Args>(args)...));
+    }
+
+    // Returns the element after the erased one
+    iterator erase(iterator position) {
+        if (position == end()) {
+            return end();
+        }
+
+        Node* node = as_node(position.node_);
+        const size_t slot = position.slot_;
+
+        // Whichever side moves, the next element ends up at the erased one's offset from 'first'
+        BaseNode* next_node = node;
+        size_t next_offset = slot - node->first;
+
+        // The shorter side moves into the gap
+        if (slot - node->first < node->last - 1 - slot) {
+            std::move_backward(node->slot(node->first), node->slot(slot), node->slot(slot + 1));
+            destroy(node, node->first);
+            ++node->first;
+        } else {
+            std::move(node->slot(slot + 1), node->slot(node->last), node->slot(slot));
+            destroy(node, node->last - 1);
+            --node->last;
+        }
+        --size_;
+
+        if (next_offset == node->count()) {
+            next_node = node->next;
+            next_offset = 0;
+        }
+
+        // Offsets (not slots) survive the compaction of a merge
+        if (node->count() == 0) {
+            unlink_and_free(node);
+        } else if (node->count() < K / 4 && node->next != &sentinel_ && node->count() + node->next->count() <= 3 * K / 4) {
+            Node* next = as_node(node->next);
+            if (next_node == next) {
+                next_node = node;
+                next_offset += node->count();
+            }
+            merge_next(node);
+        }
+
+        return iterator(next_node, next_node->first + next_offset);
+    }
+
+    void clear() noexcept {
+        BaseNode* node = sentinel_.next;
+        while (node != &sentinel_) {
+            BaseNode* next = node->next;
+            for (size_t i = node->first; i < node->last; ++i) {
+                destroy(as_node(node), i);
+            }
+            node_allocator_.deallocate(as_node(node), 1);
+            node = next;
+        }
+        sentinel_.prev = &sentinel_;
+        sentinel_.next = &sentinel_;
+        size_ = 0;
+        nodes_ = 0;
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    size_t node_count() const noexcept {
+        return nodes_;
+    }
+
+  private:
+    template <typename... Args>
+    void construct(Node* node, size_t slot, Args&&... args) {
+        std::construct_at(node->slot(slot), std::forward<Args>(args)...);
+        ++size_;
+        if (node->first == node->last) {
+            node->first = static_cast<uint32_t>(slot);
+            node->last = static_cast<uint32_t>(slot + 1);
+        } else if (slot == node->last) {
+            ++node->last;
+        }
+    }
+
+    void destroy(Node* node, size_t slot) noexcept {
+        std::destroy_at(node->slot(slot));
+    }
+
+    // New empty node linked before 'before' (the caller fills it, 'slot' hints where)
+    Node* link_new_node(BaseNode* before, size_t slot) {
+        Node* node = node_allocator_.allocate(1);
+        ::new (static_cast<void*>(node)) Node();
+        node->first = static_cast<uint32_t>(slot);
+        node->last = static_cast<uint32_t>(slot);
+        node->next = before;
+        node->prev = before->prev;
+        before->prev->next = node;
+        before->prev = node;
+        ++nodes_;
+        return node;
+    }
+
+    void unlink_and_free(Node* node) noexcept {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        node_allocator_.deallocate(node, 1);
+        --nodes_;
+    }
+
+    // New node before 'before' holding one element at 'slot'; unlinked again if the constructor throws
+    // => no empty node is ever left in the list
+    template <typename... Args>
+    Node* emplace_new_node(BaseNode* before, size_t slot, Args&&... args) {
+        Node* node = link_new_node(before, slot);
+        try {
+            construct(node, slot, std::forward<Args>(args)...);
+        } catch (...) {
+            unlink_and_free(node);
+            throw;
+        }
+        return node;
+    }
+
+    // Inserts at 'slot' of a node with a free slot, shifting the shorter side; returns the element's slot
+    template <typename... Args>
+    size_t insert_into(Node* node, size_t slot, Args&&... args) {
+        T item(std::forward<Args>(args)...);  // The arguments may refer to elements about to move
+
+        const bool room_after = node->last < K;
+        const bool room_before = node->first > 0;
+        const bool shift_up = room_after && (!room_before || node->last - slot <= slot - node->first);
+
+        if (shift_up) {
+            if (slot == node->last) {
+                std::construct_at(node->slot(slot), std::move(item));
+            } else {
+                std::construct_at(node->slot(node->last), std::move(*node->slot(node->last - 1)));
+                std::move_backward(node->slot(slot), node->slot(node->last - 1), node->slot(node->last));
+                *node->slot(slot) = std::move(item);
+            }
+            ++node->last;
+            ++size_;
+            return slot;
+        }
+
+        // Down: the elements before 'slot' move one slot towards the front, the new one goes at slot - 1
+        if (slot == node->first) {
+            std::construct_at(node->slot(slot - 1), std::move(item));
+        } else {
+            std::construct_at(node->slot(node->first - 1), std::move(*node->slot(node->first)));
+            std::move(node->slot(node->first + 1), node->slot(slot), node->slot(node->first));
+            *node->slot(slot - 1) = std::move(item);
+        }
+        --node->first;
+        ++size_;
+        return slot - 1;
+    }
+
+    // Moves the upper half of a full node into a new node after it, both start at slot 0
+    BaseNode* split(Node* node) {
+        compact(node);
+        Node* upper = link_new_node(node->next, 0);
+        for (size_t i = K / 2; i < K; ++i) {
+            std::construct_at(upper->slot(i - K / 2), std::move(*node->slot(i)));
+            destroy(node, i);
+        }
+        upper->last = static_cast<uint32_t>(K - K / 2);
+        node->last = static_cast<uint32_t>(K / 2);
+        return upper;
+    }
+
+    // Elements to slots [0, count)
+    void compact(Node* node) noexcept {
+        if (node->first == 0) {
+            return;
+        }
+        const size_t count = node->count();
+        for (size_t i = 0; i < count; ++i) {
+            std::construct_at(node->slot(i), std::move(*node->slot(node->first + i)));
+            destroy(node, node->first + i);
+        }
+        node->first = 0;
+        node->last = static_cast<uint32_t>(count);
+    }
+
+    // Appends the elements of node->next to node and frees it (they fit)
+    void merge_next(Node* node) noexcept {
+        Node* next = as_node(node->next);
+        if (K - node->last < next->count()) {
+            compact(node);
+        }
+        for (size_t i = next->first; i < next->last; ++i) {
+            std::construct_at(node->slot(node->last), std::move(*next->slot(i)));
+            destroy(next, i);
+            ++node->last;
+        }
+        unlink_and_free(next);
+    }
+
+    void steal(UnrolledList& other) noexcept {
+        if (other.empty()) {
+            return;
+        }
+        sentinel_.next = other.sentinel_.next;
+        sentinel_.prev = other.sentinel_.prev;
+        sentinel_.next->prev = &sentinel_;
+        sentinel_.prev->next = &sentinel_;
+        size_ = std::exchange(other.size_, 0);
+        nodes_ = std::exchange(other.nodes_, 0);
+        other.sentinel_.next = &other.sentinel_;
+        other.sentinel_.prev = &other.sentinel_;
+    }
+
+  private:
+    BaseNode sentinel_;  // Inside the object (List allocates it) => moving re-points the end nodes at it
+    size_t size_{0};
+    size_t nodes_{0};
+    NodeAllocator node_allocator_;
+};
+}  // namespace renn::containers
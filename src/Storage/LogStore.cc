@@ -0,0 +1,569 @@
+#include "LogStore.hpp"
+#include "Record.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace renn::storage {
+
+namespace {
+
+// Hint file: one entry per record of the segment, then a trailer
+//   entry   : | key_size u32 | offset u32 | size u32 | flags u32 | key bytes |
+//   trailer : | segment size u64 | checksum u64 (of everything before it) |
+struct HintEntry {
+    uint32_t key_size;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t flags;
+};
+
+struct HintTrailer {
+    uint64_t segment_size;
+    uint64_t checksum;
+};
+
+constexpr uint64_t HINT_SEED = 0x68696e74;
+
+template <typename T>
+void append_pod(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+}  // namespace
+
+LogStore::LogStore(const std::filesystem::path& directory, sched::IScheduler& scheduler, const LogStoreOptions& options)
+    : directory_(directory),
+      scheduler_(scheduler),
+      options_(options) {
+    if (options_.segment_size == 0 || options_.segment_size > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("LogStore: segment_size must be in (0, 4 GiB)");
+    }
+
+    std::filesystem::create_directories(directory_);
+
+    std::vector<uint32_t> ids;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_)) {
+        if (entry.path().extension() != ".log") {
+            continue;
+        }
+        const std::string stem = entry.path().stem().string();
+        uint32_t id = 0;
+        auto [end, error] = std::from_chars(stem.data(), stem.data() + stem.size(), id);
+        if (error == std::errc() && end == stem.data() + stem.size()) {
+            ids.push_back(id);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+
+    // Oldest first => later records override earlier ones in the index
+    for (uint32_t id : ids) {
+        open_segment(id, id == ids.back());
+    }
+
+    if (ids.empty()) {
+        active_id_ = 1;
+        segments_[active_id_].segment = Segment::create(segment_path(active_id_, ".log"), active_id_, options_.segment_size);
+    }
+
+    if (options_.auto_compaction) {
+        schedule_compaction();
+    }
+}
+
+LogStore::~LogStore() {
+    background_.wait();
+
+    // Writes without options.sync are flushed at least on a clean close
+    try {
+        const Segment& active = *segments_.at(active_id_).segment;
+        active.sync(0, active.size());
+    } catch (...) {
+    }
+}
+
+// -----------------------------------------------
+// Writes
+
+void LogStore::put(std::string_view key, std::string_view value) {
+    submit_write(key, value, /*tombstone=*/false);
+}
+
+void LogStore::erase(std::string_view key) {
+    submit_write(key, {}, /*tombstone=*/true);
+}
+
+void LogStore::submit_write(std::string_view key, std::string_view value, bool tombstone) {
+    // Rejected before it joins a batch: no segment could hold it, the append would fail mid-batch
+    const size_t size = record_size(key.size(), value.size());
+    if (size > options_.segment_size) {
+        throw std::length_error("LogStore: a record of " + std::to_string(size) + " bytes is larger than segment_size");
+    }
+
+    std::shared_ptr<Batch> batch;
+
+    {
+        std::unique_lock lock(batch_mutex_);
+
+        if (!pending_) {
+            pending_ = std::make_shared<Batch>();
+        }
+        pending_->operations.push_back(Operation{std::string(key), std::string(value), tombstone});
+        batch = pending_;
+
+        // The first writer of a batch schedules its commit, everyone else just joins
+        if (!commit_scheduled_) {
+            commit_scheduled_ = true;
+            background_.add();
+            scheduler_.submit([this] {
+                commit();
+            });
+        }
+
+        batch_done_.wait(lock, [&batch] {
+            return batch->done;
+        });
+    }
+
+    if (batch->error) {
+        std::rethrow_exception(batch->error);
+    }
+}
+
+void LogStore::commit() {
+    {
+        std::lock_guard write_lock(write_mutex_);
+
+        // Taken only now: while the previous commit was syncing, this batch kept growing
+        std::shared_ptr<Batch> batch;
+        {
+            std::lock_guard lock(batch_mutex_);
+            batch = std::move(pending_);
+            pending_.reset();
+            commit_scheduled_ = false;
+        }
+
+        std::vector<Location> locations;
+        try {
+            std::string buffer;
+            std::vector<size_t> record_offsets;
+            record_offsets.reserve(batch->operations.size());
+
+            for (const auto& operation : batch->operations) {
+                record_offsets.push_back(buffer.size());
+                encode_record(buffer, operation.key, operation.value, operation.tombstone ? RECORD_TOMBSTONE : 0);
+            }
+
+            append_records(buffer, record_offsets, options_.sync, locations);
+        } catch (...) {
+            batch->error = std::current_exception();
+        }
+
+        // On an I/O error mid-batch, the records appended before it are indexed all the same: they are in
+        // the log, a reopen would replay them => the index never disagrees with what a restart would see
+        try {
+            std::unique_lock index_lock(index_mutex_);
+            for (size_t i = 0; i < locations.size(); ++i) {
+                apply(batch->operations[i].key, locations[i], batch->operations[i].tombstone);
+            }
+
+            writes_.fetch_add(locations.size(), std::memory_order_relaxed);
+            if (!batch->error) {
+                commits_.fetch_add(1, std::memory_order_relaxed);
+            }
+        } catch (...) {
+            if (!batch->error) {
+                batch->error = std::current_exception();
+            }
+        }
+
+        {
+            std::lock_guard lock(batch_mutex_);
+            batch->done = true;
+        }
+        batch_done_.notify_all();
+    }
+
+    background_.done();
+}
+
+void LogStore::append_records(const std::string& buffer, const std::vector<size_t>& record_offsets, bool sync,
+                              std::vector<Location>& locations) {
+    locations.reserve(record_offsets.size());
+
+    size_t sync_from = segments_.at(active_id_).segment->size();
+
+    for (size_t i = 0; i < record_offsets.size(); ++i) {
+        const size_t begin = record_offsets[i];
+        const size_t end = i + 1 < record_offsets.size() ? record_offsets[i + 1] : buffer.size();
+        const size_t size = end - begin;
+
+        Segment* active = segments_.at(active_id_).segment.get();
+        if (!active->fits(size)) {
+            // seal() syncs the whole segment
+            seal_active();
+            active = segments_.at(active_id_).segment.get();
+            sync_from = 0;
+        }
+
+        const size_t offset = active->append(buffer.data() + begin, size);
+        locations.push_back(Location{active_id_, static_cast<uint32_t>(offset), static_cast<uint32_t>(size)});
+    }
+
+    if (sync) {
+        const Segment& active = *segments_.at(active_id_).segment;
+        active.sync(sync_from, active.size());
+    }
+}
+
+void LogStore::apply(std::string_view key, const Location& location, bool tombstone) {
+    auto it = index_.find(std::string(key));
+
+    if (it != index_.end()) {
+        mark_dead(it->data_.second);
+        if (tombstone) {
+            index_.erase(it);
+        } else {
+            it->data_.second = location;
+        }
+    } else if (!tombstone) {
+        index_.emplace(std::string(key), location);
+    }
+
+    // A tombstone only shadows older records, its own bytes are garbage from the start
+    if (tombstone) {
+        mark_dead(location);
+    }
+}
+
+void LogStore::mark_dead(const Location& location) {
+    auto it = segments_.find(location.segment);
+    if (it != segments_.end()) {
+        it->second.dead_bytes += location.size;
+    }
+}
+
+void LogStore::seal_active() {
+    Segment& active = *segments_.at(active_id_).segment;
+    active.seal();
+    write_hint(active);
+
+    const uint32_t id = active_id_ + 1;
+    auto segment = Segment::create(segment_path(id, ".log"), id, options_.segment_size);
+
+    {
+        std::unique_lock index_lock(index_mutex_);
+        segments_[id].segment = std::move(segment);
+        active_id_ = id;
+    }
+
+    if (options_.auto_compaction) {
+        schedule_compaction();
+    }
+}
+
+void LogStore::rotate() {
+    std::lock_guard write_lock(write_mutex_);
+    seal_active();
+}
+
+// -----------------------------------------------
+// Reads
+
+std::optional<std::string> LogStore::get(std::string_view key) const {
+    std::shared_lock lock(index_mutex_);
+
+    auto it = index_.find(std::string(key));
+    if (it == index_.end()) {
+        return std::nullopt;
+    }
+
+    const Location location = it->data_.second;
+    const Segment& segment = *segments_.at(location.segment).segment;
+    auto record = decode_record(segment.data(), segment.capacity(), location.offset, /*verify=*/false);
+
+    return std::string(record->value);
+}
+
+bool LogStore::contains(std::string_view key) const {
+    std::shared_lock lock(index_mutex_);
+    return index_.contains(std::string(key));
+}
+
+size_t LogStore::size() const {
+    std::shared_lock lock(index_mutex_);
+    return index_.size();
+}
+
+LogStoreStats LogStore::stats() const {
+    std::shared_lock lock(index_mutex_);
+
+    LogStoreStats result;
+    result.keys = index_.size();
+    result.segments = segments_.size();
+    for (const auto& [id, info] : segments_) {
+        result.live_bytes += info.segment->size() - std::min(info.dead_bytes, info.segment->size());
+        result.dead_bytes += info.dead_bytes;
+    }
+    result.writes = writes_.load(std::memory_order_relaxed);
+    result.commits = commits_.load(std::memory_order_relaxed);
+    result.compactions = compactions_.load(std::memory_order_relaxed);
+    return result;
+}
+
+// -----------------------------------------------
+// Recovery
+
+void LogStore::open_segment(uint32_t id, bool active) {
+    const auto path = segment_path(id, ".log");
+    SegmentInfo& info = segments_[id];
+    info.segment = Segment::open(path, id, /*writable=*/active, active ? options_.segment_size : 0);
+    Segment& segment = *info.segment;
+
+    if (active) {
+        // A hint of the active segment is stale (left by a crash right after sealing)
+        active_id_ = id;
+        std::error_code ignored;
+        std::filesystem::remove(segment_path(id, ".hint"), ignored);
+    } else if (load_hint(segment)) {
+        return;
+    }
+
+    size_t end = 0;
+    scan_segment(segment, segment.capacity(), [&](size_t offset, const RecordView& record) {
+        apply(record.key, Location{id, static_cast<uint32_t>(offset), static_cast<uint32_t>(record.size)},
+              record.tombstone());
+        end = offset + record.size;
+    });
+    segment.set_size(end);
+
+    if (active) {
+        segment.discard_tail();
+    } else {
+        write_hint(segment);
+    }
+}
+
+template <typename Fn>
+void LogStore::scan_segment(const Segment& segment, size_t limit, Fn&& fn) {
+    size_t offset = 0;
+    while (auto record = decode_record(segment.data(), limit, offset)) {
+        fn(offset, *record);
+        offset += record->size;
+    }
+}
+
+void LogStore::write_hint(const Segment& segment) const {
+    std::string hint;
+
+    scan_segment(segment, segment.size(), [&](size_t offset, const RecordView& record) {
+        append_pod(hint, HintEntry{static_cast<uint32_t>(record.key.size()), static_cast<uint32_t>(offset),
+                                   static_cast<uint32_t>(record.size), record.flags});
+        hint.append(record.key);
+    });
+    append_pod(hint, HintTrailer{segment.size(), renn::hashing::wyhash(hint.data(), hint.size(), HINT_SEED)});
+
+    // Written aside and renamed => a hint is either complete or absent (a torn one fails the checksum anyway)
+    const auto path = segment_path(segment.id(), ".hint");
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        out.write(hint.data(), static_cast<std::streamsize>(hint.size()));
+        if (!out) {
+            return;  // Only a shortcut => the segment is scanned on the next open
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tmp_path, path, error);
+}
+
+bool LogStore::load_hint(Segment& segment) {
+    std::ifstream in(segment_path(segment.id(), ".hint"), std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    const std::string hint((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    if (hint.size() < sizeof(HintTrailer)) {
+        return false;
+    }
+    HintTrailer trailer;
+    const size_t body = hint.size() - sizeof(HintTrailer);
+    std::memcpy(&trailer, hint.data() + body, sizeof(trailer));
+
+    if (trailer.checksum != renn::hashing::wyhash(hint.data(), body, HINT_SEED) ||
+        trailer.segment_size > segment.file_size()) {
+        return false;
+    }
+
+    // Validated as a whole => entries can be applied without further checks
+    size_t position = 0;
+    while (position + sizeof(HintEntry) <= body) {
+        HintEntry entry;
+        std::memcpy(&entry, hint.data() + position, sizeof(entry));
+        position += sizeof(entry);
+
+        const std::string_view key(hint.data() + position, entry.key_size);
+        position += entry.key_size;
+
+        apply(key, Location{segment.id(), entry.offset, entry.size}, (entry.flags & RECORD_TOMBSTONE) != 0);
+    }
+
+    segment.set_size(trailer.segment_size);
+    return true;
+}
+
+// -----------------------------------------------
+// Compaction
+
+std::vector<uint32_t> LogStore::compaction_candidates() const {
+    std::shared_lock lock(index_mutex_);
+
+    std::vector<uint32_t> candidates;
+    for (const auto& [id, info] : segments_) {
+        if (id == active_id_) {
+            continue;
+        }
+        if (static_cast<double>(info.dead_bytes) >= options_.compaction_threshold * info.segment->size()) {
+            candidates.push_back(id);
+        }
+    }
+    return candidates;
+}
+
+void LogStore::compact() {
+    for (uint32_t id : compaction_candidates()) {
+        compact_segment(id);
+    }
+}
+
+void LogStore::schedule_compaction() {
+    std::vector<uint32_t> candidates;
+    {
+        std::lock_guard lock(compaction_mutex_);
+        if (compaction_scheduled_) {
+            return;
+        }
+
+        candidates = compaction_candidates();
+        if (candidates.empty()) {
+            return;
+        }
+        compaction_scheduled_ = true;
+    }
+
+    // Popped from the back => oldest first
+    std::reverse(candidates.begin(), candidates.end());
+
+    background_.add();
+    scheduler_.submit([this, candidates = std::move(candidates)]() mutable {
+        compact_next(std::move(candidates));
+    });
+}
+
+void LogStore::compact_next(std::vector<uint32_t> candidates) {
+    const uint32_t id = candidates.back();
+    candidates.pop_back();
+
+    try {
+        compact_segment(id);
+    } catch (...) {
+        // The segment stays as it is, the next sealed segment retries
+    }
+
+    if (!candidates.empty()) {
+        // One segment per renn: commits queued meanwhile get a worker before the next one
+        background_.add();
+        scheduler_.submit([this, candidates = std::move(candidates)]() mutable {
+            compact_next(std::move(candidates));
+        });
+    } else {
+        std::lock_guard lock(compaction_mutex_);
+        compaction_scheduled_ = false;
+    }
+
+    background_.done();
+}
+
+void LogStore::compact_segment(uint32_t id) {
+    // No commit runs meanwhile => the index can't change under the scan below
+    std::lock_guard write_lock(write_mutex_);
+
+    const Segment* segment = nullptr;
+    bool oldest = false;
+    {
+        std::shared_lock lock(index_mutex_);
+        auto it = segments_.find(id);
+        if (it == segments_.end() || id == active_id_) {
+            return;
+        }
+        segment = it->second.segment.get();
+        oldest = segments_.begin()->first == id;
+    }
+
+    std::string buffer;
+    std::vector<size_t> record_offsets;
+    std::vector<std::pair<std::string, bool>> moved;  // (key, tombstone)
+
+    {
+        std::shared_lock lock(index_mutex_);
+
+        scan_segment(*segment, segment->size(), [&](size_t offset, const RecordView& record) {
+            auto it = index_.find(std::string(record.key));
+
+            bool live;
+            if (record.tombstone()) {
+                // Still shadows an older segment's record, unless there is no older segment
+                live = !oldest && it == index_.end();
+            } else {
+                live = it != index_.end() && it->data_.second.segment == id && it->data_.second.offset == offset;
+            }
+
+            if (live) {
+                record_offsets.push_back(buffer.size());
+                encode_record(buffer, record.key, record.value, record.flags);
+                moved.emplace_back(std::string(record.key), record.tombstone());
+            }
+        });
+    }
+
+    // Synced regardless of options.sync: the old copy is about to be deleted
+    std::vector<Location> locations;
+    append_records(buffer, record_offsets, /*sync=*/true, locations);
+
+    {
+        std::unique_lock lock(index_mutex_);
+
+        for (size_t i = 0; i < moved.size(); ++i) {
+            if (moved[i].second) {
+                mark_dead(locations[i]);
+            } else {
+                index_.find(moved[i].first)->data_.second = locations[i];
+            }
+        }
+
+        std::error_code ignored;
+        std::filesystem::remove(segment_path(id, ".hint"), ignored);
+
+        auto it = segments_.find(id);
+        it->second.segment->remove_on_close();
+        segments_.erase(it);
+    }
+
+    compactions_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::filesystem::path LogStore::segment_path(uint32_t id, const char* extension) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%08u%s", id, extension);
+    return directory_ / name;
+}
+}  // namespace renn::storage
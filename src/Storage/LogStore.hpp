@@ -0,0 +1,192 @@
+#pragma once
+
+#include "../Containers/HashTable/HashTable.hpp"
+#include "../Containers/HashTable/Hashers/WyHash.hpp"
+#include "../Scheduling/IScheduler.hpp"
+#include "../Sync/WaitGroup.hpp"
+#include "Segment.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace renn::storage {
+
+struct LogStoreOptions {
+    // Segment files are preallocated to this size and sealed when full
+    size_t segment_size = 64u << 20;
+
+    // msync every group commit before acknowledging it
+    bool sync = true;
+
+    // A sealed segment is rewritten once this fraction of its bytes is overwritten or erased
+    double compaction_threshold = 0.5;
+
+    // Schedule compaction in the background whenever a segment is sealed
+    bool auto_compaction = true;
+};
+
+struct LogStoreStats {
+    size_t keys = 0;
+    size_t segments = 0;
+    size_t live_bytes = 0;
+    size_t dead_bytes = 0;
+    size_t writes = 0;
+    size_t commits = 0;  // writes / commits = average group commit size
+    size_t compactions = 0;
+};
+
+// Embedded key-value store: append-only log of mmap'd segments + in-memory HashTable index
+//
+// Layout of the directory:
+//   NNNNNNNN.log  - records (see Record.hpp), the highest id is the active segment
+//   NNNNNNNN.hint - (key, location) of every record of a sealed segment, written when it is sealed
+// On open the index is rebuilt from the hint files (the log is scanned for segments without one),
+// newer segments win => the log itself is the only source of truth, hints are just a shortcut
+//
+// Writes: put/erase enqueue into the pending batch and block until it is committed
+// The first writer of a batch submits a commit renn to the scheduler; while one commit is appending
+// and syncing, the next batch keeps filling => one msync for many writers (group commit)
+// => must not be called from a task of the same scheduler when it may be its only free worker
+//
+// Reads: shared lock + index lookup + copy out of the mapping, no syscalls
+//
+// Compaction: live records of a garbage-heavy sealed segment are re-appended to the active one,
+// then the segment is deleted. Every segment is a separate renn, resubmitted one after the other
+// => background compaction never holds more than one worker and queued commits run in between
+
+class LogStore {
+  public:
+    LogStore(const std::filesystem::path& directory, sched::IScheduler& scheduler,
+             const LogStoreOptions& options = LogStoreOptions());
+
+    // Waits for the background work it has scheduled
+    ~LogStore();
+
+    LogStore(const LogStore&) = delete;
+    LogStore& operator=(const LogStore&) = delete;
+
+    // Durable (with options.sync) once they return
+    // A record larger than options.segment_size is rejected with std::length_error, nothing is written
+    void put(std::string_view key, std::string_view value);
+
+    void erase(std::string_view key);
+
+    std::optional<std::string> get(std::string_view key) const;
+
+    bool contains(std::string_view key) const;
+
+    size_t size() const;
+
+    // Compacts every sealed segment above the threshold, in the calling thread
+    void compact();
+
+    // Same as compact(), as a chain of background renns
+    void schedule_compaction();
+
+    // Seals the active segment and starts a new one
+    void rotate();
+
+    LogStoreStats stats() const;
+
+  private:
+    struct Location {
+        uint32_t segment = 0;
+        uint32_t offset = 0;
+        uint32_t size = 0;
+    };
+
+    struct SegmentInfo {
+        std::unique_ptr<Segment> segment;
+        size_t dead_bytes = 0;
+    };
+
+    struct Operation {
+        std::string key;
+        std::string value;
+        bool tombstone;
+    };
+
+    struct Batch {
+        std::vector<Operation> operations;
+        bool done = false;
+        std::exception_ptr error;
+    };
+
+    using Index = containers::HashTable<std::string, Location, WyHash<std::string>>;
+
+  private:
+    void submit_write(std::string_view key, std::string_view value, bool tombstone);
+
+    void commit();
+
+    // Under write_mutex_: appends encoded records, rotating segments as needed, their locations go to
+    // 'locations' one by one => on an exception it holds exactly the records already appended
+    // Every record is synced before returning when 'sync' is set
+    void append_records(const std::string& buffer, const std::vector<size_t>& record_offsets, bool sync,
+                        std::vector<Location>& locations);
+
+    // Under write_mutex_ + unique index lock
+    void apply(std::string_view key, const Location& location, bool tombstone);
+
+    void mark_dead(const Location& location);
+
+    void seal_active();
+
+    void open_segment(uint32_t id, bool active);
+
+    // Recovers the valid prefix of the segment's records, returns them as (offset, record) to 'fn'
+    template <typename Fn>
+    static void scan_segment(const Segment& segment, size_t limit, Fn&& fn);
+
+    void write_hint(const Segment& segment) const;
+
+    bool load_hint(Segment& segment);
+
+    void compact_segment(uint32_t id);
+
+    std::vector<uint32_t> compaction_candidates() const;
+
+    void compact_next(std::vector<uint32_t> candidates);
+
+    std::filesystem::path segment_path(uint32_t id, const char* extension) const;
+
+  private:
+    const std::filesystem::path directory_;
+    sched::IScheduler& scheduler_;
+    const LogStoreOptions options_;
+
+    // index_ + segments_ (readers share it, commits and compaction take it exclusively)
+    mutable std::shared_mutex index_mutex_;
+    Index index_;
+    std::map<uint32_t, SegmentInfo> segments_;
+    uint32_t active_id_{0};
+
+    // Serializes appends to the active segment (commits, compaction, rotation)
+    std::mutex write_mutex_;
+
+    // Group commit
+    std::mutex batch_mutex_;
+    std::condition_variable batch_done_;
+    std::shared_ptr<Batch> pending_;
+    bool commit_scheduled_{false};
+
+    sync::WaitGroup background_;
+    std::mutex compaction_mutex_;
+    bool compaction_scheduled_{false};
+
+    std::atomic<size_t> writes_{0};
+    std::atomic<size_t> commits_{0};
+    std::atomic<size_t> compactions_{0};
+};
+}  // namespace renn::storage
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "../Containers/HashTable/Hashers/WyHash.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace renn::storage {
+
+// On-disk record of the data log:
+//
+//   | checksum u32 | key_size u32 | value_size u32 | flags u32 | key bytes | value bytes |
+//
+// The checksum covers everything after it => a torn write at the end of the log (or the zero-filled
+// preallocated tail of a segment) fails the check and ends the scan
+// Integers are little-endian (native on every platform we build for)
+
+struct RecordHeader {
+    uint32_t checksum;
+    uint32_t key_size;
+    uint32_t value_size;
+    uint32_t flags;
+};
+
+static_assert(sizeof(RecordHeader) == 16);
+
+inline constexpr uint32_t RECORD_TOMBSTONE = 1;
+
+// Records are padded to this => headers stay aligned inside the mapping
+inline constexpr size_t RECORD_ALIGNMENT = 8;
+
+inline size_t record_size(size_t key_size, size_t value_size) noexcept {
+    const size_t raw = sizeof(RecordHeader) + key_size + value_size;
+    return (raw + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+}
+
+inline uint32_t record_checksum(const std::byte* record, size_t key_size, size_t value_size) noexcept {
+    const size_t covered = sizeof(RecordHeader) - sizeof(uint32_t) + key_size + value_size;
+    return static_cast<uint32_t>(renn::hashing::wyhash(record + sizeof(uint32_t), covered, /*seed=*/0x6c6f67));
+}
+
+// Appends the encoded record to 'out'
+inline void encode_record(std::string& out, std::string_view key, std::string_view value, uint32_t flags) {
+    const size_t start = out.size();
+    out.resize(start + record_size(key.size(), value.size()), '\0');
+
+    auto* record = reinterpret_cast<std::byte*>(out.data() + start);
+    RecordHeader header{0, static_cast<uint32_t>(key.size()), static_cast<uint32_t>(value.size()), flags};
+    std::memcpy(record, &header, sizeof(header));
+    std::memcpy(record + sizeof(header), key.data(), key.size());
+    std::memcpy(record + sizeof(header) + key.size(), value.data(), value.size());
+
+    header.checksum = record_checksum(record, key.size(), value.size());
+    std::memcpy(record, &header.checksum, sizeof(header.checksum));
+}
+
+struct RecordView {
+    std::string_view key;
+    std::string_view value;
+    uint32_t flags;
+    size_t size;  // Including header and padding
+
+    bool tombstone() const noexcept { return (flags & RECORD_TOMBSTONE) != 0; }
+};
+
+// Decodes the record at 'offset' of [data, data + limit), nullopt if it is truncated or corrupt
+// Without 'verify' the checksum is skipped (records the index points to were verified when they were loaded)
+inline std::optional<RecordView> decode_record(const std::byte* data, size_t limit, size_t offset,
+                                               bool verify = true) noexcept {
+    if (offset > limit || limit - offset < sizeof(RecordHeader)) {
+        return std::nullopt;
+    }
+
+    RecordHeader header;
+    std::memcpy(&header, data + offset, sizeof(header));
+
+    const size_t size = record_size(header.key_size, header.value_size);
+    if (size > limit - offset) {
+        return std::nullopt;
+    }
+
+    const std::byte* record = data + offset;
+    if (verify && header.checksum != record_checksum(record, header.key_size, header.value_size)) {
+        return std::nullopt;
+    }
+
+    const char* payload = reinterpret_cast<const char*>(record + sizeof(header));
+    return RecordView{
+        std::string_view(payload, header.key_size),
+        std::string_view(payload + header.key_size, header.value_size),
+        header.flags,
+        size,
+    };
+}
+}  // namespace renn::storage
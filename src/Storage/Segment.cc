@@ -0,0 +1,157 @@
+#include "Segment.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace renn::storage {
+
+namespace {
+
+[[noreturn]] void throw_errno(const std::string& what, const std::filesystem::path& path) {
+    throw std::system_error(errno, std::generic_category(), what + " " + path.string());
+}
+
+size_t page_size() {
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+}  // namespace
+
+std::unique_ptr<Segment> Segment::create(const std::filesystem::path& path, uint32_t id, size_t capacity) {
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw_errno("create", path);
+    }
+
+    if (::ftruncate(fd, static_cast<off_t>(capacity)) != 0) {
+        const int error = errno;
+        ::close(fd);
+        errno = error;
+        throw_errno("ftruncate", path);
+    }
+
+    return std::unique_ptr<Segment>(new Segment(path, id, fd, capacity, capacity, /*writable=*/true));
+}
+
+std::unique_ptr<Segment> Segment::open(const std::filesystem::path& path, uint32_t id, bool writable,
+                                       size_t min_capacity) {
+    const int fd = ::open(path.c_str(), (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+    if (fd < 0) {
+        throw_errno("open", path);
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        const int error = errno;
+        ::close(fd);
+        errno = error;
+        throw_errno("fstat", path);
+    }
+
+    size_t file_size = static_cast<size_t>(st.st_size);
+    size_t capacity = file_size;
+
+    if (writable && capacity < min_capacity) {
+        if (::ftruncate(fd, static_cast<off_t>(min_capacity)) != 0) {
+            const int error = errno;
+            ::close(fd);
+            errno = error;
+            throw_errno("ftruncate", path);
+        }
+        capacity = file_size = min_capacity;
+    }
+
+    return std::unique_ptr<Segment>(new Segment(path, id, fd, file_size, capacity, writable));
+}
+
+Segment::Segment(std::filesystem::path path, uint32_t id, int fd, size_t file_size, size_t capacity, bool writable)
+    : path_(std::move(path)),
+      id_(id),
+      fd_(fd),
+      file_size_(file_size),
+      capacity_(capacity),
+      sealed_(!writable) {
+    if (capacity_ == 0) {
+        return;  // mmap of length 0 is an error, an empty segment needs no mapping
+    }
+
+    const int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* mapping = ::mmap(nullptr, capacity_, protection, MAP_SHARED, fd_, 0);
+
+    if (mapping == MAP_FAILED) {
+        const int error = errno;
+        ::close(fd_);
+        errno = error;
+        throw_errno("mmap", path_);
+    }
+    data_ = static_cast<std::byte*>(mapping);
+}
+
+Segment::~Segment() {
+    if (data_ != nullptr) {
+        ::munmap(data_, capacity_);
+    }
+    ::close(fd_);
+
+    if (remove_on_close_) {
+        std::error_code ignored;
+        std::filesystem::remove(path_, ignored);
+    }
+}
+
+size_t Segment::append(const void* bytes, size_t len) {
+    if (!fits(len)) {
+        throw std::length_error("Segment::append: segment is full or sealed");
+    }
+
+    const size_t offset = size();
+    std::memcpy(data_ + offset, bytes, len);
+    set_size(offset + len);
+    return offset;
+}
+
+void Segment::sync(size_t from, size_t to) const {
+    if (from >= to) {
+        return;
+    }
+
+    // msync wants a page-aligned address
+    const size_t begin = from - from % page_size();
+    if (::msync(data_ + begin, to - begin, MS_SYNC) != 0) {
+        throw_errno("msync", path_);
+    }
+}
+
+void Segment::seal() {
+    if (sealed_) {
+        return;
+    }
+
+    sync(0, size());
+
+    // The mapping keeps its length, only the bytes past size() (never read) lose their backing
+    if (::ftruncate(fd_, static_cast<off_t>(size())) != 0) {
+        throw_errno("ftruncate", path_);
+    }
+    file_size_ = size();
+    sealed_ = true;
+}
+
+void Segment::discard_tail() {
+    if (sealed_ || size() == capacity_) {
+        return;
+    }
+
+    // Shrinking drops the pages, growing back brings them as zeros (no writes through the mapping)
+    if (::ftruncate(fd_, static_cast<off_t>(size())) != 0 || ::ftruncate(fd_, static_cast<off_t>(capacity_)) != 0) {
+        throw_errno("ftruncate", path_);
+    }
+}
+}  // namespace renn::storage
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+namespace renn::storage {
+
+// One mmap'd file of the data log
+//
+// The file is preallocated to 'capacity' and mapped once => appends are plain memcpy into the mapping,
+// no write() per record, and readers see committed bytes without any syscall
+// seal() trims the file to the bytes actually written; a sealed segment is immutable
+//
+// Not synchronized: LogStore serializes appends and publishes offsets through its index
+
+class Segment {
+  public:
+    // New empty segment file (fails if it exists)
+    static std::unique_ptr<Segment> create(const std::filesystem::path& path, uint32_t id, size_t capacity);
+
+    // Existing segment file; 'size' is left at 0 until the owner has scanned the records (set_size)
+    // A writable segment is extended to at least 'min_capacity'
+    static std::unique_ptr<Segment> open(const std::filesystem::path& path, uint32_t id, bool writable,
+                                         size_t min_capacity = 0);
+
+    Segment(const Segment&) = delete;
+    Segment& operator=(const Segment&) = delete;
+
+    ~Segment();
+
+    uint32_t id() const noexcept { return id_; }
+
+    const std::filesystem::path& path() const noexcept { return path_; }
+
+    // Bytes of valid records (may be read while the writer appends)
+    size_t size() const noexcept { return size_.load(std::memory_order_acquire); }
+
+    size_t capacity() const noexcept { return capacity_; }
+
+    // Size of the file on disk (== capacity while writable)
+    size_t file_size() const noexcept { return file_size_; }
+
+    bool sealed() const noexcept { return sealed_; }
+
+    const std::byte* data() const noexcept { return data_; }
+
+    bool fits(size_t len) const noexcept { return !sealed_ && capacity_ - size() >= len; }
+
+    // Returns the offset the bytes were written at
+    size_t append(const void* bytes, size_t len);
+
+    void set_size(size_t size) noexcept { size_.store(size, std::memory_order_release); }
+
+    // Flushes [from, to) of the mapping to disk (msync, widened to page boundaries)
+    void sync(size_t from, size_t to) const;
+
+    // Trims the file to size() and forbids further appends
+    void seal();
+
+    // Zero-fills [size(), capacity()) => bytes of a torn write past the recovered end can't resurface later
+    void discard_tail();
+
+    // The file is unlinked when the segment is destroyed
+    void remove_on_close() noexcept { remove_on_close_ = true; }
+
+  private:
+    Segment(std::filesystem::path path, uint32_t id, int fd, size_t file_size, size_t capacity, bool writable);
+
+  private:
+    std::filesystem::path path_;
+    uint32_t id_;
+    int fd_;
+    std::byte* data_{nullptr};
+    std::atomic<size_t> size_{0};
+    size_t file_size_;
+    size_t capacity_;
+    bool sealed_;
+    bool remove_on_close_{false};
+};
+}  // namespace renn::storage
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace renn::sync {
+
+// Epoch-based reclamation for lock-free structures (process-wide, one record per thread)
+//
+// A reader pins the current global epoch for the duration of an operation (Epoch::Guard)
+// A writer unlinks an object and retires it with the epoch it was retired in => it is freed once the
+// global epoch has moved two steps past that, i.e. once every thread pinned at retire time has unpinned
+// The epoch advances only when every pinned thread has seen the current one
+//
+// => pointers loaded from the structure inside a guard stay valid until the guard ends
+// A guard held for long (e.g. a slow range scan) only delays frees, it never blocks writers
+// Objects a thread leaves behind when it exits are freed by the next thread that takes over its record
+
+class Epoch {
+  public:
+    using Deleter = void (*)(void*);
+
+    class Guard {
+      public:
+        Guard();
+        ~Guard();
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    // 'object' must already be unreachable for threads that pin from now on
+    static void retire(void* object, Deleter deleter);
+
+    template <typename T>
+    static void retire(T* object) {
+        retire(object, [](void* p) {
+            delete static_cast<T*>(p);
+        });
+    }
+
+    // Tries to advance the epoch and frees what the calling thread retired that is now safe
+    // Returns the number of objects freed
+    static size_t collect();
+
+    // Objects retired by the calling thread and not freed yet
+    static size_t pending();
+
+  private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t COLLECT_EVERY = 64;  // Retires between two collection attempts
+    static constexpr uint64_t PINNED = 1;         // state_ = epoch << 1 | PINNED, 0 when not pinned
+
+    struct Retired {
+        void* object;
+        Deleter deleter;
+        uint64_t epoch;
+    };
+
+    struct alignas(CACHE_LINE_SIZE) Record {
+        std::atomic<uint64_t> state_{0};
+        std::atomic<bool> in_use_{true};
+        Record* next_{nullptr};  // Records are never freed => the list only grows at the head
+
+        // Owner thread only
+        size_t nesting_{0};
+        size_t retired_since_collect_{0};
+        std::vector<Retired> limbo_;  // In retire order => non-decreasing epochs
+    };
+
+    // Releases the thread's record on exit
+    struct Participant {
+        Record* record_;
+
+        Participant();
+        ~Participant();
+    };
+
+    static Record* local();
+    static bool try_advance();
+    static size_t collect(Record* record);
+
+    static inline std::atomic<uint64_t> global_epoch_{1};
+    static inline std::atomic<Record*> records_{nullptr};
+};
+
+//////////////////////////////////////////////////////////////////////
+
+inline Epoch::Participant::Participant() {
+    // Reuse the record of a thread that has exited, with whatever it left to free
+    for (Record* record = records_.load(std::memory_order_acquire); record != nullptr; record = record->next_) {
+        bool free = false;
+        if (!record->in_use_.load(std::memory_order_relaxed) &&
+            record->in_use_.compare_exchange_strong(free, true, std::memory_order_acquire)) {
+            record_ = record;
+            return;
+        }
+    }
+
+    record_ = new Record();
+    Record* head = records_.load(std::memory_order_relaxed);
+    do {
+        record_->next_ = head;
+    } while (!records_.compare_exchange_weak(head, record_, std::memory_order_release, std::memory_order_relaxed));
+}
+
+inline Epoch::Participant::~Participant() {
+    collect(record_);
+    record_->in_use_.store(false, std::memory_order_release);
+}
+
+inline Epoch::Record* Epoch::local() {
+    static thread_local Participant participant;
+    return participant.record_;
+}
+
+inline Epoch::Guard::Guard() {
+    Record* record = local();
+    if (record->nesting_++ == 0) {
+        record->state_.store(global_epoch_.load() << 1 | PINNED);
+        // Loads from the structure may not move above the pin (a store-load pair => full fence)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+inline Epoch::Guard::~Guard() {
+    Record* record = local();
+    if (--record->nesting_ == 0) {
+        record->state_.store(0, std::memory_order_release);
+    }
+}
+
+inline bool Epoch::try_advance() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t epoch = global_epoch_.load();
+    for (Record* record = records_.load(std::memory_order_acquire); record != nullptr; record = record->next_) {
+        const uint64_t state = record->state_.load();
+        if ((state & PINNED) != 0 && (state >> 1) != epoch) {
+            return false;  // Still in the previous epoch
+        }
+    }
+    return global_epoch_.compare_exchange_strong(epoch, epoch + 1);
+}
+
+inline void Epoch::retire(void* object, Deleter deleter) {
+    Record* record = local();
+    record->limbo_.push_back({object, deleter, global_epoch_.load()});
+    if (++record->retired_since_collect_ >= COLLECT_EVERY) {
+        collect(record);
+    }
+}
+
+inline size_t Epoch::collect() {
+    return collect(local());
+}
+
+inline size_t Epoch::collect(Record* record) {
+    record->retired_since_collect_ = 0;
+    try_advance();
+
+    const uint64_t epoch = global_epoch_.load();
+    auto& limbo = record->limbo_;
+    size_t freed = 0;
+    while (freed < limbo.size() && limbo[freed].epoch + 2 <= epoch) {
+        limbo[freed].deleter(limbo[freed].object);
+        ++freed;
+    }
+    limbo.erase(limbo.begin(), limbo.begin() + static_cast<std::ptrdiff_t>(freed));
+    return freed;
+}
+
+inline size_t Epoch::pending() {
+    return local()->limbo_.size();
+}
+
+};  // namespace renn::sync
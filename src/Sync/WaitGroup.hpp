@@ -23,12 +23,12 @@ class WaitGroup {
 
 //////////////////////////////////////////////////////////////////////
 
-void WaitGroup::add(size_t count) {
+inline void WaitGroup::add(size_t count) {
     std::unique_lock<std::mutex> lock(mtx_);
     count_ += count;
 }
 
-void WaitGroup::done() {
+inline void WaitGroup::done() {
     std::unique_lock<std::mutex> lock(mtx_);
 
     assert(count_ > 0);
@@ -39,7 +39,7 @@ void WaitGroup::done() {
     }
 }
 
-void WaitGroup::wait() {
+inline void WaitGroup::wait() {
     std::unique_lock<std::mutex> lock(mtx_);
     all_done_.wait(lock, [this] {
         return count_ == 0;
@@ -0,0 +1,72 @@
+#include "../src/Containers/BloomFilter.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using BlockedBloomFilter = renn::containers::BlockedBloomFilter;
+
+class BloomFilterTest : public ::testing::Test {
+  protected:
+    static constexpr size_t NUM_KEYS = 100000;
+
+    std::vector<uint64_t> keys;
+    std::mt19937_64 rng{42};
+
+    void SetUp() override {
+        for (size_t i = 0; i < NUM_KEYS; ++i) {
+            keys.push_back(rng());
+        }
+    }
+};
+
+TEST_F(BloomFilterTest, NoFalseNegatives) {
+    BlockedBloomFilter filter(NUM_KEYS);
+
+    for (uint64_t key : keys) {
+        filter.insert_hash(key);
+    }
+    for (uint64_t key : keys) {
+        EXPECT_TRUE(filter.may_contain_hash(key));
+    }
+}
+
+TEST_F(BloomFilterTest, FalsePositiveRate) {
+    BlockedBloomFilter filter(NUM_KEYS);
+
+    for (uint64_t key : keys) {
+        filter.insert_hash(key);
+    }
+
+    size_t false_positives = 0;
+    constexpr size_t PROBES = 100000;
+    for (size_t i = 0; i < PROBES; ++i) {
+        false_positives += filter.may_contain_hash(rng());
+    }
+
+    // ~1% expected at 10 bits per key, blocking costs a bit of accuracy
+    EXPECT_LT(false_positives, PROBES * 3 / 100);
+}
+
+TEST_F(BloomFilterTest, WeakHashAndClear) {
+    BlockedBloomFilter filter(1000);
+
+    // std::hash<int> is the identity, the filter remixes it
+    for (int i = 0; i < 1000; ++i) {
+        filter.insert(i);
+    }
+
+    size_t false_positives = 0;
+    for (int i = 1000; i < 11000; ++i) {
+        false_positives += filter.may_contain(i);
+    }
+    EXPECT_LT(false_positives, 300);
+
+    filter.insert(std::string("renn"));
+    EXPECT_TRUE(filter.may_contain(std::string("renn")));
+
+    filter.clear();
+    EXPECT_FALSE(filter.may_contain(std::string("renn")));
+    EXPECT_FALSE(filter.may_contain(1));
+}
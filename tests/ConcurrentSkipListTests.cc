@@ -0,0 +1,200 @@
+#include "../src/Containers/ConcurrentSkipList.hpp"
+#include "../src/Sync/Epoch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using renn::containers::ConcurrentSkipListMap;
+using renn::sync::Epoch;
+
+TEST(ConcurrentSkipListTest, MatchesStdMap) {
+    ConcurrentSkipListMap<int, int> map;
+    std::map<int, int> reference;
+    std::mt19937 rng(9);
+
+    for (int step = 0; step < 50000; ++step) {
+        const int key = static_cast<int>(rng() % 2000);
+        switch (rng() % 3) {
+            case 0:
+                ASSERT_EQ(map.insert(key, step), reference.emplace(key, step).second);
+                break;
+            case 1:
+                ASSERT_EQ(map.erase(key), reference.erase(key) == 1);
+                break;
+            case 2: {
+                auto found = map.find(key);
+                auto it = reference.find(key);
+                ASSERT_EQ(found.has_value(), it != reference.end());
+                if (found) {
+                    ASSERT_EQ(*found, it->second);
+                }
+                break;
+            }
+        }
+    }
+    ASSERT_EQ(map.size(), reference.size());
+
+    std::vector<std::pair<const int, int>> all;
+    for (const auto& [key, value] : map.range()) {
+        all.emplace_back(key, value);
+    }
+    EXPECT_TRUE(std::equal(all.begin(), all.end(), reference.begin(), reference.end()));
+
+    std::vector<int> keys;
+    for (const auto& entry : map.range(500, 600)) {
+        keys.push_back(entry.first);
+    }
+    std::vector<int> expected;
+    for (auto it = reference.lower_bound(500); it != reference.lower_bound(600); ++it) {
+        expected.push_back(it->first);
+    }
+    EXPECT_EQ(keys, expected);
+}
+
+TEST(ConcurrentSkipListTest, RangeBoundsAndCompare) {
+    ConcurrentSkipListMap<std::string, int, std::greater<>> map;  // Descending
+    for (int i = 0; i < 26; ++i) {
+        map.insert(std::string(1, static_cast<char>('a' + i)), i);
+    }
+    EXPECT_FALSE(map.insert("c", 100));
+    EXPECT_EQ(map.find("c"), 2);
+    EXPECT_FALSE(map.contains("A"));
+
+    std::string keys;
+    for (const auto& [key, value] : map.range("k", "f")) {  // (f, k] in alphabetical order
+        keys += key;
+    }
+    EXPECT_EQ(keys, "kjihg");
+
+    auto empty = map.range("f", "k");
+    EXPECT_EQ(empty.begin(), empty.end());
+    EXPECT_FALSE(map.empty());
+}
+
+TEST(ConcurrentSkipListTest, ConcurrentWritersAndScanners) {
+    ConcurrentSkipListMap<int, int> map;
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 5000;
+
+    // Even keys stay, odd keys are inserted and erased over and over
+    for (int key = 0; key < THREADS * PER_THREAD; key += 2) {
+        map.insert(key, -key);
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> scan_errors{0};
+    std::vector<std::thread> scanners;
+    for (int t = 0; t < 2; ++t) {
+        scanners.emplace_back([&] {
+            while (!stop.load()) {
+                int previous = -1;
+                int evens = 0;
+                for (const auto& [key, value] : map.range(0, THREADS * PER_THREAD)) {
+                    if (key <= previous || value != -key) {
+                        scan_errors.fetch_add(1);
+                    }
+                    evens += key % 2 == 0;
+                    previous = key;
+                }
+                if (evens != THREADS * PER_THREAD / 2) {
+                    scan_errors.fetch_add(1);  // A stable key went missing
+                }
+            }
+        });
+    }
+
+    std::atomic<int> inserted{0};
+    std::atomic<int> erased{0};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < THREADS; ++t) {
+        writers.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            for (int round = 0; round < 20000; ++round) {
+                const int key = static_cast<int>(rng() % (THREADS * PER_THREAD)) | 1;  // Shared odd keys
+                if (rng() % 2 == 0) {
+                    inserted += map.insert(key, -key);
+                } else {
+                    erased += map.erase(key);
+                }
+                if (map.contains(key - 1) == false) {
+                    scan_errors.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    stop.store(true);
+    for (auto& scanner : scanners) {
+        scanner.join();
+    }
+
+    EXPECT_EQ(scan_errors.load(), 0);
+    EXPECT_EQ(map.size(), static_cast<size_t>(THREADS * PER_THREAD / 2 + inserted.load() - erased.load()));
+    size_t count = 0;
+    for (const auto& entry : map.range()) {
+        (void)entry;
+        ++count;
+    }
+    EXPECT_EQ(count, map.size());
+}
+
+TEST(EpochTest, FreesOnlyAfterGuardsEnd) {
+    static std::atomic<int> freed{0};
+    freed = 0;
+    for (int i = 0; i < 3; ++i) {
+        Epoch::collect();  // Whatever earlier tests retired on this thread
+    }
+
+    auto retire = [] {
+        Epoch::retire(new int(0), [](void* p) {
+            delete static_cast<int*>(p);
+            ++freed;
+        });
+    };
+
+    std::atomic<bool> pinned{false};
+    std::atomic<bool> release{false};
+    std::thread reader([&] {
+        Epoch::Guard guard;
+        pinned = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+    while (!pinned) {
+        std::this_thread::yield();
+    }
+
+    retire();
+    for (int i = 0; i < 10; ++i) {
+        Epoch::collect();
+    }
+    EXPECT_EQ(freed.load(), 0);  // The reader may still see it
+    EXPECT_EQ(Epoch::pending(), 1u);
+
+    release = true;
+    reader.join();
+    for (int i = 0; i < 3; ++i) {
+        Epoch::collect();
+    }
+    EXPECT_EQ(freed.load(), 1);
+    EXPECT_EQ(Epoch::pending(), 0u);
+
+    {
+        Epoch::Guard outer;
+        Epoch::Guard nested;  // Guards nest
+        retire();
+    }
+    for (int i = 0; i < 3; ++i) {
+        Epoch::collect();
+    }
+    EXPECT_EQ(freed.load(), 2);
+}
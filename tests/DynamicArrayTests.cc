@@ -0,0 +1,502 @@
+#include "../src/Containers/DynamicArray.hpp"
+#include "../src/Containers/HugePageAllocator.hpp"
+#include "../src/Containers/MallocAllocator.hpp"
+#include "../src/Containers/SmallArray.hpp"
+#include "../src/Scheduling/ThreadPool/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using renn::containers::DynamicArray;
+using renn::containers::HugePageAllocator;
+using renn::containers::MallocAllocator;
+using renn::containers::SmallArray;
+
+namespace {
+
+// Not trivially copyable, but safe to memcpy: declared relocatable below
+struct Boxed {
+    std::unique_ptr<int> value;
+
+    explicit Boxed(int v) : value(std::make_unique<int>(v)) {}
+};
+
+size_t allocations = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        ++allocations;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(const CountingAllocator&) const = default;
+};
+
+}  // namespace
+
+template <>
+struct renn::containers::is_trivially_relocatable<Boxed> : std::true_type {};
+
+TEST(DynamicArrayTest, PushInsertErase) {
+    DynamicArray<int> array;
+    for (int i = 0; i < 100; ++i) {
+        array.push_back(i);
+    }
+    array.insert(size_t{0}, -1);
+    array.insert(size_t{50}, array[10]);  // Element of the array itself
+    array.erase_at_index(1);
+
+    ASSERT_EQ(array.size(), 101u);
+    EXPECT_EQ(array[0], -1);
+    EXPECT_EQ(array[1], 1);
+    EXPECT_EQ(array[49], 9);
+    EXPECT_EQ(array[48], 48);
+    EXPECT_EQ(array[50], 49);
+    EXPECT_EQ(array.back(), 99);
+}
+
+TEST(DynamicArrayTest, NonRelocatableElements) {
+    DynamicArray<std::string> array;
+    for (int i = 0; i < 100; ++i) {
+        array.push_back(std::to_string(i));  // Short strings => SSO buffers inside the objects
+    }
+    array.insert(size_t{3}, std::string(50, 'x'));
+    array.erase_at_index(0);
+
+    ASSERT_EQ(array.size(), 100u);
+    EXPECT_EQ(array[0], "1");
+    EXPECT_EQ(array[2], std::string(50, 'x'));
+    EXPECT_EQ(array.back(), "99");
+}
+
+TEST(DynamicArrayTest, DeclaredRelocatableElements) {
+    DynamicArray<Boxed> array;
+    for (int i = 0; i < 1000; ++i) {
+        array.emplace_back(i);
+    }
+    array.insert(size_t{0}, Boxed(-1));
+    array.erase_at_index(500);
+
+    ASSERT_EQ(array.size(), 1000u);
+    EXPECT_EQ(*array[0].value, -1);
+    EXPECT_EQ(*array[499].value, 498);
+    EXPECT_EQ(*array[500].value, 500);
+    EXPECT_EQ(*array.back().value, 999);
+}  // Every unique_ptr freed exactly once (checked by the sanitizers)
+
+TEST(DynamicArrayTest, GrowthFactor) {
+    DynamicArray<int> doubling;
+    DynamicArray<int> slow;
+    slow.set_growth_factor(1.5);
+
+    size_t doubling_steps = 0;
+    size_t slow_steps = 0;
+    for (int i = 0; i < 10000; ++i) {
+        const size_t doubling_capacity = doubling.capacity();
+        const size_t slow_capacity = slow.capacity();
+        doubling.push_back(i);
+        slow.push_back(i);
+        doubling_steps += doubling.capacity() != doubling_capacity;
+        slow_steps += slow.capacity() != slow_capacity;
+        ASSERT_LE(slow.capacity(), std::max<size_t>(2, slow_capacity * 3 / 2 + 1));
+    }
+
+    EXPECT_GT(slow_steps, doubling_steps);
+    EXPECT_EQ(slow[9999], 9999);
+    EXPECT_THROW(slow.set_growth_factor(1.0), std::invalid_argument);
+
+    auto copy = slow;
+    EXPECT_EQ(copy.growth_factor(), 1.5);
+}
+
+TEST(DynamicArrayTest, MallocAllocatorRemapsLargeBlocks) {
+    DynamicArray<uint64_t, MallocAllocator<uint64_t>> array;
+
+    // Crosses MREMAP_THRESHOLD: realloc below it, one copy into a mapping, mremap above it
+    constexpr size_t COUNT = 4 * MallocAllocator<uint64_t>::MREMAP_THRESHOLD / sizeof(uint64_t);
+    for (size_t i = 0; i < COUNT; ++i) {
+        array.push_back(i * 3);
+    }
+    for (size_t i = 0; i < COUNT; i += 4093) {
+        ASSERT_EQ(array[i], i * 3);
+    }
+
+    array.erase_at_index(0);
+    EXPECT_EQ(array[0], 3u);
+    EXPECT_EQ(array.back(), (COUNT - 1) * 3);
+
+    DynamicArray<uint64_t, MallocAllocator<uint64_t>> small;
+    small.reserve(10);
+    small.push_back(7);
+    small.reserve(1000);
+    EXPECT_EQ(small[0], 7u);
+}
+
+TEST(DynamicArrayTest, ShrinkToFit) {
+    DynamicArray<std::string> strings;
+    for (int i = 0; i < 100; ++i) {
+        strings.push_back(std::to_string(i));
+    }
+    strings.resize(10);
+    strings.shrink_to_fit();
+    EXPECT_EQ(strings.capacity(), 10u);
+    EXPECT_EQ(strings[9], "9");
+
+    strings.clear();
+    strings.shrink_to_fit();
+    EXPECT_EQ(strings.capacity(), 0u);
+}
+
+TEST(DynamicArrayTest, HugePageAllocator) {
+    using Allocator = HugePageAllocator<uint64_t>;
+
+    renn::ThreadPool pool(4);
+    pool.start();
+
+    DynamicArray<uint64_t, Allocator> array{Allocator(pool)};
+
+    // 64MB: operator new at first, then huge-page mappings grown by mremap and pre-faulted on the pool
+    constexpr size_t COUNT = (64u << 20) / sizeof(uint64_t);
+    for (size_t i = 0; i < COUNT; ++i) {
+        array.push_back(i);
+    }
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(array.begin()) % Allocator::HUGE_PAGE_SIZE, 0u);
+    for (size_t i = 0; i < COUNT; i += 4099) {
+        ASSERT_EQ(array[i], i);
+    }
+
+    // Whole huge pages unmapped, the rest of the last one returned with MADV_DONTNEED
+    array.resize(COUNT / 3 + 1);
+    array.shrink_to_fit();
+    EXPECT_EQ(array.capacity(), COUNT / 3 + 1);
+    EXPECT_EQ(array.back(), COUNT / 3);
+    array.push_back(42);
+    EXPECT_EQ(array.back(), 42u);
+
+    // Back below the threshold
+    array.resize(100);
+    array.shrink_to_fit();
+    EXPECT_EQ(array[99], 99u);
+
+    pool.stop();
+}
+
+template <typename T>
+class DynamicArraySearchTest : public ::testing::Test {};
+
+using SearchTypes = ::testing::Types<uint8_t, int16_t, int32_t, int64_t, float, double>;
+TYPED_TEST_SUITE(DynamicArraySearchTest, SearchTypes);
+
+// Every size up to a few vectors (tails included), values from a small range => many matches
+TYPED_TEST(DynamicArraySearchTest, MatchesScalar) {
+    using T = TypeParam;
+    std::mt19937 rng(3);
+
+    for (size_t size = 0; size < 150; ++size) {
+        DynamicArray<T> array;
+        std::vector<T> expected;
+        for (size_t i = 0; i < size; ++i) {
+            const T value = static_cast<T>(rng() % 4);
+            array.push_back(value);
+            expected.push_back(value);
+        }
+
+        for (T needle : {T(0), T(3), T(7)}) {
+            const auto position = std::find(expected.begin(), expected.end(), needle) - expected.begin();
+            ASSERT_EQ(array.find(needle) - array.begin(), position) << size;
+            ASSERT_EQ(array.count(needle), static_cast<size_t>(std::count(expected.begin(), expected.end(), needle)));
+        }
+
+        auto erased = array;
+        auto kept = expected;
+        kept.erase(std::remove(kept.begin(), kept.end(), T(1)), kept.end());
+        ASSERT_EQ(erased.erase(T(1)), expected.size() - kept.size());
+        ASSERT_TRUE(std::equal(erased.cbegin(), erased.cend(), kept.begin(), kept.end())) << size;
+
+        auto filtered = array;
+        kept = expected;
+        auto odd = [](T value) { return static_cast<int>(value) % 2 == 1; };
+        kept.erase(std::remove_if(kept.begin(), kept.end(), odd), kept.end());
+        ASSERT_EQ(filtered.erase_if(odd), expected.size() - kept.size());
+        ASSERT_TRUE(std::equal(filtered.cbegin(), filtered.cend(), kept.begin(), kept.end())) << size;
+    }
+}
+
+TEST(DynamicArrayTest, SearchFloatingPointEquality) {
+    DynamicArray<double> array;
+    for (int i = 0; i < 40; ++i) {
+        array.push_back(i == 20 ? -0.0 : (i % 2 ? std::nan("") : 1.0));
+    }
+
+    EXPECT_EQ(array.find(std::nan("")), array.end());  // NaN equals nothing
+    EXPECT_EQ(array.find(0.0) - array.begin(), 20);  // -0.0 == 0.0
+    EXPECT_EQ(array.erase(1.0), 19u);
+    EXPECT_EQ(array.size(), 21u);
+}
+
+#if defined(__SIZEOF_INT128__)
+// Wider than any lane compare => not a simd::Arithmetic type, searched with std::find
+TEST(DynamicArrayTest, SearchInt128) {
+    static_assert(!renn::containers::simd::Arithmetic<__int128>);
+    DynamicArray<__int128> array;
+    for (int i = 0; i < 8; ++i) {
+        array.push_back(i);
+    }
+
+    const __int128 high = (static_cast<__int128>(1) << 64) | 3;  // Same low 8 bytes as 3
+    EXPECT_EQ(array.find(high), array.end());
+    EXPECT_EQ(array.count(high), 0u);
+    EXPECT_EQ(array.find(3) - array.begin(), 3);
+    array.push_back(high);
+    EXPECT_EQ(array.erase(high), 1u);
+    EXPECT_EQ(array.size(), 8u);
+}
+#endif
+
+// erase(size_t index) is disabled there => erase(value) is not ambiguous
+TEST(DynamicArrayTest, EraseSizeT) {
+    DynamicArray<size_t> array;
+    for (size_t i = 0; i < 10; ++i) {
+        array.push_back(i % 3);
+    }
+    EXPECT_EQ(array.erase(size_t{2}), 3u);
+    array.erase_at_index(0);
+    EXPECT_EQ(array.size(), 6u);
+    EXPECT_EQ(array[0], 1u);
+}
+
+TEST(DynamicArrayTest, EraseNonArithmetic) {
+    DynamicArray<std::string> array;
+    for (int i = 0; i < 30; ++i) {
+        array.push_back(std::to_string(i % 3));
+    }
+    EXPECT_EQ(array.count("1"), 10u);
+    EXPECT_EQ(array.erase(std::string("1")), 10u);
+    EXPECT_EQ(array.erase_if([](const std::string& s) { return s == "2"; }), 10u);
+    EXPECT_EQ(array.size(), 10u);
+    EXPECT_FALSE(array.contains("2"));
+}
+
+TEST(DynamicArrayTest, AppendAndInsertRange) {
+    allocations = 0;
+    DynamicArray<int, CountingAllocator<int>> array;
+    std::vector<int> source(1000);
+    std::iota(source.begin(), source.end(), 0);
+
+    array.append_range(source);  // Contiguous, trivially copyable => one allocation, memcpy
+    EXPECT_EQ(allocations, 1u);
+    EXPECT_EQ(array.size(), 1000u);
+
+    const int head[] = {-3, -2, -1};
+    array.insert_range(0, head);
+    array.insert(array.begin() + 500, source.begin(), source.begin() + 2);
+    array.insert_range(array.size(), std::views::iota(1000, 1003));  // Sized, not contiguous
+    array.insert_range(0, std::vector<int>{});
+
+    ASSERT_EQ(array.size(), 1008u);
+    EXPECT_EQ(array[0], -3);
+    EXPECT_EQ(array[3], 0);
+    EXPECT_EQ(array[499], 496);
+    EXPECT_EQ(array[500], 0);
+    EXPECT_EQ(array[501], 1);
+    EXPECT_EQ(array[502], 497);
+    EXPECT_EQ(array.back(), 1002);
+
+    // Single pass, unknown length
+    std::istringstream input("7 8 9");
+    array.insert_range(1, std::views::istream<int>(input));
+    EXPECT_EQ(array[0], -3);
+    EXPECT_EQ(array[1], 7);
+    EXPECT_EQ(array[3], 9);
+    EXPECT_EQ(array[4], -2);
+
+    EXPECT_THROW(array.insert_range(array.size() + 1, source), std::out_of_range);
+}
+
+TEST(DynamicArrayTest, InsertRangeNonTrivial) {
+    DynamicArray<std::string> array;
+    for (int i = 0; i < 10; ++i) {
+        array.push_back(std::to_string(i));
+    }
+    const char* words[] = {"a", "b"};
+    array.insert_range(5, words);  // Converting construction
+    array.append_range(std::vector<std::string>{"end"});
+
+    ASSERT_EQ(array.size(), 13u);
+    EXPECT_EQ(array[4], "4");
+    EXPECT_EQ(array[5], "a");
+    EXPECT_EQ(array[6], "b");
+    EXPECT_EQ(array[7], "5");
+    EXPECT_EQ(array.back(), "end");
+
+    // A throwing construction leaves the array unchanged
+    struct Thrower {
+        int n;
+        operator std::string() const {
+            if (n == 2) {
+                throw std::runtime_error("conversion");
+            }
+            return std::to_string(n);
+        }
+    };
+    const Thrower throwers[] = {{0}, {1}, {2}};
+    EXPECT_THROW(array.insert_range(0, throwers), std::runtime_error);
+    ASSERT_EQ(array.size(), 13u);
+    EXPECT_EQ(array[0], "0");
+}
+
+TEST(DynamicArrayTest, ResizeForOverwriteAndUnsafeSetSize) {
+    DynamicArray<uint8_t> buffer;
+    buffer.resize_for_overwrite(1 << 20);
+    EXPECT_EQ(buffer.size(), size_t{1} << 20);
+    std::memset(buffer.data(), 0xAB, buffer.size());
+    buffer.resize_for_overwrite(10);
+    EXPECT_EQ(buffer.size(), 10u);
+    EXPECT_EQ(buffer[9], 0xAB);
+
+    // Fill through data() the way read(2) would
+    DynamicArray<char> io;
+    io.reserve(64);
+    const char message[] = "payload";
+    std::memcpy(io.data(), message, sizeof(message));
+    io.unsafe_set_size(sizeof(message) - 1);
+    EXPECT_EQ(std::string(io.begin(), io.end()), "payload");
+    EXPECT_THROW(io.unsafe_set_size(65), std::length_error);
+
+    // Non-trivial T still gets constructed
+    DynamicArray<std::string> strings;
+    strings.resize_for_overwrite(3);
+    EXPECT_TRUE(strings[2].empty());
+
+    SmallArray<int, 4> small;
+    small.resize_for_overwrite(3);
+    EXPECT_TRUE(small.is_small());
+    small.append_range(std::vector<int>{1, 2, 3});
+    EXPECT_FALSE(small.is_small());
+    EXPECT_EQ(small.size(), 6u);
+    EXPECT_EQ(small.back(), 3);
+    small.clear();
+    small.insert_range(0, std::vector<int>{5, 6});
+    small.insert_range(1, std::vector<int>{7});
+    EXPECT_TRUE(small.is_small());
+    EXPECT_EQ(small[1], 7);
+    EXPECT_EQ(small[2], 6);
+}
+
+TEST(SmallArrayTest, NoAllocationWhileSmall) {
+    allocations = 0;
+    SmallArray<std::string, 4, CountingAllocator<std::string>> array;
+
+    array.push_back("a");
+    array.emplace_back(3, 'b');
+    array.insert(size_t{0}, std::string("c"));
+    array.erase_at_index(1);
+    array.insert(size_t{1}, array[0]);
+
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_TRUE(array.is_small());
+    ASSERT_EQ(array.size(), 3u);
+    EXPECT_EQ(array[0], "c");
+    EXPECT_EQ(array[1], "c");
+    EXPECT_EQ(array[2], "bbb");
+
+    // The fifth element spills to the heap
+    array.push_back("d");
+    array.push_back(array[0]);
+    EXPECT_EQ(allocations, 1u);
+    EXPECT_FALSE(array.is_small());
+    ASSERT_EQ(array.size(), 5u);
+    EXPECT_EQ(array.back(), "c");
+
+    array.clear();
+    EXPECT_TRUE(array.is_small());
+    EXPECT_EQ(array.capacity(), 4u);
+}
+
+TEST(SmallArrayTest, MatchesDynamicArray) {
+    SmallArray<int, 8> small;
+    DynamicArray<int> dynamic;
+
+    for (int i = 0; i < 40; ++i) {
+        small.push_back(i);
+        dynamic.push_back(i);
+        if (i % 3 == 0) {
+            small.insert(size_t{0}, -i);
+            dynamic.insert(size_t{0}, -i);
+        }
+        if (i % 5 == 0) {
+            small.erase_at_index(small.size() / 2);
+            dynamic.erase_at_index(dynamic.size() / 2);
+        }
+        ASSERT_TRUE(std::equal(small.begin(), small.end(), dynamic.cbegin(), dynamic.cend()));
+    }
+
+    SmallArray<int, 8> ranged{1, 2, 3};
+    const int extra[] = {7, 8};
+    ranged.insert(size_t{1}, std::begin(extra), std::end(extra));
+    EXPECT_EQ((std::vector<int>(ranged.begin(), ranged.end())), (std::vector<int>{1, 7, 8, 2, 3}));
+
+    ranged.insert(size_t{5}, {4, 5, 6, 7, 8});
+    EXPECT_FALSE(ranged.is_small());
+    EXPECT_EQ(ranged.size(), 10u);
+    EXPECT_EQ(ranged[9], 8);
+
+    EXPECT_EQ(ranged.erase(8), 2u);
+    EXPECT_EQ(ranged.size(), 8u);
+    EXPECT_EQ(ranged.count(7), 2u);
+    EXPECT_EQ(ranged.find(2) - ranged.begin(), 2);
+
+    SmallArray<int, 8> inline_only{1, 2, 1, 3};
+    EXPECT_EQ(inline_only.erase_if([](int v) { return v == 1; }), 2u);
+    EXPECT_TRUE(inline_only.is_small());
+    EXPECT_EQ(inline_only.size(), 2u);
+
+    ranged.resize(2);
+    EXPECT_EQ(ranged.size(), 2u);
+}
+
+TEST(SmallArrayTest, CopyAndMove) {
+    SmallArray<std::unique_ptr<int>, 2> small;
+    small.push_back(std::make_unique<int>(1));
+
+    SmallArray<std::unique_ptr<int>, 2> moved(std::move(small));
+    EXPECT_TRUE(small.empty());
+    ASSERT_EQ(moved.size(), 1u);
+    EXPECT_EQ(*moved[0], 1);
+
+    moved.push_back(std::make_unique<int>(2));
+    moved.push_back(std::make_unique<int>(3));
+    small = std::move(moved);
+    EXPECT_FALSE(small.is_small());
+    EXPECT_EQ(*small[2], 3);
+
+    SmallArray<std::string, 2> strings{"x", "y"};
+    auto copy = strings;
+    copy[0] = "z";
+    EXPECT_EQ(strings[0], "x");
+    strings.assign(5, "w");
+    auto large_copy = strings;
+    EXPECT_EQ(large_copy.size(), 5u);
+    EXPECT_EQ(large_copy[4], "w");
+}
@@ -1,10 +1,18 @@
+#include "../src/Containers/HashTable/CompactHashTable.hpp"
 #include "../src/Containers/HashTable/HashTable.hpp"
+#include "../src/Containers/HashTable/RobinHoodHashTable.hpp"
+#include "../src/Containers/HashTable/SmallHashTable.hpp"
 #include "../src/Containers/HashTable/Hashers/CityHash.hpp"
 #include "../src/Containers/HashTable/Hashers/MurmurHash.hpp"
+#include "../src/Containers/HashTable/Hashers/WyHash.hpp"
+#include "../src/Scheduling/ThreadPool/ThreadPool.hpp"
 #include <chrono>
 #include <gtest/gtest.h>
 #include <random>
+#include <stdexcept>
 #include <string>
+#include <tuple>
+#include <unordered_set>
 
 template <typename Key, typename Value, typename Hash = std::hash<Key>>
 using HashTable = renn::containers::HashTable<Key, Value, Hash>;
@@ -45,12 +53,12 @@ TEST_F(HashTableTest, ConstructorWithBucketCount) {
 TEST_F(HashTableTest, EmplaceAndAccess) {
     auto [it1, inserted1] = table.emplace(1, "one");
     EXPECT_TRUE(inserted1);
-    EXPECT_EQ(it1->data_.second_, "one");
+    EXPECT_EQ(it1->data_.second, "one");
     EXPECT_EQ(table.size(), 1);
 
     auto [it2, inserted2] = table.emplace(1, "another one");
     EXPECT_FALSE(inserted2);
-    EXPECT_EQ(it2->data_.second_, "one");
+    EXPECT_EQ(it2->data_.second, "one");
     EXPECT_EQ(table.size(), 1);
 }
 
@@ -100,7 +108,7 @@ TEST_F(HashTableTest, Iterators) {
 
     size_t count = 0;
     for (auto it = table.begin(); it != table.end(); ++it) {
-        EXPECT_NE(it->data_.second_, "");
+        EXPECT_NE(it->data_.second, "");
         ++count;
     }
     EXPECT_EQ(count, 2);
@@ -255,7 +263,562 @@ TEST_F(HashTableTest, CustomKeyType) {
 TEST_F(HashTableTest, HashDistributionTest) {
 }
 
+TEST_F(HashTableTest, StatsOfEmptyTable) {
+    auto stats = table.stats();
+
+    EXPECT_EQ(stats.size, 0);
+    EXPECT_EQ(stats.bucket_count, table.bucket_count());
+    EXPECT_EQ(stats.empty_buckets, table.bucket_count());
+    EXPECT_FLOAT_EQ(stats.empty_bucket_fraction, 1.0f);
+    EXPECT_EQ(stats.max_chain_length, 0);
+    EXPECT_EQ(stats.chain_histogram[0], table.bucket_count());
+    EXPECT_EQ(stats.rehash_count, 0);
+}
+
+TEST_F(HashTableTest, StatsMatchBucketSizes) {
+    for (int i = 0; i < 1000; ++i) {
+        table.emplace(i, std::to_string(i));
+    }
+
+    auto stats = table.stats();
+    EXPECT_EQ(stats.size, 1000);
+    EXPECT_GT(stats.rehash_count, 0);
+    EXPECT_GT(stats.node_bytes, 0);
+    EXPECT_GE(stats.bucket_bytes, table.bucket_count() * sizeof(void*));
+
+    size_t histogram_total = 0;
+    for (size_t count : stats.chain_histogram) {
+        histogram_total += count;
+    }
+    EXPECT_EQ(histogram_total, table.bucket_count());
+
+    size_t max_bucket = 0;
+    size_t elements = 0;
+    for (size_t i = 0; i < table.bucket_count(); ++i) {
+        max_bucket = std::max(max_bucket, table.bucket_size(i));
+        elements += table.bucket_size(i);
+    }
+    EXPECT_EQ(stats.max_chain_length, max_bucket);
+    EXPECT_EQ(elements, 1000);
+
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(table.contains(i));
+    }
+}
+
+struct ConstantHash {
+    size_t operator()(int) const { return 0; }
+};
+
+TEST_F(HashTableTest, StatsDetectDegenerateHash) {
+    HashTable<int, int, ConstantHash> bad_table;
+
+    for (int i = 0; i < 100; ++i) {
+        bad_table.emplace(i, i);
+    }
+
+    auto stats = bad_table.stats();
+    EXPECT_EQ(stats.max_chain_length, 100);
+    EXPECT_FLOAT_EQ(stats.mean_chain_length, 100.0f);
+    EXPECT_EQ(stats.empty_buckets, bad_table.bucket_count() - 1);
+    EXPECT_EQ(stats.chain_histogram[renn::containers::HashTableStats::HISTOGRAM_BINS - 1], 1);
+}
+
+using CompactHashTable = renn::containers::CompactHashTable<int, std::string>;
+
+TEST(CompactHashTableTest, IteratesInInsertionOrder) {
+    CompactHashTable table;
+    const int keys[] = {42, 7, 1000, -3, 15};
+
+    for (int key : keys) {
+        EXPECT_TRUE(table.emplace(key, std::to_string(key)).second);
+    }
+    EXPECT_FALSE(table.emplace(7, "seven").second);
+    EXPECT_EQ(table.size(), 5);
+    EXPECT_EQ(table.at(7), "7");
+
+    size_t i = 0;
+    for (auto it = table.begin(); it != table.end(); ++it, ++i) {
+        EXPECT_EQ((*it).first, keys[i]);
+        EXPECT_EQ(it->second, std::to_string(keys[i]));
+    }
+    EXPECT_EQ(i, 5);
+}
+
+TEST(CompactHashTableTest, EraseIsCompactedLazily) {
+    CompactHashTable table;
+
+    for (int i = 0; i < 100; ++i) {
+        table.emplace(i, std::to_string(i));
+    }
+    for (int i = 0; i < 100; i += 2) {
+        EXPECT_TRUE(table.erase(i));
+    }
+    EXPECT_FALSE(table.erase(0));
+
+    EXPECT_EQ(table.size(), 50);
+    EXPECT_EQ(table.dead_count(), 50);
+    EXPECT_FALSE(table.contains(10));
+    EXPECT_TRUE(table.contains(11));
+
+    int expected = 1;
+    for (auto kv : table) {
+        EXPECT_EQ(kv.first, expected);
+        expected += 2;
+    }
+
+    table.shrink_to_fit();
+    EXPECT_EQ(table.dead_count(), 0);
+    EXPECT_EQ(table.size(), 50);
+    for (int i = 1; i < 100; i += 2) {
+        EXPECT_EQ(table.at(i), std::to_string(i));
+    }
+}
+
+TEST(CompactHashTableTest, IndexWidthGrowsWithSize) {
+    CompactHashTable table;
+    EXPECT_EQ(table.index_width(), 1);
+
+    const int NUM_ELEMENTS = 100000;
+    for (int i = 0; i < NUM_ELEMENTS; ++i) {
+        table[i] = std::to_string(i);
+    }
+
+    EXPECT_EQ(table.size(), NUM_ELEMENTS);
+    EXPECT_EQ(table.index_width(), 4);
+    EXPECT_LE(table.load_factor(), 2.0f / 3.0f);
+
+    for (int i = 0; i < NUM_ELEMENTS; ++i) {
+        EXPECT_EQ(table.at(i), std::to_string(i));
+    }
+
+    CompactHashTable moved(std::move(table));
+    EXPECT_EQ(moved.size(), NUM_ELEMENTS);
+    EXPECT_TRUE(table.empty());
+    EXPECT_FALSE(table.contains(1));
+
+    // Left without storage, still usable
+    EXPECT_EQ(table.bucket_count(), 0u);
+    EXPECT_EQ(table.memory_usage(), 0u);
+    EXPECT_EQ(table.begin(), table.end());
+    table[1] = "one";
+    EXPECT_EQ(table.at(1), "one");
+
+    moved = std::move(table);
+    EXPECT_EQ(moved.size(), 1);
+    EXPECT_EQ(table.bucket_count(), 0u);
+}
+
+// Stateful: counts the bytes live through the allocators copied from it
+template <typename T>
+struct TrackingAllocator {
+    using value_type = T;
+
+    size_t* live_bytes;
+
+    explicit TrackingAllocator(size_t* bytes) : live_bytes(bytes) {}
+
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U>& other) : live_bytes(other.live_bytes) {}
+
+    T* allocate(size_t n) {
+        *live_bytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        *live_bytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const TrackingAllocator<U>& other) const {
+        return live_bytes == other.live_bytes;
+    }
+};
+
+TEST(CompactHashTableTest, UsesTheGivenAllocator) {
+    using Allocator = TrackingAllocator<std::pair<int, std::string>>;
+    using Table = renn::containers::CompactHashTable<int, std::string, std::hash<int>, std::equal_to<int>, Allocator>;
+
+    size_t live_bytes = 0;
+    {
+        Table table(0, std::hash<int>(), std::equal_to<int>(), Allocator(&live_bytes));
+        EXPECT_GT(live_bytes, 0u);  // The initial index and entries
+
+        for (int i = 0; i < 1000; ++i) {
+            table[i] = std::to_string(i);
+        }
+        EXPECT_EQ(live_bytes, table.memory_usage());
+
+        Table moved(std::move(table));
+        EXPECT_EQ(live_bytes, moved.memory_usage());
+    }
+    EXPECT_EQ(live_bytes, 0u);
+}
+
+TEST_F(HashTableTest, BloomFilterPreCheck) {
+    for (int i = 0; i < 100; ++i) {
+        table.emplace(i, std::to_string(i));
+    }
+
+    table.enable_bloom_filter();
+    EXPECT_TRUE(table.has_bloom_filter());
+
+    // Inserts after enabling, including the ones that trigger rehashes
+    for (int i = 100; i < 10000; ++i) {
+        table.emplace(i, std::to_string(i));
+    }
+
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_TRUE(table.contains(i));
+    }
+    for (int i = 10000; i < 20000; ++i) {
+        EXPECT_FALSE(table.contains(i));
+    }
+
+    table.erase(5);
+    EXPECT_FALSE(table.contains(5));
+
+    HashTable<int, std::string> copy(table);
+    EXPECT_TRUE(copy.has_bloom_filter());
+    EXPECT_TRUE(copy.contains(6));
+
+    table.disable_bloom_filter();
+    EXPECT_TRUE(table.contains(6));
+}
+
+TEST(HashTableParallelRehashTest, MatchesSequentialRehash) {
+    constexpr int N = 200000;
+
+    HashTable<int, int> parallel;
+    HashTable<int, int> sequential;
+    for (int i = 0; i < N; ++i) {
+        parallel.emplace(i * 7, i);
+        sequential.emplace(i * 7, i);
+    }
+
+    auto* anchor = &parallel.at(700);
+
+    renn::ThreadPool pool(4);
+    pool.start();
+    parallel.rehash(500000, pool);
+    sequential.rehash(500000);
+    pool.stop();
+
+    EXPECT_EQ(parallel.bucket_count(), sequential.bucket_count());
+    EXPECT_EQ(parallel.size(), static_cast<size_t>(N));
+    EXPECT_EQ(&parallel.at(700), anchor);  // Nodes are relinked, not moved
+
+    for (int i = 0; i < N; ++i) {
+        ASSERT_EQ(parallel.at(i * 7), i);
+    }
+    EXPECT_FALSE(parallel.contains(1));
+
+    // Buckets are contiguous runs => same chain statistics as the sequential version
+    auto parallel_stats = parallel.stats();
+    auto sequential_stats = sequential.stats();
+    EXPECT_EQ(parallel_stats.empty_buckets, sequential_stats.empty_buckets);
+    EXPECT_EQ(parallel_stats.max_chain_length, sequential_stats.max_chain_length);
+    EXPECT_EQ(parallel_stats.chain_histogram, sequential_stats.chain_histogram);
+
+    size_t counted = 0;
+    for (auto it = parallel.begin(); it != parallel.end(); ++it) {
+        ++counted;
+    }
+    EXPECT_EQ(counted, static_cast<size_t>(N));
+
+    // Still usable afterwards
+    parallel.emplace(1, 1);
+    parallel.erase(700);
+    EXPECT_TRUE(parallel.contains(1));
+    EXPECT_FALSE(parallel.contains(700));
+}
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+using RobinHoodHashTable = renn::containers::RobinHoodHashTable<Key, Value, Hash>;
+
+TEST(RobinHoodHashTableTest, InsertFindErase) {
+    RobinHoodHashTable<int, std::string> table;
+
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(table.emplace(i, std::to_string(i)).second);
+    }
+    EXPECT_FALSE(table.emplace(5, "five").second);
+    EXPECT_EQ(table.size(), 1000);
+    EXPECT_LE(table.load_factor(), table.max_load_factor());
+
+    for (int i = 0; i < 1000; i += 3) {
+        EXPECT_TRUE(table.erase(i));
+    }
+    EXPECT_FALSE(table.erase(0));
+
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(table.contains(i), i % 3 != 0);
+    }
+    EXPECT_EQ(table.at(1), "1");
+    EXPECT_THROW(table.at(3), std::out_of_range);
+
+    size_t count = 0;
+    for (auto kv : table) {
+        EXPECT_EQ(kv.second, std::to_string(kv.first));
+        ++count;
+    }
+    EXPECT_EQ(count, table.size());
+}
+
+TEST(RobinHoodHashTableTest, HighLoadFactor) {
+    RobinHoodHashTable<uint64_t, uint64_t> table(0, 0.95f);
+    std::mt19937_64 rng(42);
+    std::vector<uint64_t> keys;
+
+    for (int i = 0; i < 100000; ++i) {
+        keys.push_back(rng());
+        table[keys.back()] = i;
+    }
+
+    EXPECT_GT(table.load_factor(), 0.45f);
+    EXPECT_LE(table.load_factor(), 0.95f);
+
+    // Erase half, backward shift must keep every remaining key reachable
+    for (size_t i = 0; i < keys.size(); i += 2) {
+        EXPECT_TRUE(table.erase(keys[i]));
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(table.contains(keys[i]), i % 2 == 1);
+    }
+    for (uint64_t i = 0; i < 10000; ++i) {
+        EXPECT_FALSE(table.contains(rng()));
+    }
+}
+
+TEST(RobinHoodHashTableTest, CopyAndMove) {
+    RobinHoodHashTable<std::string, int> table;
+    table["one"] = 1;
+    table["two"] = 2;
+
+    auto copy = table;
+    copy["one"] = 10;
+    EXPECT_EQ(table.at("one"), 1);
+    EXPECT_EQ(copy.at("one"), 10);
+
+    auto moved = std::move(copy);
+    EXPECT_EQ(moved.size(), 2);
+    EXPECT_TRUE(copy.empty());
+
+    // Left without storage, still usable
+    EXPECT_EQ(copy.bucket_count(), 0u);
+    EXPECT_FALSE(copy.contains("one"));
+    EXPECT_EQ(copy.begin(), copy.end());
+    auto copy_of_moved_from = copy;
+    EXPECT_TRUE(copy_of_moved_from.empty());
+    copy["three"] = 3;
+    EXPECT_EQ(copy.at("three"), 3);
+    EXPECT_EQ(copy.size(), 1);
+}
+
+// Throws once 'calls_left' reaches 0 (while armed)
+struct ThrowingHash {
+    static inline int calls_left = -1;
+
+    size_t operator()(int key) const {
+        if (calls_left == 0) {
+            throw std::runtime_error("hash");
+        }
+        if (calls_left > 0) {
+            --calls_left;
+        }
+        return std::hash<int>()(key);
+    }
+};
+
+TEST(RobinHoodHashTableTest, ThrowDuringRehashLeavesTableUnchanged) {
+    RobinHoodHashTable<int, std::string, ThrowingHash> table;
+    int count = 0;
+    while (table.size() + 1 <= static_cast<size_t>(table.bucket_count() * table.max_load_factor())) {
+        table.emplace(count, std::to_string(count));
+        ++count;
+    }
+    const size_t buckets = table.bucket_count();
+
+    // The next insert grows: the rehash throws halfway through the elements
+    ThrowingHash::calls_left = 1 + count / 2;  // The lookup of the new key, then half of the old ones
+    EXPECT_THROW(table.emplace(count, "new"), std::runtime_error);
+    ThrowingHash::calls_left = -1;
+
+    EXPECT_EQ(table.bucket_count(), buckets);
+    EXPECT_EQ(table.size(), static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(table.at(i), std::to_string(i));
+    }
+    EXPECT_FALSE(table.contains(count));
+
+    table.emplace(count, "new");
+    EXPECT_GT(table.bucket_count(), buckets);
+    EXPECT_EQ(table.at(count), "new");
+}
+
+TEST(RobinHoodHashTableTest, DegenerateHashOverflows) {
+    RobinHoodHashTable<int, int, ConstantHash> table;
+
+    EXPECT_THROW({
+        for (int i = 0; i < 1000; ++i) {
+            table.emplace(i, i);
+        }
+    }, std::overflow_error);
+}
+
+using SmallHashTable = renn::containers::SmallHashTable<int, std::string, 4>;
+
+TEST(SmallHashTableTest, StaysInlineUpToN) {
+    SmallHashTable table;
+    EXPECT_TRUE(table.is_small());
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(table.emplace(i, std::to_string(i)).second);
+    }
+    EXPECT_FALSE(table.emplace(2, "two").second);
+    EXPECT_TRUE(table.is_small());
+    EXPECT_EQ(table.size(), 4);
+    EXPECT_EQ(table.at(3), "3");
+    EXPECT_THROW(table.at(4), std::out_of_range);
+
+    EXPECT_TRUE(table.erase(1));
+    EXPECT_FALSE(table.erase(1));
+    EXPECT_EQ(table.size(), 3);
+    EXPECT_TRUE(table.contains(0));
+    EXPECT_TRUE(table.contains(3));
+
+    size_t count = 0;
+    for (auto kv : table) {
+        EXPECT_EQ(kv.second, std::to_string(kv.first));
+        ++count;
+    }
+    EXPECT_EQ(count, 3);
+}
+
+TEST(SmallHashTableTest, SwitchesToHashedRepresentation) {
+    SmallHashTable table;
+
+    for (int i = 0; i < 100; ++i) {
+        table[i] = std::to_string(i);
+    }
+    EXPECT_FALSE(table.is_small());
+    EXPECT_EQ(table.size(), 100);
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(table.at(i), std::to_string(i));
+    }
+
+    size_t count = 0;
+    for (auto it = table.begin(); it != table.end(); ++it) {
+        EXPECT_EQ(it->second, std::to_string(it->first));
+        ++count;
+    }
+    EXPECT_EQ(count, 100);
+
+    table.clear();
+    EXPECT_TRUE(table.is_small());
+    EXPECT_TRUE(table.empty());
+}
+
+TEST(SmallHashTableTest, CopyAndMove) {
+    SmallHashTable small{{1, "one"}, {2, "two"}};
+    SmallHashTable copy(small);
+    copy[1] = "uno";
+    EXPECT_EQ(small.at(1), "one");
+
+    SmallHashTable moved(std::move(copy));
+    EXPECT_EQ(moved.at(1), "uno");
+    EXPECT_TRUE(copy.empty());
+
+    SmallHashTable large;
+    for (int i = 0; i < 10; ++i) {
+        large[i] = std::to_string(i);
+    }
+    moved = large;
+    EXPECT_FALSE(moved.is_small());
+    EXPECT_EQ(moved.size(), 10);
+
+    const SmallHashTable& const_ref = moved;
+    EXPECT_NE(const_ref.find(5), const_ref.end());
+    EXPECT_EQ(const_ref.find(50), const_ref.end());
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
+
+namespace wyhash_test {
+
+struct Point {
+    int x;
+    double y;  // 4 bytes of padding before it => must not be hashed raw
+
+    bool operator==(const Point&) const = default;
+};
+
+void hash_append(renn::hashing::HashState& state, const Point& p) {
+    hash_append(state, p.x, p.y);
+}
+
+struct Packed {
+    uint32_t a;
+    uint32_t b;
+};
+
+}  // namespace wyhash_test
+
+TEST(WyHashTest, BytesAreDeterministicAndSeeded) {
+    const std::string text = "The quick brown fox jumps over the lazy dog";
+
+    // Every length class: 0, 1..3, 4..16, 17..47, 48+
+    for (size_t len = 0; len <= text.size(); ++len) {
+        EXPECT_EQ(renn::hashing::wyhash(text.data(), len), renn::hashing::wyhash(text.data(), len));
+        EXPECT_NE(renn::hashing::wyhash(text.data(), len, 1), renn::hashing::wyhash(text.data(), len, 2));
+    }
+
+    std::unordered_set<uint64_t> prefixes;
+    for (size_t len = 0; len <= text.size(); ++len) {
+        prefixes.insert(renn::hashing::wyhash(text.data(), len));
+    }
+    EXPECT_EQ(prefixes.size(), text.size() + 1);
+}
+
+TEST(WyHashTest, IntegerFastPathSpreadsLowBits) {
+    // Sequential keys must not collide in the low bits used by power-of-two tables
+    std::unordered_set<uint64_t> low_bits;
+    for (uint64_t i = 0; i < 4096; ++i) {
+        low_bits.insert(WyHash<uint64_t>{}(i) & 0xFFFF);
+    }
+    EXPECT_GT(low_bits.size(), 3900u);
+}
+
+TEST(WyHashTest, ComposableTypes) {
+    using wyhash_test::Point;
+
+    WyHash<Point> point_hash;
+    EXPECT_EQ(point_hash(Point{1, 2.0}), point_hash(Point{1, 2.0}));
+    EXPECT_NE(point_hash(Point{1, 2.0}), point_hash(Point{2, 1.0}));
+    EXPECT_EQ(point_hash(Point{1, 0.0}), point_hash(Point{1, -0.0}));
+
+    WyHash<std::pair<std::string, std::string>> pair_hash;
+    EXPECT_NE(pair_hash({"ab", "c"}), pair_hash({"a", "bc"}));
+
+    WyHash<std::tuple<int, std::string, Point>> tuple_hash;
+    EXPECT_EQ(tuple_hash({1, "x", Point{3, 4.0}}), tuple_hash({1, "x", Point{3, 4.0}}));
+
+    // No padding => hashed as raw bytes without a hash_append overload
+    WyHash<wyhash_test::Packed> packed_hash;
+    EXPECT_NE(packed_hash({1, 2}), packed_hash({2, 1}));
+
+    HashTable<Point, int, WyHash<Point>> table;
+    for (int i = 0; i < 1000; ++i) {
+        table.emplace(Point{i, i * 0.5}, i);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(table.at(Point{i, i * 0.5}), i);
+    }
+    EXPECT_LT(table.stats().max_chain_length, 8u);
+}
@@ -0,0 +1,175 @@
+#include "../src/Containers/IntrusiveList.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using renn::containers::IntrusiveList;
+using renn::containers::IntrusiveListHook;
+using renn::containers::LinkMode;
+
+namespace {
+
+struct Task {
+    std::string name;
+    IntrusiveListHook<> queue_hook;
+    IntrusiveListHook<> all_hook;  // Second hook => a second list at the same time
+
+    explicit Task(std::string n) : name(std::move(n)) {}
+};
+
+struct Waiter {
+    int id;
+    IntrusiveListHook<LinkMode::AUTO_UNLINK> hook;
+};
+
+using Queue = IntrusiveList<Task, &Task::queue_hook>;
+using All = IntrusiveList<Task, &Task::all_hook>;
+using WaitList = IntrusiveList<Waiter, &Waiter::hook>;
+
+std::vector<std::string> names(const Queue& queue) {
+    std::vector<std::string> result;
+    for (const Task& task : queue) {
+        result.push_back(task.name);
+    }
+    return result;
+}
+
+}  // namespace
+
+static_assert(std::bidirectional_iterator<Queue::iterator>);
+static_assert(std::bidirectional_iterator<Queue::const_iterator>);
+
+TEST(IntrusiveListTest, LinksInPlace) {
+    Task a("a"), b("b"), c("c");
+    Queue queue;
+    All all;
+
+    queue.push_back(b);
+    queue.push_front(a);
+    queue.insert(queue.end(), c);
+    all.push_back(c);
+    all.push_back(a);
+
+    EXPECT_EQ(names(queue), (std::vector<std::string>{"a", "b", "c"}));
+    EXPECT_EQ(&queue.front(), &a);  // The objects themselves, no copies
+    EXPECT_EQ(&all.back(), &a);
+    EXPECT_EQ(queue.size(), 3u);
+    EXPECT_THROW(queue.push_back(a), std::logic_error);
+
+    queue.erase(b);  // By reference
+    EXPECT_FALSE(b.queue_hook.is_linked());
+    EXPECT_EQ(names(queue), (std::vector<std::string>{"a", "c"}));
+    EXPECT_EQ(all.size(), 2u);
+
+    auto it = queue.erase(queue.iterator_to(a));
+    EXPECT_EQ(&*it, &c);
+    queue.pop_back();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_THROW(queue.front(), std::out_of_range);
+    EXPECT_TRUE(a.all_hook.is_linked());
+}
+
+TEST(IntrusiveListTest, MatchesStdList) {
+    std::vector<std::unique_ptr<Task>> tasks;
+    for (int i = 0; i < 64; ++i) {
+        tasks.push_back(std::make_unique<Task>(std::to_string(i)));
+    }
+    Queue queue;
+    std::list<Task*> reference;
+    std::mt19937 rng(3);
+
+    for (int step = 0; step < 20000; ++step) {
+        Task& task = *tasks[rng() % tasks.size()];
+        if (task.queue_hook.is_linked()) {
+            auto ref = std::find(reference.begin(), reference.end(), &task);
+            reference.erase(ref);
+            queue.erase(task);
+        } else if (rng() % 2 == 0) {
+            reference.push_back(&task);
+            queue.push_back(task);
+        } else {
+            reference.push_front(&task);
+            queue.push_front(task);
+        }
+        ASSERT_EQ(queue.size(), reference.size());
+    }
+
+    ASSERT_TRUE(std::equal(queue.begin(), queue.end(), reference.begin(), reference.end(),
+                           [](const Task& task, const Task* expected) { return &task == expected; }));
+    ASSERT_TRUE(std::equal(queue.rbegin(), queue.rend(), reference.rbegin(), reference.rend(),
+                           [](const Task& task, const Task* expected) { return &task == expected; }));
+
+    queue.clear();
+    for (const auto& task : tasks) {
+        ASSERT_FALSE(task->queue_hook.is_linked());
+    }
+}
+
+TEST(IntrusiveListTest, Splice) {
+    Task a("a"), b("b"), c("c"), d("d"), e("e");
+    Queue first, second;
+    first.push_back(a);
+    first.push_back(b);
+    second.push_back(c);
+    second.push_back(d);
+    second.push_back(e);
+
+    first.splice(std::next(first.begin()), second, second.iterator_to(d));
+    EXPECT_EQ(names(first), (std::vector<std::string>{"a", "d", "b"}));
+    EXPECT_EQ(names(second), (std::vector<std::string>{"c", "e"}));
+
+    first.splice(first.begin(), second, second.begin(), second.end());
+    EXPECT_EQ(names(first), (std::vector<std::string>{"c", "e", "a", "d", "b"}));
+    EXPECT_TRUE(second.empty());
+    EXPECT_EQ(first.size(), 5u);
+
+    // Within one list: rotate the first two to the back
+    first.splice(first.end(), first, first.begin(), std::next(first.begin(), 2));
+    EXPECT_EQ(names(first), (std::vector<std::string>{"a", "d", "b", "c", "e"}));
+    first.splice(first.begin(), first, first.iterator_to(e));
+    EXPECT_EQ(names(first), (std::vector<std::string>{"e", "a", "d", "b", "c"}));
+
+    second.splice(second.end(), first);
+    EXPECT_TRUE(first.empty());
+    EXPECT_EQ(second.size(), 5u);
+
+    Queue moved(std::move(second));
+    EXPECT_TRUE(second.empty());
+    EXPECT_EQ(names(moved), (std::vector<std::string>{"e", "a", "d", "b", "c"}));
+    Task f("f");
+    moved.push_back(f);  // The moved-to list's end elements point at its own sentinel
+    EXPECT_EQ(&*std::prev(moved.end(), 2), &c);
+    moved.pop_back();
+    EXPECT_EQ(moved.size(), 5u);
+}
+
+TEST(IntrusiveListTest, AutoUnlink) {
+    WaitList waiters;
+    Waiter kept{1, {}};
+    waiters.push_back(kept);
+    {
+        Waiter timed_out{2, {}};
+        waiters.push_back(timed_out);
+        Waiter copy = timed_out;  // Starts unlinked
+        EXPECT_FALSE(copy.hook.is_linked());
+        EXPECT_EQ(waiters.size(), 2u);
+    }  // Leaves the list on destruction
+    EXPECT_EQ(waiters.size(), 1u);
+    EXPECT_EQ(waiters.front().id, 1);
+
+    kept.hook.unlink();
+    EXPECT_TRUE(waiters.empty());
+
+    auto waiter = std::make_unique<Waiter>(Waiter{3, {}});
+    {
+        WaitList scoped;
+        scoped.push_back(*waiter);
+    }  // The list dies first => unlinks, the waiter's later destruction is a no-op
+    EXPECT_FALSE(waiter->hook.is_linked());
+}
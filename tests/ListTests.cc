@@ -1,6 +1,12 @@
 #include "../src/Containers/List.hpp"
+#include <algorithm>
+#include <functional>
 #include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 template <typename T>
 using List = renn::containers::List<T>;
@@ -311,3 +317,110 @@ TEST_F(ListTest, NonCopyableTypes) {
     EXPECT_NO_THROW(non_copyable_list.emplace(non_copyable_list.begin()));
     EXPECT_NO_THROW(non_copyable_list.emplace(non_copyable_list.end()));
 }
+
+TEST_F(ListTest, SortIsStableAndRelinks) {
+    List<std::pair<int, int>> pairs;  // (key, insertion index)
+    std::vector<std::pair<int, int>> reference;
+    std::mt19937 rng(7);
+    for (int i = 0; i < 10000; ++i) {
+        pairs.push_back({static_cast<int>(rng() % 100), i});
+        reference.push_back(pairs.back());
+    }
+    const std::pair<int, int>* first_address = &pairs.front();
+    const int first_key = pairs.front().first;
+    auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+
+    pairs.sort(by_key);
+    std::stable_sort(reference.begin(), reference.end(), by_key);
+
+    ASSERT_EQ(pairs.size(), reference.size());
+    EXPECT_TRUE(std::equal(pairs.begin(), pairs.end(), reference.begin()));
+    EXPECT_TRUE(std::equal(pairs.rbegin(), pairs.rend(), reference.rbegin()));  // prev links rebuilt
+
+    // Nodes moved, not the values: the first inserted element is still at its address, with its value
+    const auto first = std::find(pairs.begin(), pairs.end(), std::pair<int, int>{first_key, 0});
+    ASSERT_NE(first, pairs.end());
+    EXPECT_EQ(&*first, first_address);
+
+    for (int i = 0; i < 50; ++i) {
+        list.push_back((i * 37) % 50);
+    }
+    list.sort(std::greater<>());
+    EXPECT_EQ(list.front(), 49);
+    EXPECT_EQ(list.back(), 0);
+    EXPECT_TRUE(std::is_sorted(list.begin(), list.end(), std::greater<>()));
+}
+
+TEST_F(ListTest, SortThrowingComparatorKeepsElements) {
+    for (int i = 0; i < 1000; ++i) {
+        list.push_back(1000 - i);
+    }
+    int calls = 0;
+    EXPECT_THROW(list.sort([&](int a, int b) {
+        if (++calls == 3000) {
+            throw std::runtime_error("comparator");
+        }
+        return a < b;
+    }),
+                 std::runtime_error);
+
+    ASSERT_EQ(list.size(), 1000u);
+    std::vector<int> values(list.begin(), list.end());
+    ASSERT_EQ(static_cast<size_t>(std::distance(list.rbegin(), list.rend())), 1000u);
+    std::sort(values.begin(), values.end());
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(values[i], i + 1);
+    }
+    list.sort();
+    EXPECT_TRUE(std::is_sorted(list.begin(), list.end()));
+}
+
+TEST_F(ListTest, Merge) {
+    List<int> other;
+    for (int i = 0; i < 10; ++i) {
+        list.push_back(i * 2);
+        other.push_back(i * 3);
+    }
+    const int* moved_address = &other.back();
+
+    list.merge(other);
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ(list.size(), 20u);
+    EXPECT_TRUE(std::is_sorted(list.begin(), list.end()));
+    EXPECT_EQ(&list.back(), moved_address);  // 27, relinked from 'other'
+
+    List<int> empty;
+    list.merge(empty);
+    empty.merge(list);
+    EXPECT_EQ(empty.size(), 20u);
+    EXPECT_TRUE(list.empty());
+    EXPECT_TRUE(std::is_sorted(empty.rbegin(), empty.rend(), std::greater<>()));
+}
+
+TEST_F(ListTest, Splice) {
+    List<int> other;
+    for (int i = 0; i < 5; ++i) {
+        list.push_back(i);
+        other.push_back(10 + i);
+    }
+
+    auto from = std::next(other.begin());
+    auto to = std::next(other.begin(), 3);
+    list.splice(std::next(list.begin()), other, from, to);
+    EXPECT_EQ(std::vector<int>(list.begin(), list.end()), (std::vector<int>{0, 11, 12, 1, 2, 3, 4}));
+    EXPECT_EQ(std::vector<int>(other.begin(), other.end()), (std::vector<int>{10, 13, 14}));
+    EXPECT_EQ(list.size(), 7u);
+    EXPECT_EQ(other.size(), 3u);
+    EXPECT_EQ(*from, 11);  // Iterators follow their nodes
+
+    list.splice(list.end(), list, list.begin(), std::next(list.begin(), 3));
+    EXPECT_EQ(std::vector<int>(list.begin(), list.end()), (std::vector<int>{1, 2, 3, 4, 0, 11, 12}));
+
+    list.splice(list.begin(), other);
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ(list.size(), 10u);
+    EXPECT_EQ(list.front(), 10);
+    EXPECT_EQ(list.back(), 12);
+    other.push_back(1);  // Still usable after being emptied
+    EXPECT_EQ(other.front(), 1);
+}
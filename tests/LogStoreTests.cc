@@ -0,0 +1,244 @@
+#include "../src/Scheduling/ThreadPool/ThreadPool.hpp"
+#include "../src/Storage/LogStore.hpp"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using renn::storage::LogStore;
+using renn::storage::LogStoreOptions;
+
+class LogStoreTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        directory_ = std::filesystem::temp_directory_path() /
+                     ("renn-logstore-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "-" +
+                      ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove_all(directory_);
+        pool_.start();
+    }
+
+    void TearDown() override {
+        pool_.stop();
+        std::filesystem::remove_all(directory_);
+    }
+
+    static LogStoreOptions small_segments() {
+        LogStoreOptions options;
+        options.segment_size = 4096;
+        options.auto_compaction = false;
+        return options;
+    }
+
+    size_t files_with_extension(const char* extension) const {
+        size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(directory_)) {
+            count += entry.path().extension() == extension;
+        }
+        return count;
+    }
+
+    std::filesystem::path directory_;
+    renn::ThreadPool pool_{4};
+};
+
+TEST_F(LogStoreTest, PutGetErase) {
+    LogStore store(directory_, pool_);
+
+    store.put("alpha", "1");
+    store.put("beta", "2");
+    store.put("alpha", "3");
+
+    EXPECT_EQ(store.get("alpha"), "3");
+    EXPECT_EQ(store.get("beta"), "2");
+    EXPECT_EQ(store.get("gamma"), std::nullopt);
+
+    store.erase("beta");
+    EXPECT_FALSE(store.contains("beta"));
+    EXPECT_EQ(store.size(), 1u);
+
+    // Empty values are values, not tombstones
+    store.put("empty", "");
+    EXPECT_EQ(store.get("empty"), "");
+}
+
+TEST_F(LogStoreTest, ReopenRebuildsIndex) {
+    {
+        LogStore store(directory_, pool_, small_segments());
+        for (int i = 0; i < 500; ++i) {
+            store.put("key" + std::to_string(i), "value" + std::to_string(i));
+        }
+        for (int i = 0; i < 500; i += 5) {
+            store.erase("key" + std::to_string(i));
+        }
+        EXPECT_GT(store.stats().segments, 1u);
+    }
+
+    auto check = [this] {
+        LogStore store(directory_, pool_, small_segments());
+        EXPECT_EQ(store.size(), 400u);
+        for (int i = 0; i < 500; ++i) {
+            auto value = store.get("key" + std::to_string(i));
+            if (i % 5 == 0) {
+                EXPECT_EQ(value, std::nullopt);
+            } else {
+                EXPECT_EQ(value, "value" + std::to_string(i));
+            }
+        }
+    };
+
+    // From the hint files, then from the logs alone
+    EXPECT_GT(files_with_extension(".hint"), 0u);
+    check();
+
+    for (const auto& entry : std::filesystem::directory_iterator(directory_)) {
+        if (entry.path().extension() == ".hint") {
+            std::filesystem::remove(entry.path());
+        }
+    }
+    check();
+}
+
+TEST_F(LogStoreTest, GroupCommitBatchesConcurrentWriters) {
+    LogStore store(directory_, pool_);
+
+    constexpr int THREADS = 8;
+    constexpr int WRITES = 200;
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < THREADS; ++t) {
+        writers.emplace_back([&store, t] {
+            for (int i = 0; i < WRITES; ++i) {
+                store.put(std::to_string(t) + ":" + std::to_string(i), std::to_string(i));
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    auto stats = store.stats();
+    EXPECT_EQ(stats.writes, static_cast<size_t>(THREADS * WRITES));
+    EXPECT_LE(stats.commits, stats.writes);
+    EXPECT_EQ(store.size(), static_cast<size_t>(THREADS * WRITES));
+    EXPECT_EQ(store.get("7:199"), "199");
+}
+
+TEST_F(LogStoreTest, OversizedRecordIsRejectedAlone) {
+    constexpr int THREADS = 4;
+    constexpr int WRITES = 20;
+    const std::string oversized(5000, 'x');  // > segment_size
+
+    {
+        LogStore store(directory_, pool_, small_segments());
+        store.put("before", "1");
+
+        // Interleaved with other writers => lands in batches with small records
+        std::vector<std::thread> writers;
+        for (int t = 0; t < THREADS; ++t) {
+            writers.emplace_back([&store, t] {
+                for (int i = 0; i < WRITES; ++i) {
+                    store.put(std::to_string(t) + ":" + std::to_string(i), "v");
+                }
+            });
+        }
+        for (int i = 0; i < WRITES; ++i) {
+            EXPECT_THROW(store.put("big", oversized), std::length_error);
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+
+        EXPECT_EQ(store.size(), static_cast<size_t>(THREADS * WRITES + 1));
+        EXPECT_FALSE(store.contains("big"));
+        EXPECT_EQ(store.stats().segments, 1u);  // No segment sealed for it
+    }
+
+    LogStore store(directory_, pool_, small_segments());
+    EXPECT_EQ(store.size(), static_cast<size_t>(THREADS * WRITES + 1));
+    EXPECT_FALSE(store.contains("big"));
+    EXPECT_EQ(store.get("before"), "1");
+    EXPECT_EQ(store.get("3:19"), "v");
+}
+
+TEST_F(LogStoreTest, CompactionDropsGarbageSegments) {
+    {
+        LogStore store(directory_, pool_, small_segments());
+
+        // Every key overwritten many times => old segments are almost all garbage
+        for (int round = 0; round < 20; ++round) {
+            for (int i = 0; i < 20; ++i) {
+                store.put("key" + std::to_string(i), "round" + std::to_string(round));
+            }
+        }
+        store.erase("key0");
+        store.rotate();
+
+        const auto before = store.stats();
+        store.compact();
+        const auto after = store.stats();
+
+        EXPECT_GT(after.compactions, 0u);
+        EXPECT_LT(after.segments, before.segments);
+        EXPECT_LT(after.dead_bytes, before.dead_bytes);
+        EXPECT_EQ(store.get("key7"), "round19");
+        EXPECT_FALSE(store.contains("key0"));
+    }
+
+    // Nothing resurrected: not the overwritten values, not the erased key
+    LogStore store(directory_, pool_, small_segments());
+    EXPECT_EQ(store.size(), 19u);
+    EXPECT_FALSE(store.contains("key0"));
+    for (int i = 1; i < 20; ++i) {
+        EXPECT_EQ(store.get("key" + std::to_string(i)), "round19");
+    }
+}
+
+TEST_F(LogStoreTest, BackgroundCompaction) {
+    auto options = small_segments();
+    options.auto_compaction = true;
+
+    {
+        LogStore store(directory_, pool_, options);
+        for (int round = 0; round < 50; ++round) {
+            store.put("hot", std::string(100, static_cast<char>('a' + round % 26)));
+        }
+        store.schedule_compaction();
+    }  // Waits for the scheduled renns
+
+    LogStore store(directory_, pool_, options);
+    EXPECT_EQ(store.get("hot"), std::string(100, static_cast<char>('a' + 49 % 26)));
+    EXPECT_EQ(store.size(), 1u);
+}
+
+TEST_F(LogStoreTest, TornTailIsDiscarded) {
+    {
+        LogStore store(directory_, pool_);
+        store.put("kept", "yes");
+    }
+
+    // Garbage right after the last record, as a torn write would leave it
+    std::filesystem::path log;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_)) {
+        if (entry.path().extension() == ".log") {
+            log = entry.path();
+        }
+    }
+    {
+        std::FILE* file = std::fopen(log.c_str(), "r+b");
+        ASSERT_NE(file, nullptr);
+        std::fseek(file, 32, SEEK_SET);
+        const char garbage[] = "\x10\x00\x00\x00garbage-garbage";
+        std::fwrite(garbage, 1, sizeof(garbage), file);
+        std::fclose(file);
+    }
+
+    LogStore store(directory_, pool_);
+    EXPECT_EQ(store.get("kept"), "yes");
+    EXPECT_EQ(store.size(), 1u);
+
+    store.put("after", "crash");
+    EXPECT_EQ(store.get("after"), "crash");
+}
@@ -0,0 +1,139 @@
+#include "../src/Containers/LruCache.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using renn::containers::EvictionPolicy;
+
+template <typename Key, typename Value>
+using LruCache = renn::containers::LruCache<Key, Value>;
+
+template <typename Key, typename Value>
+using ShardedLruCache = renn::containers::ShardedLruCache<Key, Value>;
+
+TEST(LruCacheTest, EvictsLeastRecentlyUsed) {
+    LruCache<int, std::string> cache(3);
+
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.put(3, "three");
+
+    ASSERT_NE(cache.get(1), nullptr);  // 2 is now the oldest
+    cache.put(4, "four");
+
+    EXPECT_EQ(cache.size(), 3);
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_EQ(*cache.get(1), "one");
+    EXPECT_EQ(*cache.get(4), "four");
+    EXPECT_EQ(cache.get(2), nullptr);
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, 3);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.evictions, 1);
+}
+
+TEST(LruCacheTest, PutOverwrites) {
+    LruCache<int, std::string> cache(2);
+
+    cache.put(1, "one");
+    cache.put(1, "uno");
+
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(*cache.get(1), "uno");
+    EXPECT_TRUE(cache.erase(1));
+    EXPECT_FALSE(cache.erase(1));
+    EXPECT_TRUE(cache.empty());
+}
+
+TEST(LruCacheTest, ClockGivesSecondChance) {
+    LruCache<int, int> cache(3, EvictionPolicy::Clock);
+
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);
+
+    cache.get(1);
+    cache.get(3);
+    cache.put(4, 4);  // 1 is referenced => skipped, 2 is the victim
+
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(3));
+    EXPECT_TRUE(cache.contains(4));
+
+    for (int i = 5; i < 100; ++i) {
+        cache.put(i, i);
+        EXPECT_EQ(cache.size(), 3);
+    }
+}
+
+struct StringWeight {
+    size_t operator()(int, const std::string& value) const { return value.size(); }
+};
+
+TEST(LruCacheTest, WeightBound) {
+    renn::containers::LruCache<int, std::string, std::hash<int>, std::equal_to<int>, StringWeight> cache(10);
+
+    EXPECT_TRUE(cache.put(1, std::string(4, 'a')));
+    EXPECT_TRUE(cache.put(2, std::string(4, 'b')));
+    EXPECT_EQ(cache.weight(), 8);
+
+    EXPECT_TRUE(cache.put(3, std::string(4, 'c')));
+    EXPECT_EQ(cache.weight(), 8);
+    EXPECT_FALSE(cache.contains(1));
+
+    EXPECT_FALSE(cache.put(4, std::string(11, 'd')));
+    EXPECT_FALSE(cache.contains(4));
+}
+
+TEST(ShardedLruCacheTest, ShardCapacitiesAddUpToCapacity) {
+    // (capacity, requested shards, expected shards): remainders go to the first shards, never more shards
+    // than entries
+    const std::tuple<size_t, size_t, size_t> cases[] = {{100, 16, 16}, {10, 16, 8}, {1, 16, 1}, {1000, 3, 4}};
+
+    for (const auto& [capacity, shard_count, expected_shards] : cases) {
+        ShardedLruCache<int, int> cache(capacity, shard_count);
+        EXPECT_EQ(cache.shard_count(), expected_shards);
+        EXPECT_EQ(cache.capacity(), capacity);
+
+        // Enough keys to fill every shard
+        for (int key = 0; key < 20000; ++key) {
+            cache.put(key, key);
+        }
+        EXPECT_EQ(cache.stats().size, capacity);
+    }
+}
+
+TEST(ShardedLruCacheTest, ConcurrentAccess) {
+    for (auto policy : {EvictionPolicy::Lru, EvictionPolicy::Clock}) {
+        ShardedLruCache<int, int> cache(1024, 8, policy);
+        constexpr int kThreads = 8;
+        constexpr int kOps = 20000;
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&cache, t] {
+                for (int i = 0; i < kOps; ++i) {
+                    const int key = (i * 7 + t) % 2048;
+                    if (auto value = cache.get(key)) {
+                        EXPECT_EQ(*value, key * 2);
+                    } else {
+                        cache.put(key, key * 2);
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        auto stats = cache.stats();
+        EXPECT_EQ(stats.hits + stats.misses, kThreads * kOps);
+        EXPECT_LE(stats.size, 1024);
+        EXPECT_GT(stats.hits, 0);
+    }
+}
@@ -0,0 +1,134 @@
+#include "../src/Containers/DynamicArray.hpp"
+#include "../src/Containers/MappedArray.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+using renn::containers::DynamicArray;
+using renn::containers::MappedArray;
+
+class MappedArrayTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        directory_ = std::filesystem::temp_directory_path() /
+                     ("renn-mapped-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "-" +
+                      ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory_);
+    }
+
+    std::filesystem::path directory_;
+};
+
+TEST_F(MappedArrayTest, PersistsAcrossReopen) {
+    const auto path = directory_ / "column.bin";
+    {
+        auto array = MappedArray<uint64_t>::create(path);
+        for (uint64_t i = 0; i < 100000; ++i) {  // Many remaps
+            array.push_back(i * i);
+        }
+        array.push_back(array[3]);
+        EXPECT_EQ(array.size(), 100001u);
+        EXPECT_GE(array.capacity(), array.size());
+        array.sync();
+    }
+
+    // Trimmed on close
+    EXPECT_EQ(std::filesystem::file_size(path), 64 + 100001 * sizeof(uint64_t));
+
+    const auto array = MappedArray<uint64_t>::open(path);
+    EXPECT_FALSE(array.writable());
+    ASSERT_EQ(array.size(), 100001u);
+    EXPECT_EQ(array[0], 0u);
+    EXPECT_EQ(array[99999], 99999ull * 99999ull);
+    EXPECT_EQ(array.back(), 9u);
+    EXPECT_TRUE(array.contains(144));
+    EXPECT_EQ(array.find(144) - array.begin(), 12);
+    EXPECT_EQ(array.count(9), 2u);
+    EXPECT_THROW(array.at(100001), std::out_of_range);
+}
+
+TEST_F(MappedArrayTest, WritableReopenAndResize) {
+    const auto path = directory_ / "values.bin";
+    {
+        auto array = MappedArray<double>::create(path, 10);
+        EXPECT_EQ(array.capacity(), 10u);
+        DynamicArray<double> batch(1000, 0.5);
+        array.append_range(batch);  // Contiguous => one memcpy
+        std::vector<int> ints = {1, 2, 3};
+        array.append_range(ints);   // Converted element by element
+        EXPECT_EQ(array.size(), 1003u);
+        EXPECT_EQ(array.back(), 3.0);
+    }
+    {
+        auto array = MappedArray<double>::open(path, true);
+        ASSERT_EQ(array.size(), 1003u);
+        array[0] = -1.0;
+        array.resize(500);
+        array.resize(600);  // Zeros past the old end, not the stale 0.5s
+        EXPECT_EQ(array[599], 0.0);
+        array.pop_back();
+        array.shrink_to_fit();
+        EXPECT_EQ(array.capacity(), 599u);
+    }
+
+    auto array = MappedArray<double>::open(path);
+    ASSERT_EQ(array.size(), 599u);
+    EXPECT_EQ(array[0], -1.0);
+    EXPECT_EQ(array[1], 0.5);
+    EXPECT_EQ(array[598], 0.0);
+}
+
+TEST_F(MappedArrayTest, ReadOnlyRejectsWrites) {
+    const auto path = directory_ / "ro.bin";
+    MappedArray<int32_t>::create(path).push_back(7);
+
+    auto array = MappedArray<int32_t>::open(path);
+    EXPECT_THROW(array.push_back(1), std::logic_error);
+    EXPECT_THROW(array.resize(10), std::logic_error);
+    EXPECT_EQ(array.at(0), 7);  // Non-const reads work, like operator[]
+    EXPECT_EQ(array[0], 7);
+    EXPECT_EQ(std::as_const(array).at(0), 7);
+}
+
+TEST_F(MappedArrayTest, RejectsForeignFiles) {
+    EXPECT_THROW(MappedArray<int>::open(directory_ / "missing.bin"), std::system_error);
+
+    const auto path = directory_ / "ints.bin";
+    MappedArray<int32_t>::create(path).push_back(1);
+    EXPECT_THROW(MappedArray<int32_t>::create(path), std::system_error);  // Exists
+    EXPECT_THROW(MappedArray<int64_t>::open(path), std::runtime_error);   // Element size
+
+    const auto other = directory_ / "other.bin";
+    {
+        std::FILE* file = std::fopen(other.c_str(), "wb");
+        const char junk[100] = "definitely not a mapped array";
+        std::fwrite(junk, 1, sizeof(junk), file);
+        std::fclose(file);
+    }
+    EXPECT_THROW(MappedArray<int32_t>::open(other), std::runtime_error);
+}
+
+TEST_F(MappedArrayTest, Move) {
+    auto a = MappedArray<uint16_t>::create(directory_ / "a.bin");
+    a.push_back(1);
+    auto b = std::move(a);
+    b.push_back(2);
+    EXPECT_EQ(b.size(), 2u);
+
+    auto c = MappedArray<uint16_t>::create(directory_ / "c.bin");
+    c = std::move(b);
+    EXPECT_EQ(c[1], 2);
+    EXPECT_EQ(c.path(), directory_ / "a.bin");
+}
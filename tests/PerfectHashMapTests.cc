@@ -0,0 +1,78 @@
+#include "../src/Containers/PerfectHashMap.hpp"
+#include <array>
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+
+using renn::containers::make_perfect_hash_map;
+
+namespace {
+
+enum class Token { If, Else, While, For, Return, Break, Continue, Switch, Case, Default };
+
+constexpr auto KEYWORDS = make_perfect_hash_map<std::string_view, Token>(std::array<std::pair<std::string_view, Token>, 10>{{
+    {"if", Token::If},
+    {"else", Token::Else},
+    {"while", Token::While},
+    {"for", Token::For},
+    {"return", Token::Return},
+    {"break", Token::Break},
+    {"continue", Token::Continue},
+    {"switch", Token::Switch},
+    {"case", Token::Case},
+    {"default", Token::Default},
+}});
+
+// Built and queried entirely at compile time
+static_assert(KEYWORDS.at("while") == Token::While);
+static_assert(KEYWORDS.contains("default"));
+static_assert(!KEYWORDS.contains("goto"));
+static_assert(KEYWORDS.size() == 10 && KEYWORDS.slot_count() == 16);
+
+template <size_t N>
+consteval std::array<std::pair<uint32_t, uint32_t>, N> make_opcodes() {
+    std::array<std::pair<uint32_t, uint32_t>, N> opcodes{};
+    for (uint32_t i = 0; i < N; ++i) {
+        opcodes[i] = {0x1000 + i * 0x40, i};  // Strided, like real opcode tables
+    }
+    return opcodes;
+}
+
+constexpr auto OPCODES = make_perfect_hash_map<uint32_t, uint32_t>(make_opcodes<200>());
+
+}  // namespace
+
+TEST(PerfectHashMapTest, StringKeys) {
+    EXPECT_EQ(KEYWORDS.at("if"), Token::If);
+    EXPECT_EQ(KEYWORDS.at("continue"), Token::Continue);
+
+    // Runtime strings, same lookup
+    std::string word = "ret";
+    word += "urn";
+    ASSERT_NE(KEYWORDS.find(word), nullptr);
+    EXPECT_EQ(*KEYWORDS.find(word), Token::Return);
+
+    EXPECT_EQ(KEYWORDS.find(""), nullptr);
+    EXPECT_EQ(KEYWORDS.find("iff"), nullptr);
+    EXPECT_THROW(KEYWORDS.at("goto"), std::out_of_range);
+}
+
+TEST(PerfectHashMapTest, IntegerKeys) {
+    for (uint32_t i = 0; i < 200; ++i) {
+        ASSERT_EQ(OPCODES.at(0x1000 + i * 0x40), i);
+        EXPECT_FALSE(OPCODES.contains(0x1000 + i * 0x40 + 1));
+    }
+    EXPECT_EQ(OPCODES.slot_count(), 256u);
+}
+
+TEST(PerfectHashMapTest, ForEachVisitsEveryEntryOnce) {
+    size_t count = 0;
+    uint32_t sum = 0;
+    OPCODES.for_each([&](uint32_t, uint32_t value) {
+        ++count;
+        sum += value;
+    });
+
+    EXPECT_EQ(count, 200u);
+    EXPECT_EQ(sum, 199u * 200u / 2);
+}
@@ -0,0 +1,186 @@
+#include "../src/Containers/PersistentHashMap.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using renn::containers::PersistentHashMap;
+
+namespace {
+
+// Few distinct hashes => long shared prefixes and collision nodes
+struct BadHash {
+    size_t operator()(int key) const noexcept { return static_cast<size_t>(key % 7); }
+};
+
+}  // namespace
+
+TEST(PersistentHashMapTest, SetFindErase) {
+    PersistentHashMap<std::string, int> empty;
+    auto map = empty.set("one", 1).set("two", 2).set("three", 3);
+
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(map.size(), 3u);
+    EXPECT_EQ(map.at("two"), 2);
+    EXPECT_EQ(map.find("four"), nullptr);
+    EXPECT_THROW((void)map.at("four"), std::out_of_range);
+
+    auto replaced = map.set("two", 22);
+    EXPECT_EQ(replaced.size(), 3u);
+    EXPECT_EQ(replaced.at("two"), 22);
+
+    auto erased = replaced.erase("one");
+    EXPECT_EQ(erased.size(), 2u);
+    EXPECT_FALSE(erased.contains("one"));
+    EXPECT_EQ(erased.erase("missing").size(), 2u);
+}
+
+TEST(PersistentHashMapTest, VersionsAreIndependent) {
+    PersistentHashMap<int, int> map;
+    std::vector<PersistentHashMap<int, int>> versions;
+
+    for (int i = 0; i < 2000; ++i) {
+        versions.push_back(map);
+        map = map.set(i, i * 10);
+    }
+
+    // Every snapshot still sees exactly the keys it had
+    for (int v = 0; v < 2000; v += 97) {
+        const auto& version = versions[v];
+        ASSERT_EQ(version.size(), static_cast<size_t>(v));
+        for (int i = 0; i < 2000; ++i) {
+            const int* value = version.find(i);
+            if (i < v) {
+                ASSERT_NE(value, nullptr);
+                EXPECT_EQ(*value, i * 10);
+            } else {
+                EXPECT_EQ(value, nullptr);
+            }
+        }
+    }
+
+    auto shrunk = map;
+    for (int i = 0; i < 2000; i += 2) {
+        shrunk = shrunk.erase(i);
+    }
+    EXPECT_EQ(shrunk.size(), 1000u);
+    EXPECT_EQ(map.size(), 2000u);
+    EXPECT_EQ(map.at(0), 0);
+}
+
+TEST(PersistentHashMapTest, MatchesUnorderedMap) {
+    auto check = [](auto map) {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> key_dist(0, 3000);
+        std::unordered_map<int, int> expected;
+        for (int op = 0; op < 20000; ++op) {
+            const int key = key_dist(rng);
+            if (rng() % 3 == 0) {
+                map = map.erase(key);
+                expected.erase(key);
+            } else {
+                map = map.set(key, op);
+                expected[key] = op;
+            }
+        }
+
+        ASSERT_EQ(map.size(), expected.size());
+        size_t visited = 0;
+        for (const auto& [key, value] : map) {
+            ASSERT_EQ(expected.at(key), value);
+            ++visited;
+        }
+        EXPECT_EQ(visited, expected.size());
+
+        // Erasing everything collapses back to an empty map
+        for (const auto& [key, value] : expected) {
+            map = map.erase(key);
+        }
+        EXPECT_TRUE(map.empty());
+        EXPECT_EQ(map.begin(), map.end());
+    };
+
+    check(PersistentHashMap<int, int>());
+    check(PersistentHashMap<int, int, BadHash>());
+}
+
+TEST(PersistentHashMapTest, TransientBatch) {
+    PersistentHashMap<int, std::string> base{{1, "a"}, {2, "b"}};
+
+    auto transient = base.transient();
+    for (int i = 0; i < 1000; ++i) {
+        transient.set(i, std::to_string(i));
+    }
+    EXPECT_TRUE(transient.erase(500));
+    EXPECT_FALSE(transient.erase(500));
+
+    auto first = transient.persistent();
+
+    // Keeps going after a snapshot without touching it
+    transient.set(0, "changed");
+    transient.erase(1);
+    auto second = std::move(transient).persistent();
+
+    EXPECT_EQ(base.size(), 2u);
+    EXPECT_EQ(base.at(1), "a");
+
+    EXPECT_EQ(first.size(), 999u);
+    EXPECT_EQ(first.at(0), "0");
+    EXPECT_EQ(first.at(1), "1");
+    EXPECT_FALSE(first.contains(500));
+
+    EXPECT_EQ(second.size(), 998u);
+    EXPECT_EQ(second.at(0), "changed");
+    EXPECT_FALSE(second.contains(1));
+}
+
+TEST(PersistentHashMapTest, TransientWithCollisions) {
+    auto transient = PersistentHashMap<int, int, BadHash>().transient();
+    for (int i = 0; i < 200; ++i) {
+        transient.set(i, i);
+    }
+    auto snapshot = transient.persistent();
+    for (int i = 0; i < 200; i += 3) {
+        transient.erase(i);
+    }
+    auto after = std::move(transient).persistent();
+
+    EXPECT_EQ(snapshot.size(), 200u);
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(snapshot.at(i), i);
+        EXPECT_EQ(after.contains(i), i % 3 != 0);
+    }
+}
+
+TEST(PersistentHashMapTest, ReadersOfOldVersionsDuringWrites) {
+    auto transient = PersistentHashMap<int, int>().transient();
+    for (int i = 0; i < 10000; ++i) {
+        transient.set(i, i);
+    }
+    const auto snapshot = std::move(transient).persistent();
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&snapshot] {
+            for (int round = 0; round < 5; ++round) {
+                auto local = snapshot;  // Shares the nodes the writer is copying from
+                for (int i = 0; i < 10000; ++i) {
+                    ASSERT_EQ(local.at(i), i);
+                }
+            }
+        });
+    }
+
+    auto map = snapshot;
+    for (int i = 0; i < 10000; ++i) {
+        map = map.set(i, -i).erase(i + 1);
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(snapshot.size(), 10000u);
+    EXPECT_EQ(map.at(9999), -9999);
+}
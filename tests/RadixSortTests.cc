@@ -0,0 +1,167 @@
+#include "../src/Algorithms/RadixSort.hpp"
+#include "../src/Containers/DynamicArray.hpp"
+#include "../src/Scheduling/ThreadPool/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <string>
+
+using renn::algorithms::radix_sort;
+using renn::containers::DynamicArray;
+
+namespace {
+
+template <typename T>
+DynamicArray<T> random_array(size_t n, uint64_t seed = 1) {
+    std::mt19937_64 rng(seed);
+    DynamicArray<T> array;
+    array.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        if constexpr (std::is_floating_point_v<T>) {
+            array.push_back(static_cast<T>(std::uniform_real_distribution<double>(-1e6, 1e6)(rng)));
+        } else {
+            array.push_back(static_cast<T>(rng()));
+        }
+    }
+    return array;
+}
+
+template <typename T>
+void expect_sorted_like_std(DynamicArray<T> array) {
+    auto expected = array;
+    std::sort(expected.begin(), expected.end());
+    radix_sort(array);
+    ASSERT_TRUE(std::equal(array.begin(), array.end(), expected.begin()));
+}
+
+struct Record {
+    uint32_t key;
+    size_t position;
+    std::string payload;
+};
+
+}  // namespace
+
+template <typename T>
+class RadixSortTest : public ::testing::Test {};
+
+using KeyTypes = ::testing::Types<uint8_t, int16_t, uint32_t, int32_t, uint64_t, int64_t, float, double>;
+TYPED_TEST_SUITE(RadixSortTest, KeyTypes);
+
+TYPED_TEST(RadixSortTest, MatchesStdSort) {
+    for (size_t n : {0, 1, 100, 255, 256, 5000, 100000}) {
+        expect_sorted_like_std(random_array<TypeParam>(n, n));
+    }
+}
+
+TYPED_TEST(RadixSortTest, Extremes) {
+    using Limits = std::numeric_limits<TypeParam>;
+    DynamicArray<TypeParam> array = random_array<TypeParam>(1000);
+    for (TypeParam x : {Limits::lowest(), Limits::max(), TypeParam(0), TypeParam(1), Limits::min()}) {
+        array.push_back(x);
+    }
+    if constexpr (std::is_floating_point_v<TypeParam>) {
+        array.push_back(-Limits::infinity());
+        array.push_back(Limits::infinity());
+        array.push_back(TypeParam(-1));
+    }
+    expect_sorted_like_std(array);
+}
+
+TEST(RadixSortFloatTest, SignedZerosAndInfinities) {
+    DynamicArray<double> array;
+    for (int i = 0; i < 300; ++i) {
+        array.push_back(0.0);
+        array.push_back(-0.0);
+        array.push_back(-std::numeric_limits<double>::infinity());
+        array.push_back(1e-300);
+        array.push_back(-1e-300);
+    }
+    radix_sort(array);
+
+    EXPECT_TRUE(std::is_sorted(array.begin(), array.end()));
+    EXPECT_EQ(array.front(), -std::numeric_limits<double>::infinity());
+    // Bit order: every -0.0 before every +0.0
+    auto zeros = std::find(array.begin(), array.end(), 0.0);
+    EXPECT_TRUE(std::signbit(*zeros));
+    EXPECT_FALSE(std::signbit(*(zeros + 599)));
+    EXPECT_TRUE(std::signbit(*(zeros + 299)));
+}
+
+TEST(RadixSortKeyTest, StableByField) {
+    std::mt19937 rng(3);
+    DynamicArray<Record> records;
+    for (size_t i = 0; i < 50000; ++i) {
+        records.push_back(Record{static_cast<uint32_t>(rng() % 100) << 20, i, std::to_string(i)});
+    }
+
+    radix_sort(records, &Record::key);
+
+    for (size_t i = 1; i < records.size(); ++i) {
+        ASSERT_LE(records[i - 1].key, records[i].key);
+        if (records[i - 1].key == records[i].key) {
+            ASSERT_LT(records[i - 1].position, records[i].position);  // Stable
+        }
+    }
+    for (const auto& record : records) {
+        ASSERT_EQ(record.payload, std::to_string(record.position));
+    }
+
+    // Lambda extractor, descending through a negated signed key
+    radix_sort(records.begin(), records.end(), [](const Record& r) { return -static_cast<int64_t>(r.position); });
+    for (size_t i = 0; i < records.size(); ++i) {
+        ASSERT_EQ(records[i].position, records.size() - 1 - i);
+    }
+}
+
+TEST(RadixSortKeyTest, ConstantDigitsAreSkipped) {
+    // Only the lowest digit varies => one pass, the result lands in the buffer and is moved back
+    DynamicArray<uint64_t> small_values;
+    for (uint64_t i = 0; i < 10000; ++i) {
+        small_values.push_back((i * 7919) % 2000 + (uint64_t{5} << 40));
+    }
+    expect_sorted_like_std(small_values);
+
+    // Every digit constant => untouched
+    DynamicArray<Record> same;
+    for (size_t i = 0; i < 1000; ++i) {
+        same.push_back(Record{42, i, ""});
+    }
+    radix_sort(same, &Record::key);
+    for (size_t i = 0; i < same.size(); ++i) {
+        ASSERT_EQ(same[i].position, i);
+    }
+}
+
+TEST(RadixSortParallelTest, MatchesSequential) {
+    renn::ThreadPool pool(4);
+    pool.start();
+
+    auto array = random_array<uint64_t>(1 << 20);
+    auto expected = array;
+    std::sort(expected.begin(), expected.end());
+    renn::par::radix_sort(pool, array);
+    EXPECT_TRUE(std::equal(array.begin(), array.end(), expected.begin()));
+
+    auto floats = random_array<float>(1 << 20);
+    auto sequential = floats;
+    radix_sort(sequential);
+    renn::par::radix_sort(pool, floats.begin(), floats.end());
+    EXPECT_TRUE(std::equal(floats.begin(), floats.end(), sequential.begin()));
+
+    // Stability across parts
+    DynamicArray<Record> records;
+    for (size_t i = 0; i < (1 << 18); ++i) {
+        records.push_back(Record{static_cast<uint32_t>((i * 2654435761u) % 1000), i, ""});
+    }
+    renn::par::radix_sort(pool, records, [](const Record& r) { return r.key; });
+    for (size_t i = 1; i < records.size(); ++i) {
+        ASSERT_TRUE(records[i - 1].key < records[i].key ||
+                    (records[i - 1].key == records[i].key && records[i - 1].position < records[i].position));
+    }
+
+    pool.stop();
+}
@@ -0,0 +1,230 @@
+#include "../src/Containers/SegmentedArray.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using renn::containers::SegmentedArray;
+
+static_assert(std::random_access_iterator<SegmentedArray<int>::iterator>);
+static_assert(std::random_access_iterator<SegmentedArray<int>::const_iterator>);
+
+namespace {
+
+size_t allocations = 0;
+size_t live_chunks = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        ++allocations;
+        ++live_chunks;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        --live_chunks;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(const CountingAllocator&) const = default;
+};
+
+}  // namespace
+
+TEST(SegmentedArrayTest, MatchesDeque) {
+    SegmentedArray<int, 8> array;
+    std::deque<int> reference;
+    std::mt19937 rng(5);
+
+    for (int step = 0; step < 20000; ++step) {
+        const int value = static_cast<int>(rng());
+        switch (rng() % 5) {
+            case 0:
+            case 1:
+                array.push_back(value);
+                reference.push_back(value);
+                break;
+            case 2:
+                array.push_front(value);
+                reference.push_front(value);
+                break;
+            case 3:
+                array.pop_back();
+                if (!reference.empty()) {
+                    reference.pop_back();
+                }
+                break;
+            case 4:
+                array.pop_front();
+                if (!reference.empty()) {
+                    reference.pop_front();
+                }
+                break;
+        }
+        ASSERT_EQ(array.size(), reference.size());
+    }
+
+    ASSERT_TRUE(std::equal(array.begin(), array.end(), reference.begin(), reference.end()));
+    for (size_t i = 0; i < array.size(); ++i) {
+        ASSERT_EQ(array[i], reference[i]);
+    }
+    EXPECT_THROW(array.at(array.size()), std::out_of_range);
+}
+
+TEST(SegmentedArrayTest, AddressesAreStable) {
+    SegmentedArray<std::string, 4> array;
+    std::vector<const std::string*> addresses;
+
+    for (int i = 0; i < 1000; ++i) {
+        addresses.push_back(&array.emplace_back(std::to_string(i)));
+        array.push_front("front");
+    }
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(*addresses[i], std::to_string(i));
+        ASSERT_EQ(&array[1000 + i], addresses[i]);
+    }
+
+    // A reference to an element as the argument: nothing moves, so it stays valid
+    array.push_back(array[1000]);
+    array.push_front(array.back());
+    EXPECT_EQ(array.front(), "0");
+    EXPECT_EQ(array.back(), "0");
+}
+
+TEST(SegmentedArrayTest, IteratorsWithAlgorithms) {
+    SegmentedArray<int, 16> array;
+    for (int i = 0; i < 1000; ++i) {
+        array.push_back((i * 7919) % 1000);
+    }
+
+    std::sort(array.begin(), array.end());
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(array[i], i);
+    }
+
+    const auto& const_array = array;
+    EXPECT_EQ(std::accumulate(const_array.begin(), const_array.end(), 0), 999 * 1000 / 2);
+    EXPECT_EQ(*std::lower_bound(array.cbegin(), array.cend(), 500), 500);
+    EXPECT_EQ(array.end() - array.begin(), 1000);
+    EXPECT_EQ(*array.rbegin(), 999);
+
+    SegmentedArray<int, 16>::const_iterator it = array.begin() + 3;
+    EXPECT_EQ(it[2], 5);
+    EXPECT_TRUE(it > array.cbegin());
+}
+
+TEST(SegmentedArrayTest, Segments) {
+    SegmentedArray<uint32_t, 64> array;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        array.push_back(i);
+    }
+    for (uint32_t i = 0; i < 10; ++i) {
+        array.push_front(0);
+    }
+
+    size_t runs = 0;
+    uint64_t sum = 0;
+    size_t count = 0;
+    array.for_each_segment([&](const uint32_t* data, size_t n) {
+        ++runs;
+        count += n;
+        sum += std::accumulate(data, data + n, uint64_t{0});
+    });
+    EXPECT_EQ(count, array.size());
+    EXPECT_EQ(sum, 999u * 1000u / 2);
+    EXPECT_LE(runs, 1010 / 64 + 2);
+}
+
+TEST(SegmentedArrayTest, ReserveClearShrink) {
+    SegmentedArray<int, 32> array;
+    array.reserve(100);
+    EXPECT_GE(array.capacity(), 100u);
+    EXPECT_LT(array.capacity(), 100u + 32u);
+
+    array.resize(200);
+    EXPECT_EQ(array[199], 0);
+    for (int i = 0; i < 300; ++i) {
+        array.push_front(i);
+    }
+    array.clear();
+    EXPECT_TRUE(array.empty());
+
+    array.push_front(1);
+    array.push_back(2);
+    array.shrink_to_fit();
+    EXPECT_EQ(array.size(), 2u);
+    EXPECT_EQ(array.front(), 1);
+    EXPECT_EQ(array.back(), 2);
+    EXPECT_LE(array.capacity(), 64u);
+}
+
+TEST(SegmentedArrayTest, QueueReusesChunks) {
+    allocations = 0;
+    live_chunks = 0;
+    {
+        SegmentedArray<uint64_t, 512, CountingAllocator<uint64_t>> queue;
+        for (uint64_t i = 0; i < 100; ++i) {
+            queue.push_back(i);
+        }
+
+        // push_back + pop_front: the emptied front chunk comes back at the back
+        size_t warmed_up = 0;
+        for (uint64_t i = 100; i < 1'000'000; ++i) {
+            queue.push_back(i);
+            queue.pop_front();
+            if (i == 10'000) {
+                warmed_up = allocations;
+            }
+        }
+        EXPECT_EQ(allocations, warmed_up);
+        EXPECT_LE(live_chunks, 2u);
+        EXPECT_EQ(queue.front(), 1'000'000u - 100);
+
+        // And the other way round: push_front + pop_back
+        for (uint64_t i = 0; i < 1'000'000; ++i) {
+            queue.push_front(i);
+            queue.pop_back();
+            if (i == 10'000) {
+                warmed_up = allocations;
+            }
+        }
+        EXPECT_EQ(allocations, warmed_up);
+        EXPECT_LE(live_chunks, 2u);
+        EXPECT_EQ(queue.size(), 100u);
+        EXPECT_EQ(queue.back(), 1'000'000u - 100);
+    }
+    EXPECT_EQ(live_chunks, 0u);
+}
+
+TEST(SegmentedArrayTest, CopyAndMove) {
+    SegmentedArray<std::unique_ptr<int>, 4> owners;
+    for (int i = 0; i < 50; ++i) {
+        owners.push_front(std::make_unique<int>(i));
+    }
+    auto moved = std::move(owners);
+    EXPECT_EQ(moved.size(), 50u);
+    EXPECT_EQ(*moved.back(), 0);
+    EXPECT_TRUE(owners.empty());
+
+    SegmentedArray<std::string, 4> strings = {"a", "b", "c", "d", "e"};
+    SegmentedArray<std::string, 4> copy(strings);
+    strings[0] = "changed";
+    EXPECT_EQ(copy[0], "a");
+    copy = strings;
+    EXPECT_EQ(copy[0], "changed");
+    EXPECT_EQ(copy.size(), 5u);
+}  // Every element and chunk freed exactly once (checked by the sanitizers)
@@ -0,0 +1,204 @@
+#include "../src/Containers/UnrolledList.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using renn::containers::UnrolledList;
+
+static_assert(std::bidirectional_iterator<UnrolledList<int>::iterator>);
+static_assert(std::bidirectional_iterator<UnrolledList<int>::const_iterator>);
+
+namespace {
+
+// Constructor throws for negative values
+struct Bomb {
+    int value;
+
+    explicit Bomb(int v) : value(v) {
+        if (v < 0) {
+            throw std::runtime_error("boom");
+        }
+    }
+};
+
+}  // namespace
+
+TEST(UnrolledListTest, MatchesStdList) {
+    UnrolledList<int, 8> list;
+    std::list<int> reference;
+    std::mt19937 rng(11);
+
+    for (int step = 0; step < 30000; ++step) {
+        const int value = static_cast<int>(rng() % 1000);
+        const size_t index = reference.empty() ? 0 : rng() % (reference.size() + 1);
+        auto it = list.begin();
+        auto ref = reference.begin();
+        std::advance(it, index);
+        std::advance(ref, index);
+
+        switch (rng() % 6) {
+            case 0:
+                list.push_back(value);
+                reference.push_back(value);
+                break;
+            case 1:
+                list.push_front(value);
+                reference.push_front(value);
+                break;
+            case 2:
+            case 3: {
+                auto inserted = list.insert(it, value);
+                reference.insert(ref, value);
+                ASSERT_EQ(std::distance(list.begin(), inserted), static_cast<ptrdiff_t>(index));
+                ASSERT_EQ(*inserted, value);
+                break;
+            }
+            case 4:
+            case 5:
+                if (ref != reference.end()) {
+                    auto next = list.erase(it);
+                    auto ref_next = reference.erase(ref);
+                    ASSERT_EQ(std::distance(list.begin(), next), static_cast<ptrdiff_t>(index));
+                    ASSERT_EQ(next == list.end(), ref_next == reference.end());
+                }
+                break;
+        }
+        ASSERT_EQ(list.size(), reference.size());
+    }
+
+    ASSERT_TRUE(std::equal(list.begin(), list.end(), reference.begin(), reference.end()));
+    ASSERT_TRUE(std::equal(list.rbegin(), list.rend(), reference.rbegin(), reference.rend()));
+
+    // No node below a quarter full except where merging would overfill
+    EXPECT_LE(list.node_count(), list.size() / 2 + 2);
+}
+
+TEST(UnrolledListTest, QueueKeepsNodesFull) {
+    UnrolledList<int, 16> queue;
+    for (int i = 0; i < 1600; ++i) {
+        queue.push_back(i);
+    }
+    EXPECT_EQ(queue.node_count(), 100u);
+
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(queue.front(), i);
+        queue.pop_front();
+    }
+    EXPECT_EQ(queue.node_count(), 38u);  // Emptied nodes freed, the partial one kept
+
+    UnrolledList<int, 16> stack;
+    for (int i = 0; i < 160; ++i) {
+        stack.push_front(i);
+    }
+    EXPECT_EQ(stack.node_count(), 10u);
+    EXPECT_EQ(stack.front(), 159);
+    EXPECT_EQ(stack.back(), 0);
+    while (!stack.empty()) {
+        stack.pop_back();
+    }
+    EXPECT_EQ(stack.node_count(), 0u);
+    EXPECT_THROW(stack.front(), std::out_of_range);
+}
+
+TEST(UnrolledListTest, SplitAndMerge) {
+    UnrolledList<int, 8> list;
+    for (int i = 0; i < 8; ++i) {
+        list.push_back(i * 2);
+    }
+    ASSERT_EQ(list.node_count(), 1u);
+
+    auto it = std::next(list.begin(), 3);
+    it = list.insert(it, 5);  // Full => split
+    EXPECT_EQ(list.node_count(), 2u);
+    EXPECT_EQ(*it, 5);
+    EXPECT_EQ(*std::prev(it), 4);
+    EXPECT_EQ(*std::next(it), 6);
+
+    // Erasing down to a quarter merges the two halves back
+    while (list.size() > 4) {
+        list.erase(std::next(list.begin()));
+    }
+    EXPECT_EQ(list.node_count(), 1u);
+    EXPECT_EQ(list, (UnrolledList<int, 8>{0, 10, 12, 14}));
+}
+
+TEST(UnrolledListTest, ArgumentAliasesAnElement) {
+    UnrolledList<std::string, 4> list = {"a", "b", "c", "d"};
+    list.insert(std::next(list.begin()), list.back());  // Full node => split before the copy would be too late
+    list.push_front(list.back());
+    list.insert(std::next(list.begin(), 3), list.front());
+    EXPECT_EQ(list, (UnrolledList<std::string, 4>{"d", "a", "d", "d", "b", "c", "d"}));
+}
+
+TEST(UnrolledListTest, ThrowingConstructorLeavesListUnchanged) {
+    UnrolledList<Bomb, 4> list;
+    auto expect_values = [&list](std::vector<int> expected) {
+        std::vector<int> values;
+        for (const Bomb& bomb : list) {
+            values.push_back(bomb.value);
+        }
+        EXPECT_EQ(values, expected);
+        EXPECT_EQ(static_cast<size_t>(std::distance(list.begin(), list.end())), list.size());
+    };
+
+    // Into a new node at the back of an empty list
+    EXPECT_THROW(list.emplace_back(-1), std::runtime_error);
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.begin(), list.end());
+    EXPECT_EQ(list.node_count(), 0u);
+
+    for (int i = 0; i < 4; ++i) {
+        list.emplace_back(i);
+    }
+    // New node after a full last node, before a full first node, split of a full node, inside a node
+    EXPECT_THROW(list.emplace_back(-1), std::runtime_error);
+    EXPECT_THROW(list.emplace_front(-1), std::runtime_error);
+    EXPECT_THROW(list.emplace(std::next(list.begin(), 2), -1), std::runtime_error);
+    EXPECT_EQ(list.node_count(), 1u);
+    expect_values({0, 1, 2, 3});
+
+    list.pop_back();
+    EXPECT_THROW(list.emplace(std::next(list.begin()), -1), std::runtime_error);
+    expect_values({0, 1, 2});
+
+    list.emplace_back(3);
+    list.emplace_back(4);
+    expect_values({0, 1, 2, 3, 4});
+}
+
+TEST(UnrolledListTest, CopyAndMove) {
+    UnrolledList<std::unique_ptr<int>, 4> owners;
+    for (int i = 0; i < 50; ++i) {
+        owners.emplace_back(std::make_unique<int>(i));
+    }
+    auto moved = std::move(owners);
+    EXPECT_EQ(moved.size(), 50u);
+    EXPECT_EQ(*moved.back(), 49);
+    EXPECT_TRUE(owners.empty());
+    owners = std::move(moved);
+    EXPECT_EQ(*owners.front(), 0);
+    owners.push_back(std::make_unique<int>(50));  // The moved-to list's end nodes point at its own sentinel
+    EXPECT_EQ(owners.size(), 51u);
+
+    UnrolledList<std::string, 4> strings = {"a", "b", "c", "d", "e"};
+    UnrolledList<std::string, 4> copy(strings);
+    strings.front() = "changed";
+    EXPECT_EQ(copy.front(), "a");
+    copy = strings;
+    EXPECT_EQ(copy, strings);
+
+    const auto& const_copy = copy;
+    std::string joined;
+    for (const auto& s : const_copy) {
+        joined += s;
+    }
+    EXPECT_EQ(joined, "changedbcde");
+    EXPECT_EQ(std::accumulate(const_copy.rbegin(), const_copy.rend(), std::string()), "edcbchanged");
+}  // Every element and node freed exactly once (checked by the sanitizers)